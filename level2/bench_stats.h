@@ -0,0 +1,62 @@
+// MIT License. Copyright (c) 2025 Kshitij Jain
+// See LICENSE file in the root of this repository.
+
+#ifndef _BENCH_STATS_H
+#define _BENCH_STATS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+// Summary statistics of repeated timings.
+//
+// Search times are skewed and have outliers from page faults and
+// interrupts, so the median and its confidence interval are the
+// numbers to compare runs by. The median interval is distribution
+// free, from order statistics. The mean interval assumes roughly
+// normal sample means and uses Student's t. Both are 95% intervals,
+// and both collapse to the samples' range when there are too few
+// samples to say more.
+
+struct bench_stats {
+    size_t count;
+    double mean;
+    double stddev;                  // Sample standard deviation.
+    double min;
+    double max;
+    double median;
+    double p90;                     // Nearest-rank percentiles.
+    double p99;
+    double mean_ci_low;
+    double mean_ci_high;
+    double median_ci_low;
+    double median_ci_high;
+};
+
+// Computes the statistics of a set of samples.
+// \param samples : Array of count samples, sorted in place.
+// \param count   : Number of samples.
+// \param stats   : Pointer to statistics (provided by caller).
+// Returns TRUE on success, FALSE if there are no samples.
+//
+bool bench_stats_compute(long * samples, size_t count, struct bench_stats * stats);
+
+// Writes statistics as a JSON object, without a trailing newline.
+// \param file  : File to write to.
+// \param stats : Pointer to statistics.
+//
+void bench_stats_write_json(FILE * file, const struct bench_stats * stats);
+
+// Writes the CSV column names of bench_stats_write_csv(), without a
+// trailing newline.
+// \param file : File to write to.
+//
+void bench_stats_write_csv_header(FILE * file);
+
+// Writes statistics as CSV fields, without a trailing newline.
+// \param file  : File to write to.
+// \param stats : Pointer to statistics.
+//
+void bench_stats_write_csv(FILE * file, const struct bench_stats * stats);
+
+#endif
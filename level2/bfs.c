@@ -0,0 +1,1188 @@
+// MIT License. Copyright (c) 2025 Kshitij Jain
+// See LICENSE file in the root of this repository.
+
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bfs.h"
+
+// Number of entries drained from a queue per queue_pop_n() call.
+//
+#define BFS_POP_BATCH 256
+
+// How far down a popped batch row starts and row data are prefetched.
+// Rows are a few bytes at random positions, so without prefetching
+// every expansion waits for up to two cache misses.
+//
+#define BFS_PREFETCH_INDEX_DISTANCE 16
+#define BFS_PREFETCH_ROW_DISTANCE   8
+
+// Direction-optimizing switch points, from Beamer et al. Go bottom-up
+// once the frontier's out-edges exceed 1/BFS_ALPHA of the unvisited
+// vertices' in-edges, and back top-down once the frontier holds fewer
+// than 1/BFS_BETA of all vertices.
+//
+#define BFS_ALPHA 14
+#define BFS_BETA  24
+
+#define BFS_BITS_PER_WORD 64
+
+// Frontier vertices a parallel worker claims at a time, and entries it
+// buffers before appending them to the shared next level.
+//
+#define BFS_PARALLEL_CHUNK 256
+#define BFS_LOCAL_FRONTIER 1024
+
+// Bytes of rows an external search asks the kernel to fetch ahead of
+// the rows it reads. A new window is announced once less than half of
+// the last one is left.
+//
+#define BFS_EXTERNAL_ADVISE_BYTES (32 * 1024 * 1024)
+
+// Vertices an external search expands through the mapping between
+// checks of its advice window.
+//
+#define BFS_EXTERNAL_MMAP_CHUNK 256
+
+// One thread of a parallel search. Worker 0 is the thread that calls
+// bfs_search_run(), the others are started by bfs_search_create().
+//
+struct bfs_worker {
+    struct bfs_search * search;
+    pthread_t thread;
+    size_t local_size;
+    unsigned int local[BFS_LOCAL_FRONTIER];
+};
+
+static void * _bfs_worker_main(void * arg);
+
+static const char * bfs_mode_names[] = {
+    [BFS_FORWARD]              = "forward",
+    [BFS_BIDIRECTIONAL]        = "bidirectional",
+    [BFS_DIRECTION_OPTIMIZING] = "direction-optimizing",
+    [BFS_PARALLEL]             = "parallel",
+    [BFS_SHORTEST_PATH]        = "shortest-path",
+    [BFS_COMPRESSED]           = "compressed",
+    [BFS_EXTERNAL]             = "external",
+    [BFS_EXTERNAL_MMAP]        = "external-mmap",
+    [BFS_DYNAMIC]              = "dynamic",
+};
+
+#define BFS_NUM_MODES (sizeof(bfs_mode_names) / sizeof(bfs_mode_names[0]))
+
+// Internal utility function that starts the worker threads of
+// parallel searches. New workers block on pool_lock until the barrier
+// is sized for the threads that actually came up.
+// \param search      : Pointer to search state.
+// \param num_threads : Requested number of threads, the caller included.
+// Returns TRUE on success, FALSE otherwise.
+//
+static bool _bfs_start_workers(struct bfs_search * search, size_t num_threads) {
+    search->level      = (unsigned int*)malloc((search->graph->num_vertices + 1) * sizeof(unsigned int));
+    search->next_level = (unsigned int*)malloc((search->graph->num_vertices + 1) * sizeof(unsigned int));
+    search->workers    = (struct bfs_worker*)calloc(num_threads, sizeof(struct bfs_worker));
+    if (search->level == NULL || search->next_level == NULL || search->workers == NULL) {
+        return false;
+    }
+
+    pthread_mutex_lock(&search->pool_lock);
+    search->workers[0].search = search;
+    search->num_threads = 1;
+    for (size_t t = 1; t < num_threads; t++) {
+        struct bfs_worker * worker = &search->workers[search->num_threads];
+        worker->search = search;
+        if (pthread_create(&worker->thread, NULL, _bfs_worker_main, worker) != 0) {
+            break;
+        }
+        ++search->num_threads;
+    }
+    bool status = pthread_barrier_init(&search->barrier, NULL, (unsigned)search->num_threads) == 0;
+    if (status && pthread_barrier_init(&search->level_barrier, NULL,
+                                       (unsigned)search->num_threads) != 0) {
+        pthread_barrier_destroy(&search->barrier);
+        status = false;
+    }
+    search->active_threads = status ? search->num_threads : 0;
+    search->pool_started   = status;
+    pthread_mutex_unlock(&search->pool_lock);
+
+    return status;
+}
+
+// Creates the state for searching a graph.
+// \param graph       : Graph to search.
+// \param reverse     : Transpose of graph, or NULL if no search strategy
+//                      that needs it will be run.
+// \param compressed  : Compressed rows of graph, or NULL if no search
+//                      strategy that needs them will be run.
+// \param external    : Rows of graph on disk, or NULL if no search
+//                      strategy that needs them will be run.
+// \param dynamic     : Updatable copy of graph, or NULL if no search
+//                      strategy that needs it will be run.
+// \param num_threads : Threads for BFS_PARALLEL searches, the caller
+//                      included. 0 leaves BFS_PARALLEL unavailable.
+// Returns a new search on success, NULL on failure.
+//
+struct bfs_search * bfs_search_create(struct graph * graph, struct graph * reverse,
+                                      struct compressed_graph * compressed,
+                                      struct external_graph * external,
+                                      struct dynamic_graph * dynamic,
+                                      size_t num_threads) {
+    if (graph == NULL) {
+        return NULL;
+    }
+    if (reverse != NULL && (reverse->num_vertices != graph->num_vertices
+                            || reverse->num_edges != graph->num_edges)) {
+        return NULL;
+    }
+    if (compressed != NULL && (compressed->num_vertices != graph->num_vertices
+                               || compressed->num_edges != graph->num_edges)) {
+        return NULL;
+    }
+    if (external != NULL && (external->num_vertices != graph->num_vertices
+                             || external->num_edges != graph->num_edges)) {
+        return NULL;
+    }
+    if (dynamic != NULL && dynamic->num_vertices != graph->num_vertices) {
+        return NULL;
+    }
+
+    struct bfs_search * search = (struct bfs_search*)calloc(1, sizeof(struct bfs_search));
+    if (search == NULL) {
+        return NULL;
+    }
+    search->graph      = graph;
+    search->reverse    = reverse;
+    search->compressed = compressed;
+    search->external   = external;
+    search->dynamic    = dynamic;
+    pthread_mutex_init(&search->pool_lock, NULL);
+
+    // Searches that mark vertices when they discover them push each
+    // at most once, so the vertex count bounds their queue. Only the
+    // forward search needs room for every edge, which
+    // bfs_search_reserve() makes on its first run. Queue memory comes
+    // from the registered allocator, which need not give it back, so
+    // searches that never run forward must not reserve it.
+    //
+    search->queue   = queue_create();
+    search->visited = visited_set_create(graph->num_vertices);
+    search->parent  = (unsigned int*)malloc((graph->num_vertices + 1) * sizeof(unsigned int));
+    search->path    = (unsigned int*)malloc((graph->num_vertices + 2) * sizeof(unsigned int));
+    bool status = search->queue != NULL && search->visited != NULL
+        && search->parent != NULL && search->path != NULL
+        && queue_reserve(search->queue, graph->num_vertices + 1);
+
+    if (status && compressed != NULL) {
+        search->row_buffer = (unsigned int*)malloc((compressed->max_degree + COMPRESSED_GRAPH_DECODE_SLACK)
+                                                   * sizeof(unsigned int));
+        status = search->row_buffer != NULL;
+    }
+
+    if (status && reverse != NULL) {
+        search->reverse_queue   = queue_create();
+        search->reverse_visited = visited_set_create(graph->num_vertices);
+        search->frontier_words = (graph->num_vertices + BFS_BITS_PER_WORD - 1) / BFS_BITS_PER_WORD;
+        search->frontier       = (uint64_t*)calloc(search->frontier_words + 1, sizeof(uint64_t));
+        search->next_frontier  = (uint64_t*)calloc(search->frontier_words + 1, sizeof(uint64_t));
+        status = search->reverse_queue != NULL && search->reverse_visited != NULL
+            && search->frontier != NULL && search->next_frontier != NULL
+            && queue_reserve(search->reverse_queue, graph->num_vertices + 1);
+    }
+
+    if (status && num_threads > 0) {
+        status = _bfs_start_workers(search, num_threads);
+    }
+
+    if (status && external != NULL) {
+        search->read_buffer_entries = external_graph_buffer_entries(external);
+        search->read_buffer = (unsigned int*)malloc(search->read_buffer_entries * sizeof(unsigned int));
+        if (search->level == NULL) {
+            search->level      = (unsigned int*)malloc((graph->num_vertices + 1) * sizeof(unsigned int));
+            search->next_level = (unsigned int*)malloc((graph->num_vertices + 1) * sizeof(unsigned int));
+        }
+        status = search->read_buffer != NULL && search->level != NULL && search->next_level != NULL;
+    }
+
+    if (!status) {
+        bfs_search_delete(search);
+        return NULL;
+    }
+    return search;
+}
+
+// Deletes a search and frees all memory associated with it. The
+// graphs are owned by the caller and are not freed.
+// \param search : Pointer to search to delete.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool bfs_search_delete(struct bfs_search * search) {
+    if (search == NULL) {
+        return false;
+    }
+
+    // If the barrier could not be set up, workers see pool_started
+    // unset and exit. Otherwise they all reach the barrier and exit
+    // once it releases them.
+    //
+    if (search->workers != NULL) {
+        pthread_mutex_lock(&search->pool_lock);
+        search->shutdown = true;
+        pthread_mutex_unlock(&search->pool_lock);
+        if (search->pool_started) {
+            pthread_barrier_wait(&search->barrier);
+        }
+        for (size_t t = 1; t < search->num_threads; t++) {
+            pthread_join(search->workers[t].thread, NULL);
+        }
+        if (search->pool_started) {
+            pthread_barrier_destroy(&search->barrier);
+        }
+        if (search->active_threads > 0) {
+            pthread_barrier_destroy(&search->level_barrier);
+        }
+    }
+    pthread_mutex_destroy(&search->pool_lock);
+    free(search->workers);
+    free(search->level);
+    free(search->next_level);
+
+    if (search->queue != NULL) {
+        queue_delete(search->queue);
+    }
+    if (search->reverse_queue != NULL) {
+        queue_delete(search->reverse_queue);
+    }
+    visited_set_delete(search->visited);
+    visited_set_delete(search->reverse_visited);
+    free(search->parent);
+    free(search->path);
+    free(search->row_buffer);
+    free(search->read_buffer);
+    free(search->frontier);
+    free(search->next_frontier);
+    free(search);
+    return true;
+}
+
+// Internal utility function for the forward search. Vertices are
+// marked when they are dequeued and every visited row is pushed
+// whole, so the inner loop is one queue_push_n() per vertex.
+// \param search : Pointer to search state.
+// \param source : Vertex to start from.
+// \param target : Vertex to look for.
+// Returns TRUE if a path exists, FALSE otherwise.
+//
+static bool _bfs_forward(struct bfs_search * search, unsigned int source, unsigned int target) {
+    struct graph * graph         = search->graph;
+    struct queue * queue         = search->queue;
+    struct visited_set * visited = search->visited;
+
+    bool found_path = false;
+    unsigned int batch[BFS_POP_BATCH];
+    size_t batch_size  = 1;
+    size_t batch_index = 0;
+    batch[0] = source;
+
+    while (!found_path) {
+        // Refill the local batch from the queue once it is drained.
+        //
+        if (batch_index == batch_size) {
+            batch_size  = queue_pop_n(queue, batch, BFS_POP_BATCH);
+            batch_index = 0;
+            search->nodes_visited += batch_size;
+            if (batch_size == 0) {
+                break;
+            }
+        }
+
+        unsigned int next_node = batch[batch_index++];
+        if (!visited_set_insert(visited, next_node)) {
+            continue;
+        }
+
+        // Check if we found the node.
+        //
+        graph_offset_t begin = graph->offsets[next_node];
+        graph_offset_t end   = graph->offsets[next_node + 1];
+        for (graph_offset_t edge = begin; edge < end; edge++) {
+            if (target == graph->neighbors[edge]) {
+                found_path = true;
+            }
+        }
+        search->edges_examined += end - begin;
+
+        // Push the whole row onto the queue at once.
+        //
+        if (!queue_push_n(queue, graph->neighbors + begin, end - begin)) {
+            printf("Error pushing into queue.\n");
+            return false;
+        }
+    }
+
+    return found_path;
+}
+
+// Internal utility function that writes the path to target, whose
+// BFS parent is last, into search->path.
+// \param search : Pointer to search state.
+// \param source : Vertex the search started from.
+// \param last   : Visited vertex with an edge to target.
+// \param target : Vertex that was looked for.
+//
+static void _bfs_record_path(struct bfs_search * search, unsigned int source,
+                             unsigned int last, unsigned int target) {
+    // Walk the parents back to the source, then reverse. target is
+    // appended rather than given a parent, so a source that is its
+    // own target keeps the source as the root of the walk.
+    //
+    size_t length = 0;
+    for (unsigned int vertex = last; vertex != source; vertex = search->parent[vertex]) {
+        search->path[length++] = vertex;
+    }
+    search->path[length++] = source;
+    for (size_t i = 0; i < length / 2; i++) {
+        unsigned int swap               = search->path[i];
+        search->path[i]                 = search->path[length - 1 - i];
+        search->path[length - 1 - i]    = swap;
+    }
+    search->path[length++] = target;
+    search->path_length    = length;
+}
+
+// Where a shortest path search reads rows from. The search is
+// inlined per source, so the choice costs nothing per row.
+//
+enum _bfs_rows {
+    _BFS_ROWS_GRAPH,            // search->graph.
+    _BFS_ROWS_COMPRESSED,       // search->compressed, decoded per row.
+    _BFS_ROWS_DYNAMIC,          // search->dynamic.
+};
+
+// Internal utility function that prefetches the rows of vertices
+// further down a popped batch. Row starts are fetched a stage earlier
+// than row data, since the data address depends on them.
+// \param search     : Pointer to search state.
+// \param batch      : Vertices popped from the queue.
+// \param index      : Index of the vertex about to be expanded.
+// \param batch_size : Number of vertices in batch.
+// \param rows       : Where rows are read from.
+//
+static inline void _bfs_prefetch_rows(struct bfs_search * search, const unsigned int * batch,
+                                      size_t index, size_t batch_size, enum _bfs_rows rows)
+{
+    if (index + BFS_PREFETCH_INDEX_DISTANCE < batch_size) {
+        unsigned int vertex = batch[index + BFS_PREFETCH_INDEX_DISTANCE];
+        if (rows == _BFS_ROWS_COMPRESSED) {
+            __builtin_prefetch(&search->compressed->row_starts[vertex]);
+        } else if (rows == _BFS_ROWS_DYNAMIC) {
+            __builtin_prefetch(&search->dynamic->rows[vertex]);
+        } else {
+            __builtin_prefetch(&search->graph->offsets[vertex]);
+        }
+    }
+    if (index + BFS_PREFETCH_ROW_DISTANCE < batch_size) {
+        unsigned int vertex = batch[index + BFS_PREFETCH_ROW_DISTANCE];
+        if (rows == _BFS_ROWS_COMPRESSED) {
+            __builtin_prefetch(search->compressed->data + search->compressed->row_starts[vertex]);
+        } else if (rows == _BFS_ROWS_DYNAMIC) {
+            __builtin_prefetch(&search->dynamic->slots[search->dynamic->rows[vertex].start]);
+        } else {
+            __builtin_prefetch(&search->graph->neighbors[search->graph->offsets[vertex]]);
+        }
+    }
+}
+
+// Internal utility function for the shortest path search. Vertices
+// are marked when they are discovered, so each one enters the queue at
+// most once, and the search stops at the first edge into the target.
+// FIFO order makes the recorded path a shortest one.
+// \param search     : Pointer to search state.
+// \param source     : Vertex to start from.
+// \param target     : Vertex to look for.
+// \param rows       : Where rows are read from.
+// Returns TRUE if a path exists, FALSE otherwise.
+//
+static inline bool _bfs_shortest_path(struct bfs_search * search, unsigned int source,
+                                      unsigned int target, enum _bfs_rows rows)
+{
+    struct graph * graph         = search->graph;
+    struct queue * queue         = search->queue;
+    struct visited_set * visited = search->visited;
+
+    unsigned int batch[BFS_POP_BATCH];
+    size_t batch_size  = 1;
+    size_t batch_index = 0;
+    batch[0] = source;
+    visited_set_insert(visited, source);
+
+    for (;;) {
+        if (batch_index == batch_size) {
+            batch_size  = queue_pop_n(queue, batch, BFS_POP_BATCH);
+            batch_index = 0;
+            if (batch_size == 0) {
+                return false;
+            }
+        }
+
+        _bfs_prefetch_rows(search, batch, batch_index, batch_size, rows);
+        unsigned int vertex = batch[batch_index++];
+        ++search->nodes_visited;
+
+        const unsigned int * row;
+        size_t degree;
+        if (rows == _BFS_ROWS_COMPRESSED) {
+            degree = compressed_graph_decode_row(search->compressed, vertex, search->row_buffer);
+            row    = search->row_buffer;
+        } else if (rows == _BFS_ROWS_DYNAMIC) {
+            degree = search->dynamic->rows[vertex].degree;
+            row    = &search->dynamic->slots[search->dynamic->rows[vertex].start];
+        } else {
+            degree = (size_t)(graph->offsets[vertex + 1] - graph->offsets[vertex]);
+            row    = &graph->neighbors[graph->offsets[vertex]];
+        }
+
+        for (size_t k = 0; k < degree; k++) {
+            unsigned int neighbor = row[k];
+            if (neighbor == target) {
+                search->edges_examined += k + 1;
+                _bfs_record_path(search, source, vertex, target);
+                return true;
+            }
+            if (visited_set_insert(visited, neighbor)) {
+                search->parent[neighbor] = vertex;
+                if (!queue_push(queue, neighbor)) {
+                    printf("Error pushing into queue.\n");
+                    return false;
+                }
+            }
+        }
+        search->edges_examined += degree;
+    }
+}
+
+// Internal utility function that expands one BFS level of one side
+// of a bidirectional search.
+// \param search  : Pointer to search state, for statistics.
+// \param graph   : Graph to expand along, the transpose for the
+//                  backward side.
+// \param queue   : This side's queue. Holds exactly the current level.
+// \param visited : This side's visited set.
+// \param other   : The other side's visited set.
+// \param met     : Pointer to whether the sides met (provided by caller).
+// Returns TRUE on success, FALSE if a push failed.
+//
+static bool _bfs_expand_level(struct bfs_search * search, struct graph * graph,
+                              struct queue * queue, struct visited_set * visited,
+                              struct visited_set * other, bool * met) {
+    unsigned int batch[BFS_POP_BATCH];
+    size_t level_size = queue_size(queue);
+
+    while (level_size > 0) {
+        size_t batch_size = queue_pop_n(queue, batch,
+                                        level_size < BFS_POP_BATCH ? level_size : BFS_POP_BATCH);
+        level_size -= batch_size;
+        search->nodes_visited += batch_size;
+
+        for (size_t b = 0; b < batch_size; b++) {
+            graph_offset_t begin = graph->offsets[batch[b]];
+            graph_offset_t end   = graph->offsets[batch[b] + 1];
+            search->edges_examined += end - begin;
+
+            for (graph_offset_t edge = begin; edge < end; edge++) {
+                unsigned int neighbor = graph->neighbors[edge];
+
+                // The edge joins a vertex reached from this side to
+                // one reached from the other, which completes a path.
+                //
+                if (visited_set_contains(other, neighbor)) {
+                    *met = true;
+                    return true;
+                }
+                if (visited_set_insert(visited, neighbor) && !queue_push(queue, neighbor)) {
+                    printf("Error pushing into queue.\n");
+                    return false;
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+// Internal utility function for the bidirectional search. It grows a
+// forward BFS from the source over the graph and a backward BFS from
+// the target over the transpose, one whole level at a time, always
+// on the side with the smaller frontier. On small-world graphs the
+// two meet after a few levels, long before either side has covered
+// much of the graph.
+// \param search : Pointer to search state.
+// \param source : Vertex to start from.
+// \param target : Vertex to look for.
+// Returns TRUE if a path exists, FALSE otherwise.
+//
+static bool _bfs_bidirectional(struct bfs_search * search, unsigned int source, unsigned int target) {
+    struct queue * forward  = search->queue;
+    struct queue * backward = search->reverse_queue;
+
+    visited_set_clear(search->reverse_visited);
+    queue_clear(backward);
+
+    visited_set_insert(search->visited, source);
+    visited_set_insert(search->reverse_visited, target);
+    if (!queue_push(forward, source) || !queue_push(backward, target)) {
+        return false;
+    }
+
+    // Sides only meet across an edge, so source == target is found
+    // only through a cycle, as in the forward search.
+    //
+    bool met = false;
+    while (!met && queue_size(forward) > 0 && queue_size(backward) > 0) {
+        bool status;
+        if (queue_size(forward) <= queue_size(backward)) {
+            status = _bfs_expand_level(search, search->graph, forward,
+                                       search->visited, search->reverse_visited, &met);
+        } else {
+            status = _bfs_expand_level(search, search->reverse, backward,
+                                       search->reverse_visited, search->visited, &met);
+        }
+        if (!status) {
+            return false;
+        }
+    }
+
+    return met;
+}
+
+static inline bool _bfs_bitmap_test(const uint64_t * bitmap, unsigned int vertex) {
+    return (bitmap[vertex / BFS_BITS_PER_WORD] >> (vertex % BFS_BITS_PER_WORD)) & 1;
+}
+
+static inline void _bfs_bitmap_set(uint64_t * bitmap, unsigned int vertex) {
+    bitmap[vertex / BFS_BITS_PER_WORD] |= (uint64_t)1 << (vertex % BFS_BITS_PER_WORD);
+}
+
+static inline size_t _bfs_degree(const struct graph * graph, unsigned int vertex) {
+    return graph->offsets[vertex + 1] - graph->offsets[vertex];
+}
+
+// Running totals that drive the direction-optimizing switch.
+//
+struct bfs_frontier_stats {
+    size_t vertices;            // Vertices in the frontier.
+    size_t frontier_edges;      // Out-edges of the frontier.
+    size_t unvisited_edges;     // In-edges of unvisited vertices.
+};
+
+// Internal utility function that records a newly discovered vertex.
+//
+static inline void _bfs_discover(struct bfs_search * search, struct bfs_frontier_stats * next,
+                                 unsigned int vertex) {
+    ++next->vertices;
+    next->frontier_edges  += _bfs_degree(search->graph, vertex);
+    next->unvisited_edges -= _bfs_degree(search->reverse, vertex);
+}
+
+// Internal utility function that expands one level top-down: every
+// frontier vertex pushes its unvisited out-neighbors.
+// \param search : Pointer to search state. The queue holds the frontier.
+// \param target : Vertex to look for.
+// \param next   : Pointer to next frontier statistics (provided by caller).
+// \param found  : Pointer to whether target was reached (provided by caller).
+// Returns TRUE on success, FALSE if a push failed.
+//
+static bool _bfs_top_down_level(struct bfs_search * search, unsigned int target,
+                                struct bfs_frontier_stats * next, bool * found) {
+    struct graph * graph = search->graph;
+    unsigned int batch[BFS_POP_BATCH];
+    size_t level_size = queue_size(search->queue);
+
+    while (level_size > 0) {
+        size_t batch_size = queue_pop_n(search->queue, batch,
+                                        level_size < BFS_POP_BATCH ? level_size : BFS_POP_BATCH);
+        level_size -= batch_size;
+        search->nodes_visited += batch_size;
+
+        for (size_t b = 0; b < batch_size; b++) {
+            graph_offset_t begin = graph->offsets[batch[b]];
+            graph_offset_t end   = graph->offsets[batch[b] + 1];
+            search->edges_examined += end - begin;
+
+            for (graph_offset_t edge = begin; edge < end; edge++) {
+                unsigned int neighbor = graph->neighbors[edge];
+                if (neighbor == target) {
+                    *found = true;
+                    return true;
+                }
+                if (visited_set_insert(search->visited, neighbor)) {
+                    _bfs_discover(search, next, neighbor);
+                    if (!queue_push(search->queue, neighbor)) {
+                        printf("Error pushing into queue.\n");
+                        return false;
+                    }
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+// Internal utility function that expands one level bottom-up: every
+// unvisited vertex looks for an in-neighbor in the frontier bitmap and
+// stops at the first one. When most edges lead back into visited
+// vertices this reads far fewer edges than top-down expansion.
+// \param search : Pointer to search state. search->frontier holds the
+//                 frontier, search->next_frontier receives the next one.
+// \param target : Vertex to look for.
+// \param next   : Pointer to next frontier statistics (provided by caller).
+// \param found  : Pointer to whether target was reached (provided by caller).
+//
+static void _bfs_bottom_up_level(struct bfs_search * search, unsigned int target,
+                                 struct bfs_frontier_stats * next, bool * found) {
+    struct graph * reverse = search->reverse;
+    memset(search->next_frontier, 0, search->frontier_words * sizeof(uint64_t));
+
+    // The target is only visited already when it is the source, which
+    // is found through a cycle, so test its in-edges separately.
+    //
+    if (visited_set_contains(search->visited, target)) {
+        for (graph_offset_t edge = reverse->offsets[target]; edge < reverse->offsets[target + 1]; edge++) {
+            if (_bfs_bitmap_test(search->frontier, reverse->neighbors[edge])) {
+                *found = true;
+                return;
+            }
+        }
+    }
+
+    for (unsigned int vertex = 0; vertex < reverse->num_vertices; vertex++) {
+        if (visited_set_contains(search->visited, vertex)) {
+            continue;
+        }
+        ++search->nodes_visited;
+
+        graph_offset_t begin = reverse->offsets[vertex];
+        graph_offset_t end   = reverse->offsets[vertex + 1];
+        for (graph_offset_t edge = begin; edge < end; edge++) {
+            if (_bfs_bitmap_test(search->frontier, reverse->neighbors[edge])) {
+                search->edges_examined += edge - begin + 1;
+                if (vertex == target) {
+                    *found = true;
+                    return;
+                }
+                visited_set_insert(search->visited, vertex);
+                _bfs_bitmap_set(search->next_frontier, vertex);
+                _bfs_discover(search, next, vertex);
+                goto next_vertex;
+            }
+        }
+        search->edges_examined += end - begin;
+next_vertex:
+        ;
+    }
+
+    uint64_t * swap       = search->frontier;
+    search->frontier      = search->next_frontier;
+    search->next_frontier = swap;
+}
+
+// Internal utility function for the direction-optimizing search. It
+// is a level-synchronous BFS from the source that picks, per level,
+// between top-down expansion from a queue and bottom-up scanning
+// against a bitmap, whichever should touch fewer edges.
+// \param search : Pointer to search state.
+// \param source : Vertex to start from.
+// \param target : Vertex to look for.
+// Returns TRUE if a path exists, FALSE otherwise.
+//
+static bool _bfs_direction_optimizing(struct bfs_search * search, unsigned int source,
+                                      unsigned int target) {
+    struct graph * graph = search->graph;
+    struct bfs_frontier_stats frontier;
+    frontier.vertices        = 0;
+    frontier.frontier_edges  = 0;
+    frontier.unvisited_edges = graph->num_edges;
+
+    visited_set_insert(search->visited, source);
+    _bfs_discover(search, &frontier, source);
+    if (!queue_push(search->queue, source)) {
+        return false;
+    }
+
+    bool found     = false;
+    bool bottom_up = false;
+    while (!found && frontier.vertices > 0) {
+        struct bfs_frontier_stats next = frontier;
+        next.vertices       = 0;
+        next.frontier_edges = 0;
+
+        if (bottom_up) {
+            _bfs_bottom_up_level(search, target, &next, &found);
+        } else if (!_bfs_top_down_level(search, target, &next, &found)) {
+            return false;
+        }
+        frontier = next;
+        if (found) {
+            break;
+        }
+
+        // Move the next frontier between the queue and the bitmap
+        // when the direction changes.
+        //
+        if (!bottom_up && frontier.frontier_edges > frontier.unvisited_edges / BFS_ALPHA) {
+            bottom_up = true;
+            memset(search->frontier, 0, search->frontier_words * sizeof(uint64_t));
+            unsigned int batch[BFS_POP_BATCH];
+            size_t batch_size;
+            while ((batch_size = queue_pop_n(search->queue, batch, BFS_POP_BATCH)) > 0) {
+                for (size_t b = 0; b < batch_size; b++) {
+                    _bfs_bitmap_set(search->frontier, batch[b]);
+                }
+            }
+        } else if (bottom_up && frontier.vertices < graph->num_vertices / BFS_BETA) {
+            bottom_up = false;
+            for (size_t word = 0; word < search->frontier_words; word++) {
+                uint64_t bits = search->frontier[word];
+                while (bits != 0) {
+                    unsigned int vertex = (unsigned int)(word * BFS_BITS_PER_WORD
+                                                         + (size_t)__builtin_ctzll(bits));
+                    if (!queue_push(search->queue, vertex)) {
+                        return false;
+                    }
+                    bits &= bits - 1;
+                }
+            }
+        }
+    }
+
+    return found;
+}
+
+// Internal utility function that appends a worker's buffered
+// discoveries to the shared next level.
+//
+static void _bfs_flush_local(struct bfs_worker * worker) {
+    struct bfs_search * search = worker->search;
+    size_t position = __atomic_fetch_add(&search->next_level_size, worker->local_size,
+                                         __ATOMIC_RELAXED);
+    memcpy(search->next_level + position, worker->local, worker->local_size * sizeof(unsigned int));
+    worker->local_size = 0;
+}
+
+// Internal utility function that expands a worker's share of the
+// current level. Workers claim chunks of the level from a shared
+// cursor, so a few huge rows do not leave the other threads idle.
+//
+static void _bfs_parallel_level(struct bfs_worker * worker) {
+    struct bfs_search * search = worker->search;
+    struct graph * graph       = search->graph;
+    unsigned int target        = search->target;
+    size_t nodes_visited       = 0;
+    size_t edges_examined      = 0;
+
+    while (!__atomic_load_n(&search->found, __ATOMIC_RELAXED)) {
+        size_t begin = __atomic_fetch_add(&search->level_cursor, BFS_PARALLEL_CHUNK,
+                                          __ATOMIC_RELAXED);
+        if (begin >= search->level_size) {
+            break;
+        }
+        size_t end = begin + BFS_PARALLEL_CHUNK < search->level_size
+            ? begin + BFS_PARALLEL_CHUNK : search->level_size;
+        nodes_visited += end - begin;
+
+        for (size_t i = begin; i < end; i++) {
+            graph_offset_t row_begin = graph->offsets[search->level[i]];
+            graph_offset_t row_end   = graph->offsets[search->level[i] + 1];
+            edges_examined += row_end - row_begin;
+
+            for (graph_offset_t edge = row_begin; edge < row_end; edge++) {
+                unsigned int neighbor = graph->neighbors[edge];
+                if (neighbor == target) {
+                    __atomic_store_n(&search->found, true, __ATOMIC_RELAXED);
+                    goto out;
+                }
+                if (visited_set_insert_atomic(search->visited, neighbor)) {
+                    worker->local[worker->local_size++] = neighbor;
+                    if (worker->local_size == BFS_LOCAL_FRONTIER) {
+                        _bfs_flush_local(worker);
+                    }
+                }
+            }
+        }
+    }
+
+out:
+    _bfs_flush_local(worker);
+    __atomic_fetch_add(&search->nodes_visited, nodes_visited, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&search->edges_examined, edges_examined, __ATOMIC_RELAXED);
+}
+
+// Internal utility function that every worker runs for one search.
+// Levels are separated by two barriers. Between them one thread swaps
+// the level buffers and decides whether the search is over, so all
+// workers leave the loop together.
+//
+static void _bfs_parallel_search(struct bfs_worker * worker) {
+    struct bfs_search * search = worker->search;
+
+    for (;;) {
+        _bfs_parallel_level(worker);
+
+        if (pthread_barrier_wait(&search->level_barrier) == PTHREAD_BARRIER_SERIAL_THREAD) {
+            unsigned int * swap     = search->level;
+            search->level           = search->next_level;
+            search->next_level      = swap;
+            search->level_size      = search->next_level_size;
+            search->next_level_size = 0;
+            search->level_cursor    = 0;
+            search->level_done      = search->found || search->level_size == 0;
+        }
+        pthread_barrier_wait(&search->level_barrier);
+
+        if (search->level_done) {
+            break;
+        }
+    }
+}
+
+// Internal utility function that parks a worker thread between
+// searches.
+//
+static void * _bfs_worker_main(void * arg) {
+    struct bfs_worker * worker = (struct bfs_worker*)arg;
+    struct bfs_search * search = worker->search;
+
+    pthread_mutex_lock(&search->pool_lock);
+    bool started = search->pool_started;
+    pthread_mutex_unlock(&search->pool_lock);
+    if (!started) {
+        return NULL;
+    }
+
+    for (;;) {
+        pthread_barrier_wait(&search->barrier);
+        if (search->shutdown) {
+            return NULL;
+        }
+        if ((size_t)(worker - search->workers) < search->active_threads) {
+            _bfs_parallel_search(worker);
+        }
+        __atomic_fetch_sub(&search->workers_left, 1, __ATOMIC_RELEASE);
+    }
+}
+
+// Internal utility function for the parallel search, a
+// level-synchronous BFS from the source spread over the worker pool.
+// Vertices are claimed with an atomic exchange on their visited stamp,
+// so each one enters the next level exactly once.
+// \param search : Pointer to search state.
+// \param source : Vertex to start from.
+// \param target : Vertex to look for.
+// Returns TRUE if a path exists, FALSE otherwise.
+//
+static bool _bfs_parallel(struct bfs_search * search, unsigned int source, unsigned int target) {
+    visited_set_insert(search->visited, source);
+    search->level[0]        = source;
+    search->level_size      = 1;
+    search->level_cursor    = 0;
+    search->next_level_size = 0;
+    search->target          = target;
+    search->found           = false;
+
+    // level_done is left alone: workers of the last search may still
+    // be reading it, and the first level sets it before anyone reads
+    // it again.
+    //
+
+    // Release the parked workers and join in as worker 0.
+    //
+    __atomic_fetch_add(&search->workers_left, search->num_threads - 1, __ATOMIC_RELAXED);
+    pthread_barrier_wait(&search->barrier);
+    _bfs_parallel_search(&search->workers[0]);
+    return search->found;
+}
+
+// Internal comparison function for qsort() of a level.
+//
+static int _bfs_compare_vertices(const void * a, const void * b) {
+    unsigned int x = *(const unsigned int*)a;
+    unsigned int y = *(const unsigned int*)b;
+    return (x > y) - (x < y);
+}
+
+// Internal utility function for the external searches, a
+// level-synchronous BFS over rows that stay on disk. Each level is
+// sorted, so its rows are fetched in file order, nearby rows with a
+// single read, while the kernel is told which rows come next. Vertices
+// are marked on discovery and the path is recorded as in the shortest
+// path search.
+// \param search : Pointer to search state.
+// \param source : Vertex to start from.
+// \param target : Vertex to look for.
+// \param mapped : Whether to read rows through the mapping instead of
+//                 with pread().
+// Returns TRUE if a path exists, FALSE otherwise.
+//
+static bool _bfs_external(struct bfs_search * search, unsigned int source,
+                          unsigned int target, bool mapped)
+{
+    struct external_graph * external = search->external;
+    const graph_offset_t * offsets   = external->offsets;
+    struct visited_set * visited     = search->visited;
+
+    visited_set_insert(visited, source);
+    search->level[0]   = source;
+    size_t level_size  = 1;
+
+    while (level_size > 0) {
+        unsigned int * level = search->level;
+        size_t next_size     = 0;
+        qsort(level, level_size, sizeof(unsigned int), _bfs_compare_vertices);
+
+        size_t advised = 0;
+        for (size_t i = 0; i < level_size; ) {
+            if (advised < level_size
+                && (advised == i || (size_t)(offsets[level[advised]] - offsets[level[i]])
+                                    * sizeof(unsigned int) < BFS_EXTERNAL_ADVISE_BYTES / 2)) {
+                advised += external_graph_advise(external, level + advised, level_size - advised,
+                                                 BFS_EXTERNAL_ADVISE_BYTES, mapped);
+            }
+
+            const unsigned int * rows;
+            graph_offset_t base;
+            size_t covered;
+            if (mapped) {
+                rows    = external->neighbors;
+                base    = 0;
+                covered = advised - i < BFS_EXTERNAL_MMAP_CHUNK ? advised - i : BFS_EXTERNAL_MMAP_CHUNK;
+            } else {
+                rows    = search->read_buffer;
+                covered = external_graph_read_rows(external, level + i, level_size - i,
+                                                   search->read_buffer, search->read_buffer_entries,
+                                                   &base);
+                if (covered == 0) {
+                    return false;
+                }
+            }
+
+            for (size_t k = i; k < i + covered; k++) {
+                unsigned int vertex = level[k];
+                const unsigned int * row = rows + (offsets[vertex] - base);
+                size_t degree = (size_t)(offsets[vertex + 1] - offsets[vertex]);
+                ++search->nodes_visited;
+
+                // Rows come straight from the file, so a corrupt one
+                // must not index the visited set out of bounds.
+                //
+                for (size_t e = 0; e < degree; e++) {
+                    unsigned int neighbor = row[e];
+                    if (neighbor >= external->num_vertices) {
+                        printf("Row of vertex %u in the external graph holds vertex %u, "
+                               "past the last vertex.\n", vertex, neighbor);
+                        return false;
+                    }
+                    if (neighbor == target) {
+                        search->edges_examined += e + 1;
+                        _bfs_record_path(search, source, vertex, target);
+                        return true;
+                    }
+                    if (visited_set_insert(visited, neighbor)) {
+                        search->parent[neighbor]        = vertex;
+                        search->next_level[next_size++] = neighbor;
+                    }
+                }
+                search->edges_examined += degree;
+            }
+            i += covered;
+        }
+
+        search->level      = search->next_level;
+        search->next_level = level;
+        level_size         = next_size;
+    }
+
+    return false;
+}
+
+// Sets how many of the threads started by bfs_search_create() take
+// part in BFS_PARALLEL searches. The others stay parked. Must not be
+// called while a search runs.
+// \param search      : Pointer to search state.
+// \param num_threads : Threads to search with, the caller included,
+//                      from 1 to search->num_threads.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool bfs_search_set_threads(struct bfs_search * search, size_t num_threads) {
+    if (search == NULL || !search->pool_started || search->active_threads == 0
+        || num_threads == 0 || num_threads > search->num_threads) {
+        return false;
+    }
+    if (num_threads == search->active_threads) {
+        return true;
+    }
+
+    // Workers of the last search may still be on their way out of
+    // level_barrier, or about to read active_threads, so wait until
+    // every worker is back on its way to barrier.
+    //
+    while (__atomic_load_n(&search->workers_left, __ATOMIC_ACQUIRE) != 0) {
+        sched_yield();
+    }
+    pthread_barrier_destroy(&search->level_barrier);
+    if (pthread_barrier_init(&search->level_barrier, NULL, (unsigned)num_threads) != 0) {
+        search->active_threads = 0;
+        return false;
+    }
+    search->active_threads = num_threads;
+    return true;
+}
+
+// Sizes the buffers of a search for a strategy ahead of its first
+// run, which otherwise does so itself. Buffers come from the allocator
+// registered with the queue, which need not be thread safe, so
+// searches that will run concurrently must be sized up front.
+// \param search : Pointer to search state.
+// \param mode   : Search strategy.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool bfs_search_reserve(struct bfs_search * search, enum bfs_mode mode) {
+    if (search == NULL) {
+        return false;
+    }
+
+    // Marking on visit pushes every row it visits, so the edge count
+    // bounds the queue of a forward search.
+    //
+    return mode != BFS_FORWARD || queue_reserve(search->queue, search->graph->num_edges + 1);
+}
+
+// Searches for a path from source to target.
+// \param search : Pointer to search state.
+// \param mode   : Search strategy.
+// \param source : Vertex to start from.
+// \param target : Vertex to look for.
+// Returns TRUE if a path exists, FALSE if not or on error.
+//
+bool bfs_search_run(struct bfs_search * search, enum bfs_mode mode,
+                    unsigned int source, unsigned int target) {
+    if (search == NULL) {
+        return false;
+    }
+
+    search->nodes_visited  = 0;
+    search->edges_examined = 0;
+    if (source >= search->graph->num_vertices) {
+        return false;
+    }
+
+    search->path_length    = 0;
+    queue_clear(search->queue);
+    visited_set_clear(search->visited);
+
+    switch (mode) {
+    case BFS_FORWARD:
+        if (!bfs_search_reserve(search, mode)) {
+            return false;
+        }
+        return _bfs_forward(search, source, target);
+    case BFS_BIDIRECTIONAL:
+        if (search->reverse == NULL || target >= search->graph->num_vertices) {
+            return false;
+        }
+        return _bfs_bidirectional(search, source, target);
+    case BFS_DIRECTION_OPTIMIZING:
+        if (search->reverse == NULL || target >= search->graph->num_vertices) {
+            return false;
+        }
+        return _bfs_direction_optimizing(search, source, target);
+    case BFS_SHORTEST_PATH:
+        return _bfs_shortest_path(search, source, target, _BFS_ROWS_GRAPH);
+    case BFS_COMPRESSED:
+        if (search->compressed == NULL) {
+            return false;
+        }
+        return _bfs_shortest_path(search, source, target, _BFS_ROWS_COMPRESSED);
+    case BFS_DYNAMIC:
+        if (search->dynamic == NULL) {
+            return false;
+        }
+        return _bfs_shortest_path(search, source, target, _BFS_ROWS_DYNAMIC);
+    case BFS_EXTERNAL:
+    case BFS_EXTERNAL_MMAP:
+        if (search->external == NULL) {
+            return false;
+        }
+        return _bfs_external(search, source, target, mode == BFS_EXTERNAL_MMAP);
+    case BFS_PARALLEL:
+        if (search->workers == NULL || search->active_threads == 0) {
+            return false;
+        }
+        return _bfs_parallel(search, source, target);
+    }
+
+    return false;
+}
+
+// Returns the name of a search strategy, NULL if it is unknown.
+// \param mode : Search strategy.
+//
+const char * bfs_mode_name(enum bfs_mode mode) {
+    if ((size_t)mode >= BFS_NUM_MODES) {
+        return NULL;
+    }
+    return bfs_mode_names[mode];
+}
+
+// Checks whether a search strategy walks in-edges.
+// \param mode : Search strategy.
+// Returns TRUE if bfs_search_create() needs the transpose for it.
+//
+bool bfs_mode_needs_reverse(enum bfs_mode mode) {
+    return mode == BFS_BIDIRECTIONAL || mode == BFS_DIRECTION_OPTIMIZING;
+}
+
+// Checks whether a search strategy reads compressed rows.
+// \param mode : Search strategy.
+// Returns TRUE if bfs_search_create() needs the compressed rows for it.
+//
+bool bfs_mode_needs_compressed(enum bfs_mode mode) {
+    return mode == BFS_COMPRESSED;
+}
+
+// Checks whether a search strategy reads rows from disk.
+// \param mode : Search strategy.
+// Returns TRUE if bfs_search_create() needs the external graph for it.
+//
+bool bfs_mode_needs_external(enum bfs_mode mode) {
+    return mode == BFS_EXTERNAL || mode == BFS_EXTERNAL_MMAP;
+}
+
+// Checks whether a search strategy reads an updatable graph.
+// \param mode : Search strategy.
+// Returns TRUE if bfs_search_create() needs the dynamic graph for it.
+//
+bool bfs_mode_needs_dynamic(enum bfs_mode mode) {
+    return mode == BFS_DYNAMIC;
+}
+
+// Looks up a search strategy by name.
+// \param name : Name as returned by bfs_mode_name().
+// \param mode : Pointer to search strategy (provided by caller).
+// Returns TRUE on success, FALSE if the name is unknown.
+//
+bool bfs_mode_parse(const char * name, enum bfs_mode * mode) {
+    if (name == NULL || mode == NULL) {
+        return false;
+    }
+
+    for (size_t m = 0; m < BFS_NUM_MODES; m++) {
+        if (strcmp(name, bfs_mode_names[m]) == 0) {
+            *mode = (enum bfs_mode)m;
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,203 @@
+// MIT License. Copyright (c) 2025 Kshitij Jain
+// See LICENSE file in the root of this repository.
+
+#ifndef _BFS_H
+#define _BFS_H
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "compressed_graph.h"
+#include "dynamic_graph.h"
+#include "external_graph.h"
+#include "graph.h"
+#include "queue.h"
+#include "visited.h"
+
+// Point-to-point reachability searches over a CSR graph.
+//
+// Every search answers whether there is a path of at least one edge
+// from a source vertex to a target vertex. A struct bfs_search holds
+// the queues and visited sets a search needs, so that repeated
+// searches allocate nothing.
+
+// Search strategies.
+//
+enum bfs_mode {
+    BFS_FORWARD,                // Expand from the source only.
+    BFS_BIDIRECTIONAL,          // Expand from both ends, needs the transpose.
+    BFS_DIRECTION_OPTIMIZING,   // Top-down or bottom-up per level, needs
+                                // the transpose.
+    BFS_PARALLEL,               // Level-synchronous on a pool of threads.
+    BFS_SHORTEST_PATH,          // Forward, marks on discovery and records
+                                // the path.
+    BFS_COMPRESSED,             // BFS_SHORTEST_PATH over compressed rows.
+    BFS_EXTERNAL,               // Level-synchronous over rows on disk,
+                                // read with sorted batched pread()s.
+    BFS_EXTERNAL_MMAP,          // BFS_EXTERNAL through a hinted mapping.
+    BFS_DYNAMIC,                // BFS_SHORTEST_PATH over an updatable
+                                // copy of the graph.
+};
+
+struct bfs_worker;
+
+struct bfs_search {
+    struct graph * graph;
+    struct graph * reverse;             // Transpose of graph, or NULL.
+    struct compressed_graph * compressed;   // Rows of graph, or NULL.
+    unsigned int * row_buffer;          // Decoded row, NULL without rows.
+    struct external_graph * external;   // Rows of graph on disk, or NULL.
+    unsigned int * read_buffer;         // NULL without rows on disk.
+    size_t read_buffer_entries;
+    struct dynamic_graph * dynamic;     // Updatable copy of graph, or NULL.
+
+    struct queue * queue;
+    struct queue * reverse_queue;       // NULL without a transpose.
+    struct visited_set * visited;
+    struct visited_set * reverse_visited;
+
+    // Frontier bitmaps of bottom-up levels, NULL without a transpose.
+    //
+    uint64_t * frontier;
+    uint64_t * next_frontier;
+    size_t frontier_words;
+
+    // Worker pool of BFS_PARALLEL searches, NULL if it has none. The
+    // current and next levels are plain vertex arrays shared by all
+    // workers, the fields below are only written between barriers or
+    // atomically. External searches use the level arrays as well.
+    // Every worker passes barrier to start a search, but only the
+    // first active_threads take part in it and meet at level_barrier.
+    // workers_left counts the started workers that have not yet gone
+    // back to barrier since the last search.
+    //
+    struct bfs_worker * workers;
+    size_t num_threads;
+    size_t active_threads;
+    size_t workers_left;
+    pthread_mutex_t pool_lock;
+    pthread_barrier_t barrier;
+    pthread_barrier_t level_barrier;
+    bool pool_started;
+    bool shutdown;
+
+    unsigned int * level;
+    unsigned int * next_level;
+    size_t level_size;
+    size_t next_level_size;
+    size_t level_cursor;
+    unsigned int target;
+    bool found;
+    bool level_done;
+
+    // BFS tree and result of BFS_SHORTEST_PATH searches. parent[v] is
+    // only meaningful for vertices visited by the last search. path
+    // holds path_length vertices from source to target, path_length
+    // is 0 if no path was found.
+    //
+    unsigned int * parent;
+    unsigned int * path;
+    size_t path_length;
+
+    // Statistics of the last search.
+    //
+    size_t nodes_visited;               // Queue entries processed.
+    size_t edges_examined;              // Adjacency entries read.
+};
+
+// Creates the state for searching a graph.
+// \param graph       : Graph to search.
+// \param reverse     : Transpose of graph, or NULL if no search strategy
+//                      that needs it will be run.
+// \param compressed  : Compressed rows of graph, or NULL if no search
+//                      strategy that needs them will be run.
+// \param external    : Rows of graph on disk, or NULL if no search
+//                      strategy that needs them will be run.
+// \param dynamic     : Updatable copy of graph, or NULL if no search
+//                      strategy that needs it will be run.
+// \param num_threads : Threads for BFS_PARALLEL searches, the caller
+//                      included. 0 leaves BFS_PARALLEL unavailable.
+// Returns a new search on success, NULL on failure.
+//
+struct bfs_search * bfs_search_create(struct graph * graph, struct graph * reverse,
+                                      struct compressed_graph * compressed,
+                                      struct external_graph * external,
+                                      struct dynamic_graph * dynamic,
+                                      size_t num_threads);
+
+// Deletes a search and frees all memory associated with it. The
+// graphs are owned by the caller and are not freed.
+// \param search : Pointer to search to delete.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool bfs_search_delete(struct bfs_search * search);
+
+// Sets how many of the threads started by bfs_search_create() take
+// part in BFS_PARALLEL searches. The others stay parked. Must not be
+// called while a search runs.
+// \param search      : Pointer to search state.
+// \param num_threads : Threads to search with, the caller included,
+//                      from 1 to search->num_threads.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool bfs_search_set_threads(struct bfs_search * search, size_t num_threads);
+
+// Sizes the buffers of a search for a strategy ahead of its first
+// run, which otherwise does so itself. Buffers come from the allocator
+// registered with the queue, which need not be thread safe, so
+// searches that will run concurrently must be sized up front.
+// \param search : Pointer to search state.
+// \param mode   : Search strategy.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool bfs_search_reserve(struct bfs_search * search, enum bfs_mode mode);
+
+// Searches for a path from source to target.
+// \param search : Pointer to search state.
+// \param mode   : Search strategy.
+// \param source : Vertex to start from.
+// \param target : Vertex to look for.
+// Returns TRUE if a path exists, FALSE if not or on error.
+//
+bool bfs_search_run(struct bfs_search * search, enum bfs_mode mode,
+                    unsigned int source, unsigned int target);
+
+// Returns the name of a search strategy, NULL if it is unknown.
+// \param mode : Search strategy.
+//
+const char * bfs_mode_name(enum bfs_mode mode);
+
+// Checks whether a search strategy walks in-edges.
+// \param mode : Search strategy.
+// Returns TRUE if bfs_search_create() needs the transpose for it.
+//
+bool bfs_mode_needs_reverse(enum bfs_mode mode);
+
+// Checks whether a search strategy reads compressed rows.
+// \param mode : Search strategy.
+// Returns TRUE if bfs_search_create() needs the compressed rows for it.
+//
+bool bfs_mode_needs_compressed(enum bfs_mode mode);
+
+// Checks whether a search strategy reads rows from disk.
+// \param mode : Search strategy.
+// Returns TRUE if bfs_search_create() needs the external graph for it.
+//
+bool bfs_mode_needs_external(enum bfs_mode mode);
+
+// Checks whether a search strategy reads an updatable graph.
+// \param mode : Search strategy.
+// Returns TRUE if bfs_search_create() needs the dynamic graph for it.
+//
+bool bfs_mode_needs_dynamic(enum bfs_mode mode);
+
+// Looks up a search strategy by name.
+// \param name : Name as returned by bfs_mode_name().
+// \param mode : Pointer to search strategy (provided by caller).
+// Returns TRUE on success, FALSE if the name is unknown.
+//
+bool bfs_mode_parse(const char * name, enum bfs_mode * mode);
+
+#endif
@@ -112,6 +112,16 @@ void* bump_ptr_allocator_malloc(struct bump_ptr_allocator* allocator, size_t siz
 
   allocator->slab_ptr += 1;
   allocator->last_alloc_size *= 2;
+
+  // Large requests (e.g. a queue growing its ring buffer) may not fit
+  // in the next doubling, so keep doubling until they do.
+  //
+  if (allocator->last_alloc_size == 0) {
+      allocator->last_alloc_size = DEFAULT_ALLOC_SIZE_BYTES;
+  }
+  while (allocator->last_alloc_size < size + 8) {
+      allocator->last_alloc_size *= 2;
+  }
   allocator->total_mem_allocated += allocator->last_alloc_size;
 
   if (!slab_init(&allocator->slabs[allocator->slab_ptr], allocator->last_alloc_size)) {
@@ -121,7 +131,7 @@ void* bump_ptr_allocator_malloc(struct bump_ptr_allocator* allocator, size_t siz
 
   alloc = slab_malloc(&allocator->slabs[allocator->slab_ptr], size);
   if (alloc != NULL) {
-      return (void*)allocator->slabs[allocator->slab_ptr].curr;
+      return (void*)alloc;
   }
 
   return NULL;
@@ -0,0 +1,373 @@
+// MIT License. Copyright (c) 2025 Kshitij Jain
+// See LICENSE file in the root of this repository.
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <tmmintrin.h>
+#define COMPRESSED_GRAPH_SSSE3
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define COMPRESSED_GRAPH_NEON
+#endif
+
+#include "compressed_graph.h"
+
+// For every control byte, the shuffle that moves its four gaps into
+// four 32-bit lanes and the number of gap bytes it covers. Shuffle
+// indices with the top bit set produce zero bytes.
+//
+static uint8_t compressed_graph_shuffles[256][16];
+static uint8_t compressed_graph_lengths[256];
+static pthread_once_t compressed_graph_tables_once = PTHREAD_ONCE_INIT;
+
+// Row decoder for this CPU, picked once with the tables.
+//
+static compressed_graph_decoder_t compressed_graph_decoder = NULL;
+
+// Internal utility function that returns the number of bytes a gap
+// takes, 1 to 4.
+//
+static inline size_t _compressed_graph_gap_bytes(uint32_t gap) {
+    return gap < (1U << 8) ? 1 : gap < (1U << 16) ? 2 : gap < (1U << 24) ? 3 : 4;
+}
+
+// Internal utility functions that map the signed first gap of a row
+// to an unsigned one and back, small magnitudes to small values.
+//
+static inline uint32_t _compressed_graph_zigzag(int32_t value) {
+    return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+static inline uint32_t _compressed_graph_unzigzag(uint32_t value) {
+    return (value >> 1) ^ (0U - (value & 1));
+}
+
+// Internal comparison function for qsort() of neighbors.
+//
+static int _compressed_graph_compare(const void * a, const void * b) {
+    unsigned int x = *(const unsigned int*)a;
+    unsigned int y = *(const unsigned int*)b;
+    return (x > y) - (x < y);
+}
+
+// Internal utility function that encodes one sorted row.
+// \param vertex    : Vertex the row belongs to.
+// \param neighbors : Array of degree sorted neighbors.
+// \param degree    : Number of neighbors.
+// \param out       : Buffer with room for the encoded row (provided by caller).
+// Returns the number of bytes written.
+//
+static size_t _compressed_graph_encode_row(unsigned int vertex, const unsigned int * neighbors,
+                                           size_t degree, uint8_t * out)
+{
+    uint8_t * p = out;
+    size_t remaining = degree;
+    while (remaining >= 0x80) {
+        *p++ = (uint8_t)(remaining | 0x80);
+        remaining >>= 7;
+    }
+    *p++ = (uint8_t)remaining;
+
+    uint8_t * control = p;
+    uint8_t * gaps    = p + (degree + 3) / 4;
+    memset(control, 0, (degree + 3) / 4);
+
+    unsigned int previous = vertex;
+    for (size_t i = 0; i < degree; i++) {
+        uint32_t gap  = i == 0 ? _compressed_graph_zigzag((int32_t)(neighbors[i] - vertex))
+                               : neighbors[i] - previous;
+        size_t length = _compressed_graph_gap_bytes(gap);
+        previous      = neighbors[i];
+
+        control[i / 4] |= (uint8_t)((length - 1) << (2 * (i % 4)));
+        for (size_t byte = 0; byte < length; byte++) {
+            *gaps++ = (uint8_t)(gap >> (8 * byte));
+        }
+    }
+
+    return (size_t)(gaps - out);
+}
+
+// Internal utility function that reads the degree at the start of a
+// row. Most rows have fewer than 128 neighbors and take one byte.
+// \param row    : First byte of the row.
+// \param degree : Pointer to degree (provided by caller).
+// Returns the first byte after the degree.
+//
+static inline const uint8_t * _compressed_graph_read_degree(const uint8_t * row, size_t * degree) {
+    size_t value = *row++;
+    if (value >= 0x80) {
+        value &= 0x7f;
+        for (size_t shift = 7; ; shift += 7) {
+            uint8_t byte = *row++;
+            value |= (size_t)(byte & 0x7f) << shift;
+            if (byte < 0x80) {
+                break;
+            }
+        }
+    }
+    *degree = value;
+    return row;
+}
+
+#if defined(COMPRESSED_GRAPH_SSSE3)
+// Internal utility function that decodes a row four gaps at a time
+// with pshufb and turns them into neighbors with an in-register prefix
+// sum seeded with the row's vertex.
+//
+__attribute__((target("ssse3")))
+static size_t _compressed_graph_decode_ssse3(const uint8_t * row, unsigned int vertex,
+                                             unsigned int * neighbors)
+{
+    size_t degree;
+    const uint8_t * control = _compressed_graph_read_degree(row, &degree);
+    const uint8_t * gaps    = control + (degree + 3) / 4;
+    if (degree == 0) {
+        return 0;
+    }
+
+    uint8_t byte   = *control++;
+    __m128i values = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)gaps),
+                                      _mm_loadu_si128((const __m128i*)compressed_graph_shuffles[byte]));
+    gaps += compressed_graph_lengths[byte];
+
+    // Only the first gap is signed.
+    //
+    uint32_t first   = (uint32_t)_mm_cvtsi128_si32(values);
+    values           = _mm_add_epi32(values, _mm_cvtsi32_si128((int)(_compressed_graph_unzigzag(first) - first)));
+    __m128i previous = _mm_set1_epi32((int)vertex);
+    for (size_t i = 0; ; ) {
+        values   = _mm_add_epi32(values, _mm_slli_si128(values, 4));
+        values   = _mm_add_epi32(values, _mm_slli_si128(values, 8));
+        values   = _mm_add_epi32(values, previous);
+        _mm_storeu_si128((__m128i*)&neighbors[i], values);
+        previous = _mm_shuffle_epi32(values, 0xff);
+
+        i += 4;
+        if (i >= degree) {
+            return degree;
+        }
+        byte   = *control++;
+        values = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)gaps),
+                                  _mm_loadu_si128((const __m128i*)compressed_graph_shuffles[byte]));
+        gaps  += compressed_graph_lengths[byte];
+    }
+}
+#endif
+
+#if defined(COMPRESSED_GRAPH_NEON)
+// Internal utility function that decodes a row four gaps at a time
+// with a table lookup and turns them into neighbors with an
+// in-register prefix sum seeded with the row's vertex.
+//
+static size_t _compressed_graph_decode_neon(const uint8_t * row, unsigned int vertex,
+                                            unsigned int * neighbors)
+{
+    size_t degree;
+    const uint8_t * control = _compressed_graph_read_degree(row, &degree);
+    const uint8_t * gaps    = control + (degree + 3) / 4;
+    if (degree == 0) {
+        return 0;
+    }
+
+    uint8_t byte      = *control++;
+    uint32x4_t values = vreinterpretq_u32_u8(vqtbl1q_u8(vld1q_u8(gaps),
+                                                        vld1q_u8(compressed_graph_shuffles[byte])));
+    gaps += compressed_graph_lengths[byte];
+
+    // Only the first gap is signed.
+    //
+    values              = vsetq_lane_u32(_compressed_graph_unzigzag(vgetq_lane_u32(values, 0)), values, 0);
+    uint32x4_t zero     = vdupq_n_u32(0);
+    uint32x4_t previous = vdupq_n_u32(vertex);
+    for (size_t i = 0; ; ) {
+        values   = vaddq_u32(values, vextq_u32(zero, values, 3));
+        values   = vaddq_u32(values, vextq_u32(zero, values, 2));
+        values   = vaddq_u32(values, previous);
+        vst1q_u32(&neighbors[i], values);
+        previous = vdupq_n_u32(vgetq_lane_u32(values, 3));
+
+        i += 4;
+        if (i >= degree) {
+            return degree;
+        }
+        byte   = *control++;
+        values = vreinterpretq_u32_u8(vqtbl1q_u8(vld1q_u8(gaps),
+                                                 vld1q_u8(compressed_graph_shuffles[byte])));
+        gaps  += compressed_graph_lengths[byte];
+    }
+}
+#endif
+
+// Internal utility function that decodes a row one gap at a time.
+//
+static size_t _compressed_graph_decode_scalar(const uint8_t * row, unsigned int vertex,
+                                              unsigned int * neighbors)
+{
+    size_t degree;
+    const uint8_t * control = _compressed_graph_read_degree(row, &degree);
+    const uint8_t * gaps    = control + (degree + 3) / 4;
+
+    unsigned int previous = vertex;
+    for (size_t i = 0; i < degree; i++) {
+        size_t length = ((control[i / 4] >> (2 * (i % 4))) & 3) + 1;
+        uint32_t gap  = 0;
+        for (size_t byte = 0; byte < length; byte++) {
+            gap |= (uint32_t)gaps[byte] << (8 * byte);
+        }
+        gaps        += length;
+        previous    += i == 0 ? _compressed_graph_unzigzag(gap) : gap;
+        neighbors[i] = previous;
+    }
+    return degree;
+}
+
+// Internal utility function that fills in the decoding tables and
+// picks the row decoder.
+//
+static void _compressed_graph_init_tables(void) {
+    for (size_t control = 0; control < 256; control++) {
+        uint8_t position = 0;
+        for (size_t lane = 0; lane < 4; lane++) {
+            size_t length = ((control >> (2 * lane)) & 3) + 1;
+            for (size_t byte = 0; byte < 4; byte++) {
+                compressed_graph_shuffles[control][4 * lane + byte] =
+                    byte < length ? (uint8_t)(position + byte) : 0x80;
+            }
+            position += (uint8_t)length;
+        }
+        compressed_graph_lengths[control] = position;
+    }
+
+    // pshufb is not part of baseline x86-64, so the SSSE3 decoder is
+    // only used on CPUs that report it.
+    //
+#if defined(COMPRESSED_GRAPH_SSSE3)
+    __builtin_cpu_init();
+    compressed_graph_decoder = __builtin_cpu_supports("ssse3") ? _compressed_graph_decode_ssse3
+                                                               : _compressed_graph_decode_scalar;
+#elif defined(COMPRESSED_GRAPH_NEON)
+    compressed_graph_decoder = _compressed_graph_decode_neon;
+#else
+    compressed_graph_decoder = _compressed_graph_decode_scalar;
+#endif
+}
+
+// Compresses the adjacency lists of a graph.
+// \param graph : Graph to compress.
+// Returns a new compressed graph on success, NULL on failure or if
+// the rows take more than GRAPH_MAX_EDGES bytes.
+//
+struct compressed_graph * compressed_graph_create(struct graph * graph) {
+    if (graph == NULL) {
+        return NULL;
+    }
+    pthread_once(&compressed_graph_tables_once, _compressed_graph_init_tables);
+
+    struct compressed_graph * compressed = (struct compressed_graph*)calloc(1, sizeof(struct compressed_graph));
+    if (compressed == NULL) {
+        return NULL;
+    }
+    compressed->num_vertices = graph->num_vertices;
+    compressed->num_edges    = graph->num_edges;
+    compressed->decoder      = compressed_graph_decoder;
+    for (size_t v = 0; v < graph->num_vertices; v++) {
+        size_t degree = (size_t)(graph->offsets[v + 1] - graph->offsets[v]);
+        if (degree > compressed->max_degree) {
+            compressed->max_degree = degree;
+        }
+    }
+
+    // Encode into a buffer sized for the worst case, 5 bytes of degree
+    // and 4.25 bytes per gap, then shrink it to fit.
+    //
+    size_t bound = 6 * graph->num_vertices + 5 * graph->num_edges + COMPRESSED_GRAPH_PADDING;
+    compressed->row_starts = (graph_offset_t*)malloc((graph->num_vertices + 1) * sizeof(graph_offset_t));
+    compressed->data       = (uint8_t*)malloc(bound);
+    unsigned int * row     = (unsigned int*)malloc((compressed->max_degree + 1) * sizeof(unsigned int));
+    if (compressed->row_starts == NULL || compressed->data == NULL || row == NULL) {
+        free(row);
+        compressed_graph_delete(compressed);
+        return NULL;
+    }
+
+    // Row starts are graph_offset_t, so every row, the end of the last
+    // one included, must start within GRAPH_MAX_EDGES bytes.
+    //
+    size_t position = 0;
+    for (size_t v = 0; v < graph->num_vertices; v++) {
+        compressed->row_starts[v] = (graph_offset_t)position;
+
+        size_t degree = (size_t)(graph->offsets[v + 1] - graph->offsets[v]);
+        memcpy(row, &graph->neighbors[graph->offsets[v]], degree * sizeof(unsigned int));
+        qsort(row, degree, sizeof(unsigned int), _compressed_graph_compare);
+        position += _compressed_graph_encode_row((unsigned int)v, row, degree,
+                                                 compressed->data + position);
+        if ((uint64_t)position > GRAPH_MAX_EDGES) {
+            free(row);
+            compressed_graph_delete(compressed);
+            return NULL;
+        }
+    }
+    compressed->row_starts[graph->num_vertices] = (graph_offset_t)position;
+    compressed->data_bytes = position;
+    free(row);
+
+    memset(compressed->data + position, 0, COMPRESSED_GRAPH_PADDING);
+    uint8_t * data = (uint8_t*)realloc(compressed->data, position + COMPRESSED_GRAPH_PADDING);
+    if (data != NULL) {
+        compressed->data = data;
+    }
+
+    return compressed;
+}
+
+// Deletes a compressed graph and frees all memory associated with it.
+// \param compressed : Pointer to compressed graph to delete.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool compressed_graph_delete(struct compressed_graph * compressed) {
+    if (compressed == NULL) {
+        return false;
+    }
+
+    free(compressed->row_starts);
+    free(compressed->data);
+    free(compressed);
+    return true;
+}
+
+// Returns the number of bytes used by the row starts and row data.
+// \param compressed : Pointer to compressed graph.
+// Returns size on success, SIZE_MAX otherwise.
+//
+size_t compressed_graph_memory_bytes(struct compressed_graph * compressed) {
+    if (compressed == NULL) {
+        return SIZE_MAX;
+    }
+
+    return (compressed->num_vertices + 1) * sizeof(graph_offset_t) + compressed->data_bytes;
+}
+
+// Decodes the out-neighbors of a vertex, in increasing order, one gap
+// at a time whatever the CPU supports. Slower than
+// compressed_graph_decode_row(), but it gives the SIMD decoders
+// something to be checked against.
+// \param compressed : Pointer to compressed graph.
+// \param vertex     : Vertex, less than num_vertices.
+// \param neighbors  : Array of max_degree entries (provided by caller).
+// Returns the degree of vertex, 0 on error.
+//
+size_t compressed_graph_decode_row_scalar(const struct compressed_graph * compressed,
+                                          unsigned int vertex, unsigned int * neighbors)
+{
+    if (compressed == NULL || vertex >= compressed->num_vertices || neighbors == NULL) {
+        return 0;
+    }
+
+    return _compressed_graph_decode_scalar(compressed->data + compressed->row_starts[vertex], vertex,
+                                           neighbors);
+}
@@ -0,0 +1,101 @@
+// MIT License. Copyright (c) 2025 Kshitij Jain
+// See LICENSE file in the root of this repository.
+
+#ifndef _COMPRESSED_GRAPH_H
+#define _COMPRESSED_GRAPH_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "graph.h"
+
+// A directed graph whose adjacency lists are compressed with a Stream
+// VByte-style encoding, after Lemire et al.
+//
+// Every row is sorted and stored as the gaps between consecutive
+// neighbors. The first gap is taken from the row's own vertex and
+// zigzag encoded, so that under a locality ordering, where neighbors
+// have nearby IDs, it is as short as the others. A row is laid out as
+//     varint degree
+//     control bytes, one per four gaps, two bits per gap: length - 1
+//     gap bytes, each gap in 1 to 4 little endian bytes
+// Keeping the lengths apart from the gaps lets a decoder expand four
+// gaps per control byte with a single byte shuffle, so rows are cheap
+// enough to decode every time a search reads them.
+//
+// Neighbor IDs are those of the graph the rows were taken from,
+// including any relabeling it carries.
+
+// Entries a decode buffer needs beyond the degree of the row, since
+// the decoder always writes four neighbors at a time.
+//
+#define COMPRESSED_GRAPH_DECODE_SLACK 4
+
+// Readable bytes after the last row, since the decoder loads sixteen
+// gap bytes at a time.
+//
+#define COMPRESSED_GRAPH_PADDING 16
+
+// Decodes the row starting at row, which belongs to vertex, into
+// neighbors and returns its degree.
+//
+typedef size_t (*compressed_graph_decoder_t)(const uint8_t * row, unsigned int vertex,
+                                             unsigned int * neighbors);
+
+struct compressed_graph {
+    size_t num_vertices;
+    size_t num_edges;
+    size_t max_degree;
+    graph_offset_t * row_starts;    // num_vertices + 1 byte positions.
+    uint8_t * data;                 // data_bytes rows plus padding.
+    size_t data_bytes;
+    compressed_graph_decoder_t decoder; // SIMD if the CPU supports it.
+};
+
+// Compresses the adjacency lists of a graph.
+// \param graph : Graph to compress.
+// Returns a new compressed graph on success, NULL on failure or if
+// the rows take more than GRAPH_MAX_EDGES bytes.
+//
+struct compressed_graph * compressed_graph_create(struct graph * graph);
+
+// Deletes a compressed graph and frees all memory associated with it.
+// \param compressed : Pointer to compressed graph to delete.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool compressed_graph_delete(struct compressed_graph * compressed);
+
+// Returns the number of bytes used by the row starts and row data.
+// \param compressed : Pointer to compressed graph.
+// Returns size on success, SIZE_MAX otherwise.
+//
+size_t compressed_graph_memory_bytes(struct compressed_graph * compressed);
+
+// Decodes the out-neighbors of a vertex, in increasing order, one gap
+// at a time whatever the CPU supports. Slower than
+// compressed_graph_decode_row(), but it gives the SIMD decoders
+// something to be checked against.
+// \param compressed : Pointer to compressed graph.
+// \param vertex     : Vertex, less than num_vertices.
+// \param neighbors  : Array of max_degree entries (provided by caller).
+// Returns the degree of vertex, 0 on error.
+//
+size_t compressed_graph_decode_row_scalar(const struct compressed_graph * compressed,
+                                          unsigned int vertex, unsigned int * neighbors);
+
+// Decodes the out-neighbors of a vertex, in increasing order. Searches
+// decode every row they expand, so this is inlined into them.
+// \param compressed : Pointer to compressed graph.
+// \param vertex     : Vertex, less than num_vertices.
+// \param neighbors  : Array of max_degree + COMPRESSED_GRAPH_DECODE_SLACK
+//                     entries (provided by caller).
+// Returns the degree of vertex.
+//
+static inline size_t compressed_graph_decode_row(const struct compressed_graph * compressed,
+                                                 unsigned int vertex, unsigned int * neighbors)
+{
+    return compressed->decoder(compressed->data + compressed->row_starts[vertex], vertex, neighbors);
+}
+
+#endif
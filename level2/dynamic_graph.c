@@ -0,0 +1,325 @@
+// MIT License. Copyright (c) 2025 Kshitij Jain
+// See LICENSE file in the root of this repository.
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "dynamic_graph.h"
+
+// Passed as the vertex that needs a free slot when none does.
+//
+#define DYNAMIC_GRAPH_NO_VERTEX SIZE_MAX
+
+// Internal utility function that copies rows first ... last - 1 to the
+// front of the scratch array, packed.
+// \param dynamic : Pointer to dynamic graph.
+// \param first   : First vertex to copy.
+// \param last    : One past the last vertex to copy.
+// Returns the number of neighbors copied.
+//
+static size_t _dynamic_graph_gather(struct dynamic_graph * dynamic, size_t first, size_t last) {
+    size_t count = 0;
+    for (size_t v = first; v < last; v++) {
+        const struct dynamic_graph_row * row = &dynamic->rows[v];
+        memcpy(&dynamic->scratch[count], &dynamic->slots[row->start], row->degree * sizeof(unsigned int));
+        count += row->degree;
+    }
+    return count;
+}
+
+// Internal utility function that lays out rows first ... last - 1,
+// packed in the scratch array, over slots begin ... end - 1. Every row
+// gets its neighbors, a slot more for extra, and a share of the
+// remaining slots in proportion to its degree + 1.
+// \param dynamic : Pointer to dynamic graph.
+// \param first   : First vertex to lay out.
+// \param last    : One past the last vertex to lay out.
+// \param begin   : First slot of the window.
+// \param end     : One past the last slot of the window.
+// \param extra   : Vertex that needs a free slot, or
+//                  DYNAMIC_GRAPH_NO_VERTEX.
+//
+static void _dynamic_graph_spread(struct dynamic_graph * dynamic, size_t first, size_t last,
+                                  size_t begin, size_t end, size_t extra)
+{
+    size_t needed = 0;
+    size_t weight = 0;
+    for (size_t v = first; v < last; v++) {
+        needed += dynamic->rows[v].degree + (v == extra);
+        weight += dynamic->rows[v].degree + 1;
+    }
+    size_t spare = end - begin - needed;
+
+    size_t packed     = 0;
+    size_t position   = begin;
+    size_t cumulative = 0;
+    size_t handed_out = 0;
+    for (size_t v = first; v < last; v++) {
+        struct dynamic_graph_row * row = &dynamic->rows[v];
+        cumulative += row->degree + 1;
+        size_t share = (size_t)((unsigned __int128)spare * cumulative / weight) - handed_out;
+        handed_out  += share;
+
+        row->start = (graph_offset_t)position;
+        memcpy(&dynamic->slots[position], &dynamic->scratch[packed], row->degree * sizeof(unsigned int));
+        packed   += row->degree;
+        position += row->degree + (v == extra) + share;
+    }
+}
+
+// Internal utility function that moves every row into a new slot array
+// filled to DYNAMIC_GRAPH_FILL_DENSITY. The rows must be packed in the
+// scratch array. On failure the graph is unchanged.
+// \param dynamic : Pointer to dynamic graph.
+// \param extra   : Vertex that needs a free slot, or
+//                  DYNAMIC_GRAPH_NO_VERTEX.
+// Returns TRUE on success, FALSE otherwise.
+//
+static bool _dynamic_graph_reallocate(struct dynamic_graph * dynamic, size_t extra) {
+    size_t needed    = dynamic->num_edges + (extra != DYNAMIC_GRAPH_NO_VERTEX);
+    size_t num_slots = (size_t)((double)needed / DYNAMIC_GRAPH_FILL_DENSITY) + 1;
+    if (num_slots >= GRAPH_MAX_EDGES) {
+        return false;
+    }
+
+    unsigned int * slots = (unsigned int*)malloc((num_slots + 1) * sizeof(unsigned int));
+    if (slots == NULL) {
+        return false;
+    }
+    unsigned int * scratch = (unsigned int*)realloc(dynamic->scratch, (num_slots + 1) * sizeof(unsigned int));
+    if (scratch == NULL) {
+        free(slots);
+        return false;
+    }
+
+    free(dynamic->slots);
+    dynamic->slots     = slots;
+    dynamic->scratch   = scratch;
+    dynamic->num_slots = num_slots;
+    dynamic->rows[dynamic->num_vertices].start = (graph_offset_t)num_slots;
+    _dynamic_graph_spread(dynamic, 0, dynamic->num_vertices, 0, num_slots, extra);
+    dynamic->slots_moved += dynamic->num_edges;
+    ++dynamic->reallocations;
+    return true;
+}
+
+// Internal utility function that frees a slot at the end of a full
+// row. It respreads the smallest window around the row whose density
+// stays under its threshold with one more edge, or reallocates the
+// slots if there is none.
+// \param dynamic : Pointer to dynamic graph.
+// \param vertex  : Vertex whose row is full.
+// Returns TRUE on success, FALSE otherwise.
+//
+static bool _dynamic_graph_make_room(struct dynamic_graph * dynamic, size_t vertex) {
+    size_t first = vertex;
+    size_t last  = vertex;
+    size_t count = 1;
+    for (size_t level = 0; level <= dynamic->height; level++) {
+        size_t shift          = DYNAMIC_GRAPH_LEAF_SHIFT + level;
+        size_t window_first   = (vertex >> shift) << shift;
+        size_t window_last    = window_first + ((size_t)1 << shift);
+        if (window_last > dynamic->num_vertices) {
+            window_last = dynamic->num_vertices;
+        }
+
+        // Windows nest, so only the vertices new to this one are
+        // counted.
+        //
+        for (size_t v = window_first; v < first; v++) {
+            count += dynamic->rows[v].degree;
+        }
+        for (size_t v = last; v < window_last; v++) {
+            count += dynamic->rows[v].degree;
+        }
+        first = window_first;
+        last  = window_last;
+
+        double density = dynamic->height == 0 ? DYNAMIC_GRAPH_ROOT_DENSITY
+            : 1.0 - (1.0 - DYNAMIC_GRAPH_ROOT_DENSITY) * (double)level / (double)dynamic->height;
+        size_t begin = dynamic->rows[first].start;
+        size_t end   = dynamic->rows[last].start;
+        if ((double)count <= density * (double)(end - begin)) {
+            _dynamic_graph_gather(dynamic, first, last);
+            _dynamic_graph_spread(dynamic, first, last, begin, end, vertex);
+            dynamic->slots_moved += count - 1;
+            ++dynamic->windows_respread;
+            return true;
+        }
+    }
+
+    _dynamic_graph_gather(dynamic, 0, dynamic->num_vertices);
+    return _dynamic_graph_reallocate(dynamic, vertex);
+}
+
+// Copies the rows of a graph into a dynamic graph, keeping one copy
+// of each parallel edge.
+// \param graph : Graph to copy.
+// Returns a new dynamic graph on success, NULL on failure.
+//
+struct dynamic_graph * dynamic_graph_create(struct graph * graph) {
+    if (graph == NULL) {
+        return NULL;
+    }
+
+    struct dynamic_graph * dynamic = (struct dynamic_graph*)calloc(1, sizeof(struct dynamic_graph));
+    if (dynamic == NULL) {
+        return NULL;
+    }
+    dynamic->num_vertices = graph->num_vertices;
+    while (graph->num_vertices > 0
+           && ((graph->num_vertices - 1) >> (DYNAMIC_GRAPH_LEAF_SHIFT + dynamic->height)) > 0) {
+        ++dynamic->height;
+    }
+
+    dynamic->rows    = (struct dynamic_graph_row*)calloc(graph->num_vertices + 1,
+                                                         sizeof(struct dynamic_graph_row));
+    dynamic->scratch = (unsigned int*)malloc((graph->num_edges + 1) * sizeof(unsigned int));
+    unsigned int * last_row = (unsigned int*)malloc((graph->num_vertices + 1) * sizeof(unsigned int));
+    if (dynamic->rows == NULL || dynamic->scratch == NULL || last_row == NULL) {
+        free(last_row);
+        dynamic_graph_delete(dynamic);
+        return NULL;
+    }
+
+    // Updates treat the rows as sets, so parallel edges of the input
+    // are kept once. last_row[u] is the last row u was copied into.
+    //
+    memset(last_row, 0xff, graph->num_vertices * sizeof(unsigned int));
+    for (size_t v = 0; v < graph->num_vertices; v++) {
+        for (graph_offset_t edge = graph->offsets[v]; edge < graph->offsets[v + 1]; edge++) {
+            unsigned int neighbor = graph->neighbors[edge];
+            if (last_row[neighbor] != v) {
+                last_row[neighbor]                     = (unsigned int)v;
+                dynamic->scratch[dynamic->num_edges++] = neighbor;
+                ++dynamic->rows[v].degree;
+            }
+        }
+    }
+    free(last_row);
+    if (!_dynamic_graph_reallocate(dynamic, DYNAMIC_GRAPH_NO_VERTEX)) {
+        dynamic_graph_delete(dynamic);
+        return NULL;
+    }
+    dynamic->slots_moved   = 0;
+    dynamic->reallocations = 0;
+    return dynamic;
+}
+
+// Deletes a dynamic graph and frees all memory associated with it.
+// \param dynamic : Pointer to dynamic graph to delete.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool dynamic_graph_delete(struct dynamic_graph * dynamic) {
+    if (dynamic == NULL) {
+        return false;
+    }
+
+    free(dynamic->rows);
+    free(dynamic->slots);
+    free(dynamic->scratch);
+    free(dynamic);
+    return true;
+}
+
+// Returns the number of bytes used by the rows and slots.
+// \param dynamic : Pointer to dynamic graph.
+// Returns size on success, SIZE_MAX otherwise.
+//
+size_t dynamic_graph_memory_bytes(struct dynamic_graph * dynamic) {
+    if (dynamic == NULL) {
+        return SIZE_MAX;
+    }
+
+    return (dynamic->num_vertices + 1) * sizeof(struct dynamic_graph_row)
+        + dynamic->num_slots * sizeof(unsigned int);
+}
+
+// Internal utility function that finds a neighbor in a row.
+// \param dynamic : Pointer to dynamic graph.
+// \param source  : Vertex of the row.
+// \param target  : Neighbor to look for.
+// Returns the slot of target, SIZE_MAX if it is not in the row.
+//
+static size_t _dynamic_graph_find(const struct dynamic_graph * dynamic, unsigned int source,
+                                  unsigned int target)
+{
+    const struct dynamic_graph_row * row = &dynamic->rows[source];
+    for (size_t slot = row->start; slot < (size_t)row->start + row->degree; slot++) {
+        if (dynamic->slots[slot] == target) {
+            return slot;
+        }
+    }
+    return SIZE_MAX;
+}
+
+// Inserts an edge unless it is already present.
+// \param dynamic : Pointer to dynamic graph.
+// \param source  : Vertex the edge leaves.
+// \param target  : Vertex the edge enters.
+// Returns TRUE if the edge was inserted, FALSE if it was present or
+// on error.
+//
+bool dynamic_graph_insert_edge(struct dynamic_graph * dynamic, unsigned int source,
+                               unsigned int target)
+{
+    if (dynamic == NULL || source >= dynamic->num_vertices || target >= dynamic->num_vertices
+        || _dynamic_graph_find(dynamic, source, target) != SIZE_MAX) {
+        return false;
+    }
+
+    struct dynamic_graph_row * row = &dynamic->rows[source];
+    if (row->start + row->degree == dynamic->rows[source + 1].start
+        && !_dynamic_graph_make_room(dynamic, source)) {
+        return false;
+    }
+    dynamic->slots[row->start + row->degree++] = target;
+    ++dynamic->num_edges;
+    return true;
+}
+
+// Deletes an edge.
+// \param dynamic : Pointer to dynamic graph.
+// \param source  : Vertex the edge leaves.
+// \param target  : Vertex the edge enters.
+// Returns TRUE if the edge was deleted, FALSE if it was not present or
+// on error.
+//
+bool dynamic_graph_delete_edge(struct dynamic_graph * dynamic, unsigned int source,
+                               unsigned int target)
+{
+    if (dynamic == NULL || source >= dynamic->num_vertices || target >= dynamic->num_vertices) {
+        return false;
+    }
+    size_t slot = _dynamic_graph_find(dynamic, source, target);
+    if (slot == SIZE_MAX) {
+        return false;
+    }
+
+    struct dynamic_graph_row * row = &dynamic->rows[source];
+    dynamic->slots[slot] = dynamic->slots[row->start + --row->degree];
+    --dynamic->num_edges;
+
+    // The edge is gone either way, a failed shrink keeps the slots.
+    //
+    if ((double)dynamic->num_edges < DYNAMIC_GRAPH_MIN_DENSITY * (double)dynamic->num_slots) {
+        _dynamic_graph_gather(dynamic, 0, dynamic->num_vertices);
+        _dynamic_graph_reallocate(dynamic, DYNAMIC_GRAPH_NO_VERTEX);
+    }
+    return true;
+}
+
+// Checks whether an edge is present.
+// \param dynamic : Pointer to dynamic graph.
+// \param source  : Vertex the edge leaves.
+// \param target  : Vertex the edge enters.
+// Returns TRUE if the edge is present, FALSE otherwise.
+//
+bool dynamic_graph_has_edge(struct dynamic_graph * dynamic, unsigned int source,
+                            unsigned int target)
+{
+    if (dynamic == NULL || source >= dynamic->num_vertices || target >= dynamic->num_vertices) {
+        return false;
+    }
+    return _dynamic_graph_find(dynamic, source, target) != SIZE_MAX;
+}
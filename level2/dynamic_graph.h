@@ -0,0 +1,126 @@
+// MIT License. Copyright (c) 2025 Kshitij Jain
+// See LICENSE file in the root of this repository.
+
+#ifndef _DYNAMIC_GRAPH_H
+#define _DYNAMIC_GRAPH_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "graph.h"
+
+// A directed graph whose edges can be inserted and deleted after it
+// is built, in packed CSR form after the packed memory array (PMA).
+//
+// Rows are laid out in vertex order in one slot array, as in CSR, but
+// every row owns some free slots after its neighbors:
+//     slots[rows[v].start] ... slots[rows[v].start + rows[v].degree - 1]
+// are the out-neighbors of v, and the row ends at rows[v + 1].start. A
+// scan is still a single streaming read. An insertion into a row with
+// a free slot appends to it. A full row makes the insertion respread
+// the smallest enclosing window of vertices whose slots are not too
+// full, as in a PMA: windows are aligned blocks of 2^h leaves, and the
+// density they may reach falls from 1 at a leaf to
+// DYNAMIC_GRAPH_ROOT_DENSITY for all vertices. Free slots are handed
+// out in proportion to degree + 1, so busy rows get more of them. When
+// even the root is too full, the slots are reallocated at
+// DYNAMIC_GRAPH_FILL_DENSITY. Insertions take amortized O(log^2 n)
+// moves besides the duplicate check, which scans the row.
+//
+// A deletion moves the last neighbor of its row into the hole, so
+// rows do not keep their order. Freed slots stay with their row. The
+// slots are reallocated when less than DYNAMIC_GRAPH_MIN_DENSITY of
+// them are in use.
+//
+// Each row is a set: an edge is present or not, and parallel edges of
+// the graph the rows are taken from are kept once. Insertion refuses
+// an edge that is present, and deletion removes the only copy.
+//
+// The vertex set is fixed. Vertex IDs are those of the graph the rows
+// were taken from, including any relabeling it carries. Neither
+// updates nor searches lock, so a graph must not be updated while it
+// is searched.
+
+// Vertices per leaf window, as a power of two.
+//
+#define DYNAMIC_GRAPH_LEAF_SHIFT 6
+
+// Fraction of the slots in use right after they are reallocated, and
+// the most and the least the whole slot array may hold.
+//
+#define DYNAMIC_GRAPH_FILL_DENSITY 0.5
+#define DYNAMIC_GRAPH_ROOT_DENSITY 0.75
+#define DYNAMIC_GRAPH_MIN_DENSITY  0.25
+
+struct dynamic_graph_row {
+    graph_offset_t start;           // First slot of the row.
+    graph_offset_t degree;          // Neighbors at the front of the row.
+};
+
+struct dynamic_graph {
+    size_t num_vertices;
+    size_t num_edges;
+    size_t num_slots;
+    size_t height;                  // Levels of windows above the leaves.
+    struct dynamic_graph_row * rows;    // num_vertices + 1 entries, the
+                                        // last one starts at num_slots.
+    unsigned int * slots;           // num_slots entries.
+    unsigned int * scratch;         // num_slots entries, for respreading.
+
+    // Statistics since the graph was created.
+    //
+    size_t windows_respread;
+    size_t slots_moved;
+    size_t reallocations;
+};
+
+// Copies the rows of a graph into a dynamic graph, keeping one copy
+// of each parallel edge.
+// \param graph : Graph to copy.
+// Returns a new dynamic graph on success, NULL on failure.
+//
+struct dynamic_graph * dynamic_graph_create(struct graph * graph);
+
+// Deletes a dynamic graph and frees all memory associated with it.
+// \param dynamic : Pointer to dynamic graph to delete.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool dynamic_graph_delete(struct dynamic_graph * dynamic);
+
+// Returns the number of bytes used by the rows and slots.
+// \param dynamic : Pointer to dynamic graph.
+// Returns size on success, SIZE_MAX otherwise.
+//
+size_t dynamic_graph_memory_bytes(struct dynamic_graph * dynamic);
+
+// Inserts an edge unless it is already present.
+// \param dynamic : Pointer to dynamic graph.
+// \param source  : Vertex the edge leaves.
+// \param target  : Vertex the edge enters.
+// Returns TRUE if the edge was inserted, FALSE if it was present or
+// on error.
+//
+bool dynamic_graph_insert_edge(struct dynamic_graph * dynamic, unsigned int source,
+                               unsigned int target);
+
+// Deletes an edge.
+// \param dynamic : Pointer to dynamic graph.
+// \param source  : Vertex the edge leaves.
+// \param target  : Vertex the edge enters.
+// Returns TRUE if the edge was deleted, FALSE if it was not present or
+// on error.
+//
+bool dynamic_graph_delete_edge(struct dynamic_graph * dynamic, unsigned int source,
+                               unsigned int target);
+
+// Checks whether an edge is present.
+// \param dynamic : Pointer to dynamic graph.
+// \param source  : Vertex the edge leaves.
+// \param target  : Vertex the edge enters.
+// Returns TRUE if the edge is present, FALSE otherwise.
+//
+bool dynamic_graph_has_edge(struct dynamic_graph * dynamic, unsigned int source,
+                            unsigned int target);
+
+#endif
@@ -0,0 +1,257 @@
+// MIT License. Copyright (c) 2025 Kshitij Jain
+// See LICENSE file in the root of this repository.
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "external_graph.h"
+#include "graph_cache.h"
+
+// Internal utility function that reads a whole buffer at a position.
+// \param fd       : File descriptor.
+// \param data     : Buffer to read into.
+// \param bytes    : Number of bytes.
+// \param position : File offset to read at.
+// Returns TRUE on success, FALSE otherwise.
+//
+static bool _external_graph_pread_all(int fd, void * data, size_t bytes, uint64_t position) {
+    char * p = (char*)data;
+    while (bytes > 0) {
+        ssize_t count = pread(fd, p, bytes, (off_t)position);
+        if (count <= 0) {
+            return false;
+        }
+        p        += count;
+        bytes    -= (size_t)count;
+        position += (uint64_t)count;
+    }
+    return true;
+}
+
+// Internal utility function that returns the length of the prefix of
+// a sorted run of vertices whose rows can be fetched together.
+// \param external    : Pointer to external graph.
+// \param vertices    : Array of count vertices, in increasing order.
+// \param count       : Number of vertices, at least 1.
+// \param max_entries : Largest span of the prefix, in edges.
+// \param begin       : Pointer to the first edge of the span (provided by caller).
+// \param end         : Pointer to one past its last edge (provided by caller).
+// Returns the number of vertices in the prefix, at least 1.
+//
+static size_t _external_graph_run(const struct external_graph * external,
+                                  const unsigned int * vertices, size_t count,
+                                  size_t max_entries, graph_offset_t * begin,
+                                  graph_offset_t * end)
+{
+    const graph_offset_t * offsets = external->offsets;
+    const graph_offset_t max_gap   = EXTERNAL_GRAPH_MAX_GAP / sizeof(unsigned int);
+
+    graph_offset_t run_begin = offsets[vertices[0]];
+    graph_offset_t run_end   = offsets[vertices[0] + 1];
+    size_t covered = 1;
+    for (; covered < count; covered++) {
+        graph_offset_t row_begin = offsets[vertices[covered]];
+        graph_offset_t row_end   = offsets[vertices[covered] + 1];
+        if (row_begin - run_end > max_gap || (size_t)(row_end - run_begin) > max_entries) {
+            break;
+        }
+        run_end = row_end;
+    }
+
+    *begin = run_begin;
+    *end   = run_end;
+    return covered;
+}
+
+// Opens a graph cache file for semi-external searches.
+// \param path : Path of the cache file, as written by graph_cache_write().
+// Returns a new external graph on success, NULL if the cache is
+// missing or corrupt.
+//
+struct external_graph * external_graph_open(const char * path) {
+    if (path == NULL) {
+        return NULL;
+    }
+
+    struct external_graph * external = (struct external_graph*)calloc(1, sizeof(struct external_graph));
+    if (external == NULL) {
+        return NULL;
+    }
+    external->fd = open(path, O_RDONLY);
+    if (external->fd < 0) {
+        free(external);
+        return NULL;
+    }
+
+    struct stat st;
+    struct graph_cache_header header;
+    if (fstat(external->fd, &st) != 0
+        || !_external_graph_pread_all(external->fd, &header, sizeof(header), 0)
+        || !graph_cache_header_check(&header, (uint64_t)st.st_size, NULL)) {
+        external_graph_close(external);
+        return NULL;
+    }
+    external->num_vertices       = header.num_vertices;
+    external->num_edges          = header.num_edges;
+    external->neighbors_position = header.neighbors_position;
+
+    // The offsets are read once, front to back, and stay in memory.
+    //
+    size_t offsets_bytes = (external->num_vertices + 1) * sizeof(graph_offset_t);
+    external->offsets = (graph_offset_t*)malloc(offsets_bytes);
+    if (external->offsets == NULL
+        || !_external_graph_pread_all(external->fd, external->offsets, offsets_bytes,
+                                      header.offsets_position)
+        || external->offsets[0] != 0
+        || external->offsets[external->num_vertices] != external->num_edges) {
+        external_graph_close(external);
+        return NULL;
+    }
+    for (size_t v = 0; v < external->num_vertices; v++) {
+        if (external->offsets[v + 1] < external->offsets[v]) {
+            external_graph_close(external);
+            return NULL;
+        }
+        size_t degree = (size_t)(external->offsets[v + 1] - external->offsets[v]);
+        if (degree > external->max_degree) {
+            external->max_degree = degree;
+        }
+    }
+
+    // Searches read rows in an order the kernel cannot guess, and say
+    // which ones they need next themselves. Readahead around every
+    // fault or read would only push useful pages out of memory.
+    //
+    external->mapping_bytes = (size_t)st.st_size;
+    external->mapping = mmap(NULL, external->mapping_bytes, PROT_READ, MAP_SHARED, external->fd, 0);
+    if (external->mapping == MAP_FAILED) {
+        external->mapping = NULL;
+        external_graph_close(external);
+        return NULL;
+    }
+    madvise(external->mapping, external->mapping_bytes, MADV_RANDOM);
+    posix_fadvise(external->fd, 0, 0, POSIX_FADV_RANDOM);
+    external->neighbors = (const unsigned int*)((const char*)external->mapping
+                                                + external->neighbors_position);
+
+    return external;
+}
+
+// Closes an external graph and frees all memory associated with it.
+// \param external : Pointer to external graph to close.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool external_graph_close(struct external_graph * external) {
+    if (external == NULL) {
+        return false;
+    }
+
+    if (external->mapping != NULL) {
+        munmap(external->mapping, external->mapping_bytes);
+    }
+    if (external->fd >= 0) {
+        close(external->fd);
+    }
+    free(external->offsets);
+    free(external);
+    return true;
+}
+
+// Returns the number of entries a read buffer needs.
+// \param external : Pointer to external graph.
+// Returns size on success, 0 otherwise.
+//
+size_t external_graph_buffer_entries(struct external_graph * external) {
+    if (external == NULL) {
+        return 0;
+    }
+
+    size_t entries = EXTERNAL_GRAPH_BUFFER_BYTES / sizeof(unsigned int);
+    return external->max_degree > entries ? external->max_degree : entries;
+}
+
+// Reads the rows of a prefix of a sorted run of vertices with a single
+// pread(). The prefix ends where the next row is more than
+// EXTERNAL_GRAPH_MAX_GAP bytes away or would not fit in the buffer.
+// The row of a covered vertex v starts at buffer[offsets[v] - *base].
+// \param external       : Pointer to external graph.
+// \param vertices       : Array of count vertices, in increasing order.
+// \param count          : Number of vertices, at least 1.
+// \param buffer         : Read buffer (provided by caller).
+// \param buffer_entries : Size of buffer, see external_graph_buffer_entries().
+// \param base           : Pointer to the edge index of buffer[0]
+//                         (provided by caller).
+// Returns the number of vertices covered, 0 on failure.
+//
+size_t external_graph_read_rows(struct external_graph * external, const unsigned int * vertices,
+                                size_t count, unsigned int * buffer, size_t buffer_entries,
+                                graph_offset_t * base)
+{
+    if (external == NULL || vertices == NULL || count == 0 || buffer == NULL
+        || buffer_entries < external->max_degree || base == NULL) {
+        return 0;
+    }
+
+    graph_offset_t begin, end;
+    size_t covered = _external_graph_run(external, vertices, count, buffer_entries, &begin, &end);
+    size_t bytes   = (size_t)(end - begin) * sizeof(unsigned int);
+    if (!_external_graph_pread_all(external->fd, buffer, bytes,
+                                   external->neighbors_position + (uint64_t)begin * sizeof(unsigned int))) {
+        printf("Failed to read %zu bytes of rows from the external graph.\n", bytes);
+        return 0;
+    }
+
+    __atomic_fetch_add(&external->reads, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&external->bytes_read, bytes, __ATOMIC_RELAXED);
+    *base = begin;
+    return covered;
+}
+
+// Tells the kernel that the rows of a prefix of a sorted run of
+// vertices will be read soon, through the mapping or with pread().
+// \param external  : Pointer to external graph.
+// \param vertices  : Array of count vertices, in increasing order.
+// \param count     : Number of vertices, at least 1.
+// \param max_bytes : The prefix ends once its rows span this many bytes.
+// \param mapped    : Whether the rows will be read through the mapping.
+// Returns the number of vertices covered, at least 1.
+//
+size_t external_graph_advise(struct external_graph * external, const unsigned int * vertices,
+                             size_t count, size_t max_bytes, bool mapped)
+{
+    if (external == NULL || vertices == NULL || count == 0) {
+        return count;
+    }
+
+    // One hint per run of nearby rows, like the reads themselves.
+    //
+    size_t page_size  = (size_t)sysconf(_SC_PAGESIZE);
+    size_t advised    = 0;
+    size_t span_bytes = 0;
+    while (advised < count && span_bytes < max_bytes) {
+        graph_offset_t begin, end;
+        advised += _external_graph_run(external, vertices + advised, count - advised,
+                                       SIZE_MAX / sizeof(unsigned int), &begin, &end);
+        if (begin == end) {
+            continue;
+        }
+
+        uint64_t position = external->neighbors_position + (uint64_t)begin * sizeof(unsigned int);
+        size_t bytes      = (size_t)(end - begin) * sizeof(unsigned int);
+        if (mapped) {
+            uint64_t aligned = position & ~(uint64_t)(page_size - 1);
+            madvise((char*)external->mapping + aligned, (size_t)(position - aligned) + bytes,
+                    MADV_WILLNEED);
+        } else {
+            posix_fadvise(external->fd, (off_t)position, (off_t)bytes, POSIX_FADV_WILLNEED);
+        }
+        span_bytes = (size_t)(end - external->offsets[vertices[0]]) * sizeof(unsigned int);
+    }
+
+    return advised;
+}
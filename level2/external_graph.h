@@ -0,0 +1,109 @@
+// MIT License. Copyright (c) 2025 Kshitij Jain
+// See LICENSE file in the root of this repository.
+
+#ifndef _EXTERNAL_GRAPH_H
+#define _EXTERNAL_GRAPH_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "graph.h"
+
+// Semi-external access to a graph cache file, for graphs whose rows
+// do not fit in memory.
+//
+// Only the row offsets, num_vertices + 1 entries, are read into
+// memory. Rows stay in the cache file and are fetched for a sorted
+// run of vertices at a time, either with pread() into a buffer of the
+// caller's or through a read-only mapping. Rows of vertices that are
+// close in the file are fetched together, so a sorted BFS level turns
+// into mostly sequential I/O. Both ways announce the rows ahead of the
+// ones being read to the kernel, which fetches them in the background.
+//
+// Opening checks the header and the offsets, but not the rows, which
+// are never read whole. Searches range check every neighbor ID they
+// read instead.
+
+// Rows less than this many bytes apart are fetched with one read, the
+// bytes between them included.
+//
+#define EXTERNAL_GRAPH_MAX_GAP (64 * 1024)
+
+// Default size of a read buffer. Buffers hold at least max_degree
+// entries, so every row fits in one.
+//
+#define EXTERNAL_GRAPH_BUFFER_BYTES (4 * 1024 * 1024)
+
+struct external_graph {
+    size_t num_vertices;
+    size_t num_edges;
+    size_t max_degree;
+    graph_offset_t * offsets;       // num_vertices + 1 entries, in memory.
+
+    int fd;
+    uint64_t neighbors_position;    // File offset of the neighbors array.
+
+    // Read-only mapping of the whole file, with the kernel's readahead
+    // turned off. neighbors points into it.
+    //
+    void * mapping;
+    size_t mapping_bytes;
+    const unsigned int * neighbors;
+
+    // I/O statistics, updated atomically so that concurrent searches
+    // can share the graph.
+    //
+    size_t reads;
+    size_t bytes_read;
+};
+
+// Opens a graph cache file for semi-external searches.
+// \param path : Path of the cache file, as written by graph_cache_write().
+// Returns a new external graph on success, NULL if the cache is
+// missing or corrupt.
+//
+struct external_graph * external_graph_open(const char * path);
+
+// Closes an external graph and frees all memory associated with it.
+// \param external : Pointer to external graph to close.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool external_graph_close(struct external_graph * external);
+
+// Returns the number of entries a read buffer needs.
+// \param external : Pointer to external graph.
+// Returns size on success, 0 otherwise.
+//
+size_t external_graph_buffer_entries(struct external_graph * external);
+
+// Reads the rows of a prefix of a sorted run of vertices with a single
+// pread(). The prefix ends where the next row is more than
+// EXTERNAL_GRAPH_MAX_GAP bytes away or would not fit in the buffer.
+// The row of a covered vertex v starts at buffer[offsets[v] - *base].
+// \param external       : Pointer to external graph.
+// \param vertices       : Array of count vertices, in increasing order.
+// \param count          : Number of vertices, at least 1.
+// \param buffer         : Read buffer (provided by caller).
+// \param buffer_entries : Size of buffer, see external_graph_buffer_entries().
+// \param base           : Pointer to the edge index of buffer[0]
+//                         (provided by caller).
+// Returns the number of vertices covered, 0 on failure.
+//
+size_t external_graph_read_rows(struct external_graph * external, const unsigned int * vertices,
+                                size_t count, unsigned int * buffer, size_t buffer_entries,
+                                graph_offset_t * base);
+
+// Tells the kernel that the rows of a prefix of a sorted run of
+// vertices will be read soon, through the mapping or with pread().
+// \param external  : Pointer to external graph.
+// \param vertices  : Array of count vertices, in increasing order.
+// \param count     : Number of vertices, at least 1.
+// \param max_bytes : The prefix ends once its rows span this many bytes.
+// \param mapped    : Whether the rows will be read through the mapping.
+// Returns the number of vertices covered, at least 1.
+//
+size_t external_graph_advise(struct external_graph * external, const unsigned int * vertices,
+                             size_t count, size_t max_bytes, bool mapped);
+
+#endif
@@ -0,0 +1,193 @@
+// MIT License. Copyright (c) 2025 Kshitij Jain
+// See LICENSE file in the root of this repository.
+
+#include <stdlib.h>
+
+#include "grail.h"
+
+// Internal utility function that returns the next value of a
+// xorshift64* generator. Visiting orders need not be high quality,
+// only different between traversals.
+//
+static inline uint64_t _grail_random(uint64_t * state) {
+    *state ^= *state >> 12;
+    *state ^= *state << 25;
+    *state ^= *state >> 27;
+    return *state * 0x2545f4914f6cdd1dULL;
+}
+
+// State of one labeling traversal. The DFS is iterative, each open
+// vertex keeps how many of its children it has visited and the random
+// child it started at.
+//
+struct _grail_traversal {
+    unsigned int * roots;           // num_vertices start vertices.
+    unsigned int * stack;
+    graph_offset_t * visited_children;
+    graph_offset_t * first_child;
+    uint8_t * seen;
+};
+
+// Internal utility function that computes one labeling.
+// \param grail     : Pointer to index.
+// \param traversal : Pointer to traversal state.
+// \param label     : Which of the num_labels intervals to fill in.
+// \param random    : Pointer to generator state.
+//
+static void _grail_label(struct grail_index * grail, struct _grail_traversal * traversal,
+                         size_t label, uint64_t * random)
+{
+    const struct graph * dag = grail->dag;
+    size_t num_vertices      = dag->num_vertices;
+    size_t num_labels        = grail->num_labels;
+
+    // Shuffle the start vertices. Starting from a vertex that is not a
+    // root only changes the order, every vertex still finishes after
+    // all the vertices it reaches.
+    //
+    for (size_t v = num_vertices; v > 1; v--) {
+        size_t other                 = (size_t)(_grail_random(random) % v);
+        unsigned int swap            = traversal->roots[v - 1];
+        traversal->roots[v - 1]      = traversal->roots[other];
+        traversal->roots[other]      = swap;
+    }
+    for (size_t v = 0; v < num_vertices; v++) {
+        traversal->seen[v] = 0;
+    }
+
+    uint32_t post = 0;
+    for (size_t r = 0; r < num_vertices; r++) {
+        unsigned int root = traversal->roots[r];
+        if (traversal->seen[root]) {
+            continue;
+        }
+
+        size_t depth = 0;
+        traversal->seen[root]                = 1;
+        traversal->stack[depth]              = root;
+        traversal->visited_children[depth]   = 0;
+        traversal->first_child[depth++]      = (graph_offset_t)_grail_random(random);
+        grail->intervals[(size_t)root * num_labels + label].low = UINT32_MAX;
+
+        while (depth > 0) {
+            unsigned int vertex       = traversal->stack[depth - 1];
+            graph_offset_t begin      = dag->offsets[vertex];
+            graph_offset_t degree     = dag->offsets[vertex + 1] - begin;
+            struct grail_interval * interval = &grail->intervals[(size_t)vertex * num_labels + label];
+
+            if (traversal->visited_children[depth - 1] < degree) {
+                graph_offset_t k = (traversal->first_child[depth - 1]
+                                    + traversal->visited_children[depth - 1]++) % degree;
+                unsigned int child = dag->neighbors[begin + k];
+                if (!traversal->seen[child]) {
+                    traversal->seen[child]             = 1;
+                    traversal->stack[depth]            = child;
+                    traversal->visited_children[depth] = 0;
+                    traversal->first_child[depth++]    = (graph_offset_t)_grail_random(random);
+                    grail->intervals[(size_t)child * num_labels + label].low = UINT32_MAX;
+                } else {
+                    // In a DAG a seen child has already finished.
+                    //
+                    uint32_t low = grail->intervals[(size_t)child * num_labels + label].low;
+                    if (low < interval->low) {
+                        interval->low = low;
+                    }
+                }
+                continue;
+            }
+
+            interval->high = post++;
+            if (interval->high < interval->low) {
+                interval->low = interval->high;
+            }
+            if (--depth > 0) {
+                struct grail_interval * parent =
+                    &grail->intervals[(size_t)traversal->stack[depth - 1] * num_labels + label];
+                if (interval->low < parent->low) {
+                    parent->low = interval->low;
+                }
+            }
+        }
+    }
+}
+
+// Labels a DAG.
+// \param dag        : DAG to label. Must not have cycles.
+// \param num_labels : Number of traversals, 1 to GRAIL_MAX_LABELS.
+// \param seed       : Seed of the random visiting orders.
+// Returns a new index on success, NULL on failure.
+//
+struct grail_index * grail_index_create(struct graph * dag, size_t num_labels, uint64_t seed) {
+    if (dag == NULL || num_labels == 0 || num_labels > GRAIL_MAX_LABELS
+        || dag->num_vertices >= UINT32_MAX) {
+        return NULL;
+    }
+
+    struct grail_index * grail = (struct grail_index*)calloc(1, sizeof(struct grail_index));
+    if (grail == NULL) {
+        return NULL;
+    }
+    grail->dag        = dag;
+    grail->num_labels = num_labels;
+    grail->intervals  = (struct grail_interval*)malloc((dag->num_vertices * num_labels + 1)
+                                                       * sizeof(struct grail_interval));
+
+    size_t num_vertices = dag->num_vertices;
+    struct _grail_traversal traversal;
+    traversal.roots            = (unsigned int*)malloc((num_vertices + 1) * sizeof(unsigned int));
+    traversal.stack            = (unsigned int*)malloc((num_vertices + 1) * sizeof(unsigned int));
+    traversal.visited_children = (graph_offset_t*)malloc((num_vertices + 1) * sizeof(graph_offset_t));
+    traversal.first_child      = (graph_offset_t*)malloc((num_vertices + 1) * sizeof(graph_offset_t));
+    traversal.seen             = (uint8_t*)malloc(num_vertices + 1);
+    bool status = grail->intervals != NULL && traversal.roots != NULL && traversal.stack != NULL
+        && traversal.visited_children != NULL && traversal.first_child != NULL
+        && traversal.seen != NULL;
+
+    if (status) {
+        for (size_t v = 0; v < num_vertices; v++) {
+            traversal.roots[v] = (unsigned int)v;
+        }
+        uint64_t random = seed != 0 ? seed : 0x9e3779b97f4a7c15ULL;
+        for (size_t label = 0; label < num_labels; label++) {
+            _grail_label(grail, &traversal, label, &random);
+        }
+    }
+
+    free(traversal.roots);
+    free(traversal.stack);
+    free(traversal.visited_children);
+    free(traversal.first_child);
+    free(traversal.seen);
+    if (!status) {
+        grail_index_delete(grail);
+        return NULL;
+    }
+    return grail;
+}
+
+// Deletes an index and frees all memory associated with it. The DAG
+// is owned by the caller and is not freed.
+// \param grail : Pointer to index to delete.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool grail_index_delete(struct grail_index * grail) {
+    if (grail == NULL) {
+        return false;
+    }
+
+    free(grail->intervals);
+    free(grail);
+    return true;
+}
+
+// Returns the number of bytes used by the intervals.
+// \param grail : Pointer to index.
+// Returns size on success, SIZE_MAX otherwise.
+//
+size_t grail_index_memory_bytes(struct grail_index * grail) {
+    if (grail == NULL) {
+        return SIZE_MAX;
+    }
+
+    return grail->dag->num_vertices * grail->num_labels * sizeof(struct grail_interval);
+}
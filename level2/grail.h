@@ -0,0 +1,83 @@
+// MIT License. Copyright (c) 2025 Kshitij Jain
+// See LICENSE file in the root of this repository.
+
+#ifndef _GRAIL_H
+#define _GRAIL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "graph.h"
+
+// Randomized interval labels of a DAG, after GRAIL by Yildirim et al.
+//
+// Each of num_labels DFS traversals visits roots and children in a
+// random order and gives every vertex the interval
+//     [smallest post-order rank below it, its own post-order rank]
+// A vertex's interval contains those of all vertices it reaches, in
+// every traversal. So if one interval of the target is not contained
+// in the source's, there is no path, which takes O(num_labels) to
+// tell. Containment in all of them may still be a false positive,
+// and is settled by a search that skips every vertex whose intervals
+// do not contain the target's.
+
+// Upper bound on the labels per vertex.
+//
+#define GRAIL_MAX_LABELS 16
+
+struct grail_interval {
+    uint32_t low;
+    uint32_t high;
+};
+
+struct grail_index {
+    struct graph * dag;             // Owned by the caller.
+    size_t num_labels;
+    struct grail_interval * intervals;  // num_labels per vertex,
+                                        // vertex-major.
+};
+
+// Labels a DAG.
+// \param dag        : DAG to label. Must not have cycles.
+// \param num_labels : Number of traversals, 1 to GRAIL_MAX_LABELS.
+// \param seed       : Seed of the random visiting orders.
+// Returns a new index on success, NULL on failure.
+//
+struct grail_index * grail_index_create(struct graph * dag, size_t num_labels, uint64_t seed);
+
+// Deletes an index and frees all memory associated with it. The DAG
+// is owned by the caller and is not freed.
+// \param grail : Pointer to index to delete.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool grail_index_delete(struct grail_index * grail);
+
+// Returns the number of bytes used by the intervals.
+// \param grail : Pointer to index.
+// Returns size on success, SIZE_MAX otherwise.
+//
+size_t grail_index_memory_bytes(struct grail_index * grail);
+
+// Checks whether the labels allow a path from source to target. This
+// is on the inner loop of pruned searches, so it is inline and does
+// not check its arguments.
+// \param grail  : Pointer to index.
+// \param source : DAG vertex to start from.
+// \param target : DAG vertex to look for.
+// Returns FALSE if there is no path, TRUE if there may be one.
+//
+static inline bool grail_index_may_reach(const struct grail_index * grail, unsigned int source,
+                                         unsigned int target)
+{
+    const struct grail_interval * outer = grail->intervals + (size_t)source * grail->num_labels;
+    const struct grail_interval * inner = grail->intervals + (size_t)target * grail->num_labels;
+    for (size_t i = 0; i < grail->num_labels; i++) {
+        if (inner[i].low < outer[i].low || inner[i].high > outer[i].high) {
+            return false;
+        }
+    }
+    return true;
+}
+
+#endif
@@ -0,0 +1,423 @@
+// MIT License. Copyright (c) 2025 Kshitij Jain
+// See LICENSE file in the root of this repository.
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#include "graph.h"
+
+// Work shared by the threads of a parallel CSR build. Thread t owns
+// edges [edge_begin(t), edge_begin(t + 1)) and vertices
+// [vertex_begin(t), vertex_begin(t + 1)).
+//
+struct graph_build {
+    struct graph * graph;
+    const unsigned int * sources;
+    const unsigned int * targets;
+    size_t num_threads;
+
+    // counts[t * num_vertices + v] is the number of edges from v in
+    // thread t's edge range. After _graph_build_rows() it is the slot
+    // within row v where thread t places its first such edge.
+    //
+    graph_offset_t * counts;
+
+    // Sum of the out-degrees of each thread's vertex range.
+    //
+    uint64_t * block_edges;
+    bool * out_of_range;
+};
+
+struct graph_build_task {
+    struct graph_build * build;
+    size_t thread;
+};
+
+static size_t _graph_build_begin(size_t total, size_t num_threads, size_t thread) {
+    return (size_t)((uint64_t)total * thread / num_threads);
+}
+
+// Internal utility function that runs one phase of the build on every
+// thread and waits for all of them. Threads that cannot be started
+// run on the calling thread instead.
+// \param build : Pointer to shared build state.
+// \param phase : Function to run once per thread.
+//
+static void _graph_build_run(struct graph_build * build, void * (*phase)(void*)) {
+    pthread_t threads[GRAPH_MAX_BUILD_THREADS];
+    bool started[GRAPH_MAX_BUILD_THREADS];
+    struct graph_build_task tasks[GRAPH_MAX_BUILD_THREADS];
+
+    for (size_t t = 0; t < build->num_threads; t++) {
+        tasks[t].build  = build;
+        tasks[t].thread = t;
+        started[t] = t > 0 && pthread_create(&threads[t], NULL, phase, &tasks[t]) == 0;
+    }
+    for (size_t t = 0; t < build->num_threads; t++) {
+        if (!started[t]) {
+            phase(&tasks[t]);
+        }
+    }
+    for (size_t t = 1; t < build->num_threads; t++) {
+        if (started[t]) {
+            pthread_join(threads[t], NULL);
+        }
+    }
+}
+
+// Phase 1: each thread counts the out-degrees of its edge range into
+// a private row of counts, so no two threads write the same counter.
+//
+static void * _graph_build_count(void * arg) {
+    struct graph_build_task * task = (struct graph_build_task*)arg;
+    struct graph_build * build     = task->build;
+    size_t num_vertices            = build->graph->num_vertices;
+    size_t num_edges               = build->graph->num_edges;
+    graph_offset_t * counts        = build->counts + task->thread * num_vertices;
+
+    size_t begin = _graph_build_begin(num_edges, build->num_threads, task->thread);
+    size_t end   = _graph_build_begin(num_edges, build->num_threads, task->thread + 1);
+    for (size_t k = begin; k < end; k++) {
+        if (build->sources[k] >= num_vertices || build->targets[k] >= num_vertices) {
+            build->out_of_range[task->thread] = true;
+            return NULL;
+        }
+        ++counts[build->sources[k]];
+    }
+    return NULL;
+}
+
+// Phase 2: for its vertex range, each thread turns the per-thread
+// counts of a row into per-thread starting slots within the row and
+// stores the row's degree in offsets[v + 1].
+//
+static void * _graph_build_rows(void * arg) {
+    struct graph_build_task * task = (struct graph_build_task*)arg;
+    struct graph_build * build     = task->build;
+    struct graph * graph           = build->graph;
+    size_t num_vertices            = graph->num_vertices;
+
+    size_t begin = _graph_build_begin(num_vertices, build->num_threads, task->thread);
+    size_t end   = _graph_build_begin(num_vertices, build->num_threads, task->thread + 1);
+    uint64_t block_edges = 0;
+    for (size_t v = begin; v < end; v++) {
+        graph_offset_t degree = 0;
+        for (size_t t = 0; t < build->num_threads; t++) {
+            graph_offset_t count = build->counts[t * num_vertices + v];
+            build->counts[t * num_vertices + v] = degree;
+            degree += count;
+        }
+        graph->offsets[v + 1] = degree;
+        block_edges += degree;
+    }
+    build->block_edges[task->thread] = block_edges;
+    return NULL;
+}
+
+// Phase 3: each thread prefix sums its vertex range, starting from the
+// total degree of the ranges before it.
+//
+static void * _graph_build_prefix(void * arg) {
+    struct graph_build_task * task = (struct graph_build_task*)arg;
+    struct graph_build * build     = task->build;
+    struct graph * graph           = build->graph;
+
+    size_t begin = _graph_build_begin(graph->num_vertices, build->num_threads, task->thread);
+    size_t end   = _graph_build_begin(graph->num_vertices, build->num_threads, task->thread + 1);
+    graph_offset_t running = 0;
+    for (size_t t = 0; t < task->thread; t++) {
+        running += (graph_offset_t)build->block_edges[t];
+    }
+    for (size_t v = begin; v < end; v++) {
+        running += graph->offsets[v + 1];
+        graph->offsets[v + 1] = running;
+    }
+    return NULL;
+}
+
+// Phase 4: each thread scatters its edge range. Thread t's edges from
+// v land after those of threads 0 ... t - 1, so rows keep edge list
+// order regardless of the thread count.
+//
+static void * _graph_build_scatter(void * arg) {
+    struct graph_build_task * task = (struct graph_build_task*)arg;
+    struct graph_build * build     = task->build;
+    struct graph * graph           = build->graph;
+    graph_offset_t * counts        = build->counts + task->thread * graph->num_vertices;
+
+    size_t begin = _graph_build_begin(graph->num_edges, build->num_threads, task->thread);
+    size_t end   = _graph_build_begin(graph->num_edges, build->num_threads, task->thread + 1);
+    for (size_t k = begin; k < end; k++) {
+        unsigned int source = build->sources[k];
+        graph->neighbors[graph->offsets[source] + counts[source]++] = build->targets[k];
+    }
+    return NULL;
+}
+
+// Builds a CSR graph from an edge list. Edge k goes from sources[k]
+// to targets[k]. Neighbors of a vertex keep their edge list order.
+// \param num_vertices : Vertex IDs must be less than this.
+// \param sources      : Array of num_edges source vertices.
+// \param targets      : Array of num_edges target vertices.
+// \param num_edges    : Number of edges.
+// \param num_threads  : Number of threads to build with, at most
+//                       GRAPH_MAX_BUILD_THREADS. 0 means 1.
+// Returns a new graph on success, NULL on failure.
+//
+struct graph * graph_create_from_edges(size_t num_vertices,
+                                       const unsigned int * sources,
+                                       const unsigned int * targets,
+                                       size_t num_edges,
+                                       size_t num_threads)
+{
+    if (num_edges > 0 && (sources == NULL || targets == NULL)) {
+        return NULL;
+    }
+
+    if ((uint64_t)num_edges > GRAPH_MAX_EDGES) {
+        printf("Graph has %zu edges, rebuild with -DGRAPH_64BIT_OFFSETS.\n", num_edges);
+        return NULL;
+    }
+
+    if (num_threads == 0) {
+        num_threads = 1;
+    }
+    if (num_threads > GRAPH_MAX_BUILD_THREADS) {
+        num_threads = GRAPH_MAX_BUILD_THREADS;
+    }
+
+    // Every thread needs a counter per vertex. Past the point where the
+    // counters outgrow the edge list itself, more threads cost more
+    // memory traffic than they save.
+    //
+    while (num_threads > 1 && (uint64_t)num_threads * num_vertices > 2 * (uint64_t)num_edges) {
+        --num_threads;
+    }
+
+    struct graph * graph = (struct graph*)malloc(sizeof(struct graph));
+    if (graph == NULL) {
+        return NULL;
+    }
+
+    graph->num_vertices  = num_vertices;
+    graph->num_edges     = num_edges;
+    graph->vertex_ids    = NULL;
+    graph->original_ids  = NULL;
+    graph->mapping       = NULL;
+    graph->mapping_bytes = 0;
+    graph->offsets      = (graph_offset_t*)malloc((num_vertices + 1) * sizeof(graph_offset_t));
+    graph->neighbors    = (unsigned int*)malloc((num_edges + 1) * sizeof(unsigned int));
+
+    // Counting sort by source, split across threads: count degrees,
+    // turn them into row starts, then scatter each edge.
+    //
+    struct graph_build build;
+    build.graph        = graph;
+    build.sources      = sources;
+    build.targets      = targets;
+    build.num_threads  = num_threads;
+    build.counts       = (graph_offset_t*)calloc(num_threads * num_vertices + 1, sizeof(graph_offset_t));
+    build.block_edges  = (uint64_t*)calloc(num_threads, sizeof(uint64_t));
+    build.out_of_range = (bool*)calloc(num_threads, sizeof(bool));
+    if (graph->offsets == NULL || graph->neighbors == NULL || build.counts == NULL
+        || build.block_edges == NULL || build.out_of_range == NULL) {
+        graph_delete(graph);
+        graph = NULL;
+        goto out;
+    }
+
+    _graph_build_run(&build, _graph_build_count);
+    for (size_t t = 0; t < num_threads; t++) {
+        if (build.out_of_range[t]) {
+            printf("Edge list has a vertex out of range for %zu vertices.\n", num_vertices);
+            graph_delete(graph);
+            graph = NULL;
+            goto out;
+        }
+    }
+
+    graph->offsets[0] = 0;
+    _graph_build_run(&build, _graph_build_rows);
+    _graph_build_run(&build, _graph_build_prefix);
+    _graph_build_run(&build, _graph_build_scatter);
+
+out:
+    free(build.counts);
+    free(build.block_edges);
+    free(build.out_of_range);
+    return graph;
+}
+
+// Internal utility function that gives a graph its own copy of a
+// relabeling.
+// \param graph        : Graph to copy into, built by graph_create_from_edges().
+// \param vertex_ids   : Relabeling to copy, or NULL for none.
+// \param original_ids : Inverse of vertex_ids.
+// Returns TRUE on success, FALSE otherwise.
+//
+static bool _graph_copy_ids(struct graph * graph, const unsigned int * vertex_ids,
+                            const unsigned int * original_ids)
+{
+    if (vertex_ids == NULL) {
+        return true;
+    }
+
+    size_t bytes = (graph->num_vertices + 1) * sizeof(unsigned int);
+    graph->vertex_ids   = (unsigned int*)malloc(bytes);
+    graph->original_ids = (unsigned int*)malloc(bytes);
+    if (graph->vertex_ids == NULL || graph->original_ids == NULL) {
+        return false;
+    }
+    memcpy(graph->vertex_ids, vertex_ids, graph->num_vertices * sizeof(unsigned int));
+    memcpy(graph->original_ids, original_ids, graph->num_vertices * sizeof(unsigned int));
+    return true;
+}
+
+// Builds the transpose of a graph, which holds every edge reversed.
+// Row v of the transpose lists the in-neighbors of v in the original
+// graph, in increasing order. The transpose keeps the vertex IDs, and
+// with them the relabeling, of the graph.
+// \param graph       : Graph to transpose.
+// \param num_threads : Number of threads to build with. 0 means 1.
+// Returns a new graph on success, NULL on failure.
+//
+struct graph * graph_create_transpose(struct graph * graph, size_t num_threads) {
+    if (graph == NULL) {
+        return NULL;
+    }
+
+    // Expand the row starts into the source of every edge, then build
+    // from the edge list with sources and targets swapped.
+    //
+    unsigned int * sources = (unsigned int*)malloc((graph->num_edges + 1) * sizeof(unsigned int));
+    if (sources == NULL) {
+        return NULL;
+    }
+    for (size_t v = 0; v < graph->num_vertices; v++) {
+        for (graph_offset_t edge = graph->offsets[v]; edge < graph->offsets[v + 1]; edge++) {
+            sources[edge] = (unsigned int)v;
+        }
+    }
+
+    struct graph * transpose = graph_create_from_edges(graph->num_vertices, graph->neighbors,
+                                                       sources, graph->num_edges, num_threads);
+    free(sources);
+    if (transpose != NULL && !_graph_copy_ids(transpose, graph->vertex_ids, graph->original_ids)) {
+        graph_delete(transpose);
+        return NULL;
+    }
+    return transpose;
+}
+
+// Builds a copy of a graph with its vertices relabeled, so that vertex
+// v of the input becomes vertex permutation[v]. Rows keep their order.
+// The relabeling composes with any the input already carries, so
+// graph_vertex_id() of the result still takes the input's original IDs.
+// \param graph       : Graph to relabel.
+// \param permutation : Array of num_vertices distinct new IDs.
+// \param num_threads : Number of threads to build with. 0 means 1.
+// Returns a new graph on success, NULL on failure.
+//
+struct graph * graph_create_permuted(struct graph * graph, const unsigned int * permutation,
+                                     size_t num_threads)
+{
+    if (graph == NULL || permutation == NULL) {
+        return NULL;
+    }
+
+    size_t num_vertices    = graph->num_vertices;
+    unsigned int * inverse = (unsigned int*)malloc((num_vertices + 1) * sizeof(unsigned int));
+    unsigned int * forward = (unsigned int*)malloc((num_vertices + 1) * sizeof(unsigned int));
+    unsigned int * sources = (unsigned int*)calloc(graph->num_edges + 1, sizeof(unsigned int));
+    unsigned int * targets = (unsigned int*)calloc(graph->num_edges + 1, sizeof(unsigned int));
+    struct graph * permuted = NULL;
+    if (inverse == NULL || forward == NULL || sources == NULL || targets == NULL) {
+        goto out;
+    }
+
+    // A repeated or out of range ID would silently merge two rows, so
+    // the permutation is checked before any edge is relabeled.
+    //
+    memset(inverse, 0xff, num_vertices * sizeof(unsigned int));
+    for (size_t v = 0; v < num_vertices; v++) {
+        if (permutation[v] >= num_vertices || inverse[permutation[v]] != UINT32_MAX) {
+            printf("Vertex relabeling is not a permutation of %zu vertices.\n", num_vertices);
+            goto out;
+        }
+        inverse[permutation[v]] = (unsigned int)v;
+    }
+
+    // Edges are listed by old source, so each new row receives its
+    // edges in the order of the old row.
+    //
+    for (size_t v = 0; v < num_vertices; v++) {
+        for (graph_offset_t edge = graph->offsets[v]; edge < graph->offsets[v + 1]; edge++) {
+            sources[edge] = permutation[v];
+            targets[edge] = permutation[graph->neighbors[edge]];
+        }
+    }
+
+    permuted = graph_create_from_edges(num_vertices, sources, targets, graph->num_edges, num_threads);
+    if (permuted == NULL) {
+        goto out;
+    }
+
+    // Compose with the input's relabeling: an original ID maps to
+    // graph's ID, then through permutation.
+    //
+    for (size_t original = 0; original < num_vertices; original++) {
+        unsigned int vertex = graph_vertex_id(graph, (unsigned int)original);
+        forward[original]   = permutation[vertex];
+    }
+    for (size_t v = 0; v < num_vertices; v++) {
+        inverse[v] = graph_original_id(graph, inverse[v]);
+    }
+    permuted->vertex_ids   = forward;
+    permuted->original_ids = inverse;
+    forward = NULL;
+    inverse = NULL;
+
+out:
+    free(inverse);
+    free(forward);
+    free(sources);
+    free(targets);
+    return permuted;
+}
+
+// Deletes a graph and frees all memory associated with it.
+// \param graph : Pointer to graph to delete.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool graph_delete(struct graph * graph) {
+    if (graph == NULL) {
+        return false;
+    }
+
+    if (graph->mapping != NULL) {
+        munmap(graph->mapping, graph->mapping_bytes);
+    } else {
+        free(graph->offsets);
+        free(graph->neighbors);
+        free(graph->vertex_ids);
+        free(graph->original_ids);
+    }
+    free(graph);
+    return true;
+}
+
+// Returns the number of bytes used by the offsets and neighbors arrays.
+// \param graph : Pointer to graph.
+// Returns size on success, SIZE_MAX otherwise.
+//
+size_t graph_memory_bytes(struct graph * graph) {
+    if (graph == NULL) {
+        return SIZE_MAX;
+    }
+
+    return (graph->num_vertices + 1) * sizeof(graph_offset_t)
+           + graph->num_edges * sizeof(unsigned int);
+}
@@ -0,0 +1,127 @@
+// MIT License. Copyright (c) 2025 Kshitij Jain
+// See LICENSE file in the root of this repository.
+
+#ifndef _GRAPH_H
+#define _GRAPH_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Width of the CSR offsets array. 32 bits address up to 4G edges,
+// which covers the Wikipedia matrix with half the offset memory.
+// Build with -DGRAPH_64BIT_OFFSETS for larger graphs.
+//
+#ifdef GRAPH_64BIT_OFFSETS
+typedef uint64_t graph_offset_t;
+#define GRAPH_MAX_EDGES UINT64_MAX
+#else
+typedef uint32_t graph_offset_t;
+#define GRAPH_MAX_EDGES UINT32_MAX
+#endif
+
+// Upper bound on the threads graph_create_from_edges() uses.
+//
+#define GRAPH_MAX_BUILD_THREADS 256
+
+// A directed graph in compressed sparse row (CSR) form.
+//
+// The out-neighbors of vertex v are
+//     neighbors[offsets[v]] ... neighbors[offsets[v + 1] - 1]
+// so a neighbor scan is a single streaming read.
+//
+struct graph {
+    size_t num_vertices;
+    size_t num_edges;
+    graph_offset_t* offsets;    // num_vertices + 1 entries.
+    unsigned int* neighbors;    // num_edges entries.
+
+    // Relabeling applied by graph_create_permuted(), NULL while vertices
+    // keep the IDs of the input. vertex_ids[original] is the ID of a
+    // vertex in this graph and original_ids[v] is its inverse, both
+    // num_vertices entries.
+    //
+    unsigned int* vertex_ids;
+    unsigned int* original_ids;
+
+    // Non-NULL when the arrays above point into a read-only
+    // mmap()ed graph cache rather than into malloc()ed memory.
+    //
+    void* mapping;
+    size_t mapping_bytes;
+};
+
+// Builds a CSR graph from an edge list. Edge k goes from sources[k]
+// to targets[k]. Neighbors of a vertex keep their edge list order.
+// \param num_vertices : Vertex IDs must be less than this.
+// \param sources      : Array of num_edges source vertices.
+// \param targets      : Array of num_edges target vertices.
+// \param num_edges    : Number of edges.
+// \param num_threads  : Number of threads to build with, at most
+//                       GRAPH_MAX_BUILD_THREADS. 0 means 1.
+// Returns a new graph on success, NULL on failure.
+//
+struct graph * graph_create_from_edges(size_t num_vertices,
+                                       const unsigned int * sources,
+                                       const unsigned int * targets,
+                                       size_t num_edges,
+                                       size_t num_threads);
+
+// Builds the transpose of a graph, which holds every edge reversed.
+// Row v of the transpose lists the in-neighbors of v in the original
+// graph, in increasing order. The transpose keeps the vertex IDs, and
+// with them the relabeling, of the graph.
+// \param graph       : Graph to transpose.
+// \param num_threads : Number of threads to build with. 0 means 1.
+// Returns a new graph on success, NULL on failure.
+//
+struct graph * graph_create_transpose(struct graph * graph, size_t num_threads);
+
+// Builds a copy of a graph with its vertices relabeled, so that vertex
+// v of the input becomes vertex permutation[v]. Rows keep their order.
+// The relabeling composes with any the input already carries, so
+// graph_vertex_id() of the result still takes the input's original IDs.
+// \param graph       : Graph to relabel.
+// \param permutation : Array of num_vertices distinct new IDs.
+// \param num_threads : Number of threads to build with. 0 means 1.
+// Returns a new graph on success, NULL on failure.
+//
+struct graph * graph_create_permuted(struct graph * graph, const unsigned int * permutation,
+                                     size_t num_threads);
+
+// Deletes a graph and frees all memory associated with it.
+// \param graph : Pointer to graph to delete.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool graph_delete(struct graph * graph);
+
+// Returns the number of bytes used by the offsets and neighbors arrays.
+// \param graph : Pointer to graph.
+// Returns size on success, SIZE_MAX otherwise.
+//
+size_t graph_memory_bytes(struct graph * graph);
+
+// Translates an input vertex ID into the ID it has in a graph. IDs
+// out of range are returned unchanged.
+// \param graph    : Pointer to graph.
+// \param original : Vertex ID as given in the input.
+//
+static inline unsigned int graph_vertex_id(const struct graph * graph, unsigned int original) {
+    if (graph->vertex_ids == NULL || original >= graph->num_vertices) {
+        return original;
+    }
+    return graph->vertex_ids[original];
+}
+
+// Translates a vertex ID of a graph back into its input vertex ID.
+// \param graph  : Pointer to graph.
+// \param vertex : Vertex ID in graph.
+//
+static inline unsigned int graph_original_id(const struct graph * graph, unsigned int vertex) {
+    if (graph->original_ids == NULL || vertex >= graph->num_vertices) {
+        return vertex;
+    }
+    return graph->original_ids[vertex];
+}
+
+#endif
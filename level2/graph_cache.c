@@ -0,0 +1,348 @@
+// MIT License. Copyright (c) 2025 Kshitij Jain
+// See LICENSE file in the root of this repository.
+
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "graph_cache.h"
+
+// Internal utility function that rounds a file position up to the
+// next array boundary.
+// \param position : Position to round.
+// Returns the aligned position.
+//
+static uint64_t _graph_cache_align(uint64_t position) {
+    return (position + GRAPH_CACHE_ALIGNMENT - 1) & ~(uint64_t)(GRAPH_CACHE_ALIGNMENT - 1);
+}
+
+// Internal utility function that checks that an array lies inside a
+// file, without the size arithmetic wrapping around.
+// \param position      : File offset of the array.
+// \param count         : Number of elements.
+// \param element_bytes : Size of an element.
+// \param file_bytes    : Size of the file.
+// Returns TRUE if the array fits, FALSE otherwise.
+//
+static bool _graph_cache_array_fits(uint64_t position, uint64_t count, uint64_t element_bytes,
+                                    uint64_t file_bytes)
+{
+    uint64_t bytes, end;
+    return !__builtin_mul_overflow(count, element_bytes, &bytes)
+        && !__builtin_add_overflow(position, bytes, &end)
+        && end <= file_bytes;
+}
+
+// Internal utility function that folds a byte range into a running
+// checksum, eight bytes at a time.
+// \param checksum : Running checksum.
+// \param data     : Bytes to fold in.
+// \param bytes    : Number of bytes.
+// Returns the updated checksum.
+//
+static uint64_t _graph_cache_checksum(uint64_t checksum, const void * data, size_t bytes) {
+    const unsigned char * p = (const unsigned char*)data;
+    size_t words = bytes / sizeof(uint64_t);
+
+    for (size_t i = 0; i < words; i++) {
+        uint64_t word;
+        memcpy(&word, p + i * sizeof(uint64_t), sizeof(uint64_t));
+        checksum = (checksum ^ word) * 0x100000001b3ULL;
+        checksum ^= checksum >> 29;
+    }
+    for (size_t i = words * sizeof(uint64_t); i < bytes; i++) {
+        checksum = (checksum ^ p[i]) * 0x100000001b3ULL;
+    }
+
+    return checksum;
+}
+
+// Internal utility function that checksums a graph's arrays.
+// \param graph : Pointer to graph.
+// Returns the checksum.
+//
+static uint64_t _graph_cache_graph_checksum(struct graph * graph) {
+    uint64_t checksum = 0xcbf29ce484222325ULL;
+    checksum = _graph_cache_checksum(checksum, graph->offsets,
+                                     (graph->num_vertices + 1) * sizeof(graph_offset_t));
+    checksum = _graph_cache_checksum(checksum, graph->neighbors,
+                                     graph->num_edges * sizeof(unsigned int));
+    if (graph->vertex_ids != NULL) {
+        checksum = _graph_cache_checksum(checksum, graph->vertex_ids,
+                                         graph->num_vertices * sizeof(unsigned int));
+        checksum = _graph_cache_checksum(checksum, graph->original_ids,
+                                         graph->num_vertices * sizeof(unsigned int));
+    }
+    return checksum;
+}
+
+// Internal utility function that checks that every neighbor ID, and
+// every relabeling entry, names a vertex of the graph.
+// \param graph : Pointer to graph.
+// Returns TRUE if all IDs are in range, FALSE otherwise.
+//
+static bool _graph_cache_neighbors_check(struct graph * graph) {
+    unsigned int out_of_range = 0;
+    for (size_t e = 0; e < graph->num_edges; e++) {
+        out_of_range |= graph->neighbors[e] >= graph->num_vertices;
+    }
+    for (size_t v = 0; graph->vertex_ids != NULL && v < graph->num_vertices; v++) {
+        out_of_range |= graph->vertex_ids[v] >= graph->num_vertices;
+        out_of_range |= graph->original_ids[v] >= graph->num_vertices;
+    }
+    return out_of_range == 0;
+}
+
+// Internal utility function that writes a whole buffer at a position.
+// \param fd       : File descriptor.
+// \param data     : Bytes to write.
+// \param bytes    : Number of bytes.
+// \param position : File offset to write at.
+// Returns TRUE on success, FALSE otherwise.
+//
+static bool _graph_cache_pwrite_all(int fd, const void * data, size_t bytes, uint64_t position) {
+    const char * p = (const char*)data;
+    while (bytes > 0) {
+        ssize_t written = pwrite(fd, p, bytes, (off_t)position);
+        if (written <= 0) {
+            return false;
+        }
+        p        += written;
+        bytes    -= (size_t)written;
+        position += (uint64_t)written;
+    }
+    return true;
+}
+
+// Computes the fingerprint of a file from its size and mtime.
+// \param path        : Path of the file.
+// \param fingerprint : Pointer to fingerprint (provided by caller).
+// Returns TRUE on success, FALSE otherwise.
+//
+bool graph_fingerprint_file(const char * path,
+                            struct graph_fingerprint * fingerprint)
+{
+    struct stat st;
+    if (path == NULL || fingerprint == NULL || stat(path, &st) != 0) {
+        return false;
+    }
+
+    memset(fingerprint, 0, sizeof(struct graph_fingerprint));
+    fingerprint->size       = (uint64_t)st.st_size;
+    fingerprint->mtime_sec  = (int64_t)st.st_mtim.tv_sec;
+    fingerprint->mtime_nsec = (int64_t)st.st_mtim.tv_nsec;
+    return true;
+}
+
+// Writes a graph to a cache file. The file is written under a
+// temporary name and renamed into place, so readers never observe a
+// partial cache.
+// \param path   : Path of the cache file.
+// \param graph  : Graph to write.
+// \param source : Fingerprint of the file the graph was parsed from.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool graph_cache_write(const char * path,
+                       struct graph * graph,
+                       const struct graph_fingerprint * source)
+{
+    if (path == NULL || graph == NULL || source == NULL) {
+        return false;
+    }
+
+    struct graph_cache_header header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, GRAPH_CACHE_MAGIC, sizeof(header.magic));
+    header.version            = GRAPH_CACHE_VERSION;
+    header.offset_bytes       = sizeof(graph_offset_t);
+    header.num_vertices       = graph->num_vertices;
+    header.num_edges          = graph->num_edges;
+    header.offsets_position   = _graph_cache_align(sizeof(header));
+    header.neighbors_position = _graph_cache_align(header.offsets_position
+                                    + (graph->num_vertices + 1) * sizeof(graph_offset_t));
+    if (graph->vertex_ids != NULL) {
+        header.vertex_ids_position   = _graph_cache_align(header.neighbors_position
+                                           + graph->num_edges * sizeof(unsigned int));
+        header.original_ids_position = _graph_cache_align(header.vertex_ids_position
+                                           + graph->num_vertices * sizeof(unsigned int));
+    }
+    header.checksum           = _graph_cache_graph_checksum(graph);
+    header.source             = *source;
+
+    char tmp_path[4096];
+    if (snprintf(tmp_path, sizeof(tmp_path), "%s.tmp.%ld", path, (long)getpid())
+        >= (int)sizeof(tmp_path)) {
+        return false;
+    }
+
+    int fd = open(tmp_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+
+    bool status = _graph_cache_pwrite_all(fd, &header, sizeof(header), 0)
+        && _graph_cache_pwrite_all(fd, graph->offsets,
+                                   (graph->num_vertices + 1) * sizeof(graph_offset_t),
+                                   header.offsets_position)
+        && _graph_cache_pwrite_all(fd, graph->neighbors,
+                                   graph->num_edges * sizeof(unsigned int),
+                                   header.neighbors_position)
+        && (graph->vertex_ids == NULL
+            || (_graph_cache_pwrite_all(fd, graph->vertex_ids,
+                                        graph->num_vertices * sizeof(unsigned int),
+                                        header.vertex_ids_position)
+                && _graph_cache_pwrite_all(fd, graph->original_ids,
+                                           graph->num_vertices * sizeof(unsigned int),
+                                           header.original_ids_position)))
+        && fsync(fd) == 0;
+    status = (close(fd) == 0) && status;
+
+    if (!status || rename(tmp_path, path) != 0) {
+        unlink(tmp_path);
+        return false;
+    }
+
+    return true;
+}
+
+// Checks that a cache header describes arrays that fit in its file
+// and that the cache was built from the expected source.
+// \param header     : Header read from the start of the file.
+// \param file_bytes : Size of the file.
+// \param source     : Expected source fingerprint, or NULL to skip the check.
+// Returns TRUE if the header is valid, FALSE otherwise.
+//
+bool graph_cache_header_check(const struct graph_cache_header * header, uint64_t file_bytes,
+                              const struct graph_fingerprint * source)
+{
+    if (header == NULL || file_bytes < sizeof(struct graph_cache_header)) {
+        return false;
+    }
+
+    uint64_t num_offsets;
+    bool relabeled = header->vertex_ids_position != 0;
+    bool valid = memcmp(header->magic, GRAPH_CACHE_MAGIC, sizeof(header->magic)) == 0
+        && header->version == GRAPH_CACHE_VERSION
+        && header->offset_bytes == sizeof(graph_offset_t)
+        && header->num_vertices <= UINT_MAX
+        && header->num_edges <= GRAPH_MAX_EDGES
+        && !__builtin_add_overflow(header->num_vertices, 1, &num_offsets)
+        && header->offsets_position % GRAPH_CACHE_ALIGNMENT == 0
+        && header->neighbors_position % GRAPH_CACHE_ALIGNMENT == 0
+        && _graph_cache_array_fits(header->offsets_position, num_offsets,
+                                   sizeof(graph_offset_t), file_bytes)
+        && _graph_cache_array_fits(header->neighbors_position, header->num_edges,
+                                   sizeof(unsigned int), file_bytes)
+        && (!relabeled
+            || (header->vertex_ids_position % GRAPH_CACHE_ALIGNMENT == 0
+                && header->original_ids_position % GRAPH_CACHE_ALIGNMENT == 0
+                && _graph_cache_array_fits(header->vertex_ids_position, header->num_vertices,
+                                           sizeof(unsigned int), file_bytes)
+                && _graph_cache_array_fits(header->original_ids_position, header->num_vertices,
+                                           sizeof(unsigned int), file_bytes)));
+    if (valid && source != NULL) {
+        valid = header->source.size == source->size
+            && header->source.mtime_sec == source->mtime_sec
+            && header->source.mtime_nsec == source->mtime_nsec;
+    }
+    return valid;
+}
+
+// Checks that CSR offsets describe rows that tile the neighbors
+// array: they start at 0, never decrease and end at num_edges.
+// \param offsets      : Array of num_vertices + 1 offsets.
+// \param num_vertices : Number of vertices.
+// \param num_edges    : Number of edges.
+// Returns TRUE if the offsets are valid, FALSE otherwise.
+//
+bool graph_cache_offsets_check(const graph_offset_t * offsets, size_t num_vertices, size_t num_edges) {
+    if (offsets == NULL || offsets[0] != 0 || offsets[num_vertices] != num_edges) {
+        return false;
+    }
+    for (size_t v = 0; v < num_vertices; v++) {
+        if (offsets[v + 1] < offsets[v]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Maps a cache file read-only and returns a graph backed by it.
+// \param path            : Path of the cache file.
+// \param source          : Expected source fingerprint, or NULL to skip the check.
+// \param verify_checksum : Whether to checksum the arrays. Neighbor
+//                          IDs are always range checked, so this only
+//                          guards against flipped bits that stay in
+//                          range.
+// Returns a new graph on success, NULL if the cache is missing, stale
+// or corrupt. Free it with graph_delete().
+//
+struct graph * graph_cache_map(const char * path,
+                               const struct graph_fingerprint * source,
+                               bool verify_checksum)
+{
+    if (path == NULL) {
+        return NULL;
+    }
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return NULL;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(struct graph_cache_header)) {
+        close(fd);
+        return NULL;
+    }
+
+    size_t bytes = (size_t)st.st_size;
+    void * mapping = mmap(NULL, bytes, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        return NULL;
+    }
+
+    const struct graph_cache_header * header = (const struct graph_cache_header*)mapping;
+    bool valid     = graph_cache_header_check(header, bytes, source);
+    bool relabeled = header->vertex_ids_position != 0;
+
+    struct graph * graph = valid ? (struct graph*)malloc(sizeof(struct graph)) : NULL;
+    if (graph == NULL) {
+        munmap(mapping, bytes);
+        return NULL;
+    }
+
+    graph->num_vertices  = header->num_vertices;
+    graph->num_edges     = header->num_edges;
+    graph->offsets       = (graph_offset_t*)((char*)mapping + header->offsets_position);
+    graph->neighbors     = (unsigned int*)((char*)mapping + header->neighbors_position);
+    graph->vertex_ids    = relabeled ? (unsigned int*)((char*)mapping + header->vertex_ids_position) : NULL;
+    graph->original_ids  = relabeled ? (unsigned int*)((char*)mapping + header->original_ids_position) : NULL;
+    graph->mapping       = mapping;
+    graph->mapping_bytes = bytes;
+
+    // Rows must tile the neighbors array, and every ID must name a
+    // vertex, or a search would read past the offsets or the visited
+    // set. Searches trust the IDs, so they are checked on every map;
+    // one streaming pass is cheap next to a parse.
+    //
+    if (!graph_cache_offsets_check(graph->offsets, graph->num_vertices, graph->num_edges)
+        || !_graph_cache_neighbors_check(graph)) {
+        graph_delete(graph);
+        return NULL;
+    }
+
+    if (verify_checksum && _graph_cache_graph_checksum(graph) != header->checksum) {
+        printf("Graph cache %s failed checksum verification.\n", path);
+        graph_delete(graph);
+        return NULL;
+    }
+
+    return graph;
+}
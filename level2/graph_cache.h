@@ -0,0 +1,105 @@
+// MIT License. Copyright (c) 2025 Kshitij Jain
+// See LICENSE file in the root of this repository.
+
+#ifndef _GRAPH_CACHE_H
+#define _GRAPH_CACHE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "graph.h"
+
+// Binary on-disk form of a CSR graph, written once after a Matrix
+// Market file has been parsed and mmap()ed read-only afterwards.
+// Loading is then bounded by page cache speed, and every process
+// mapping the same file shares one copy of it.
+//
+// Layout, all integers little endian as written by the host:
+//     struct graph_cache_header        (padded to GRAPH_CACHE_ALIGNMENT)
+//     graph_offset_t offsets[num_vertices + 1]
+//     unsigned int   neighbors[num_edges]
+//     unsigned int   vertex_ids[num_vertices]      (relabeled graphs only)
+//     unsigned int   original_ids[num_vertices]    (relabeled graphs only)
+// Each array starts on a GRAPH_CACHE_ALIGNMENT boundary.
+
+#define GRAPH_CACHE_MAGIC     "PWCSR\0\0"
+#define GRAPH_CACHE_VERSION   2
+#define GRAPH_CACHE_ALIGNMENT 4096
+
+// Identifies the source file a cache was built from. A cache whose
+// fingerprint does not match the source is stale and is rebuilt.
+//
+struct graph_fingerprint {
+    uint64_t size;
+    int64_t  mtime_sec;
+    int64_t  mtime_nsec;
+};
+
+struct graph_cache_header {
+    char     magic[8];
+    uint32_t version;
+    uint32_t offset_bytes;          // sizeof(graph_offset_t) of the writer.
+    uint64_t num_vertices;
+    uint64_t num_edges;
+    uint64_t offsets_position;      // File offset of the offsets array.
+    uint64_t neighbors_position;    // File offset of the neighbors array.
+    uint64_t vertex_ids_position;   // File offsets of the relabeling
+    uint64_t original_ids_position; // arrays, 0 if the graph has none.
+    uint64_t checksum;              // Over the bytes of all arrays.
+    struct graph_fingerprint source;
+};
+
+// Computes the fingerprint of a file from its size and mtime.
+// \param path        : Path of the file.
+// \param fingerprint : Pointer to fingerprint (provided by caller).
+// Returns TRUE on success, FALSE otherwise.
+//
+bool graph_fingerprint_file(const char * path,
+                            struct graph_fingerprint * fingerprint);
+
+// Writes a graph to a cache file. The file is written under a
+// temporary name and renamed into place, so readers never observe a
+// partial cache.
+// \param path   : Path of the cache file.
+// \param graph  : Graph to write.
+// \param source : Fingerprint of the file the graph was parsed from.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool graph_cache_write(const char * path,
+                       struct graph * graph,
+                       const struct graph_fingerprint * source);
+
+// Checks that a cache header describes arrays that fit in its file
+// and that the cache was built from the expected source.
+// \param header     : Header read from the start of the file.
+// \param file_bytes : Size of the file.
+// \param source     : Expected source fingerprint, or NULL to skip the check.
+// Returns TRUE if the header is valid, FALSE otherwise.
+//
+bool graph_cache_header_check(const struct graph_cache_header * header, uint64_t file_bytes,
+                              const struct graph_fingerprint * source);
+
+// Checks that CSR offsets describe rows that tile the neighbors
+// array: they start at 0, never decrease and end at num_edges.
+// \param offsets      : Array of num_vertices + 1 offsets.
+// \param num_vertices : Number of vertices.
+// \param num_edges    : Number of edges.
+// Returns TRUE if the offsets are valid, FALSE otherwise.
+//
+bool graph_cache_offsets_check(const graph_offset_t * offsets, size_t num_vertices, size_t num_edges);
+
+// Maps a cache file read-only and returns a graph backed by it.
+// \param path            : Path of the cache file.
+// \param source          : Expected source fingerprint, or NULL to skip the check.
+// \param verify_checksum : Whether to checksum the arrays. Neighbor
+//                          IDs are always range checked, so this only
+//                          guards against flipped bits that stay in
+//                          range.
+// Returns a new graph on success, NULL if the cache is missing, stale
+// or corrupt. Free it with graph_delete().
+//
+struct graph * graph_cache_map(const char * path,
+                               const struct graph_fingerprint * source,
+                               bool verify_checksum);
+
+#endif
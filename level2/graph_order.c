@@ -0,0 +1,428 @@
+// MIT License. Copyright (c) 2025 Kshitij Jain
+// See LICENSE file in the root of this repository.
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "graph_order.h"
+
+// Vertices the Gorder heuristic keeps in its window.
+//
+#define GRAPH_ORDER_WINDOW 5
+
+// Marks an empty slot of the Gorder bucket lists.
+//
+#define GRAPH_ORDER_NONE UINT32_MAX
+
+static const char * graph_order_names[] = {
+    [GRAPH_ORDER_ORIGINAL] = "original",
+    [GRAPH_ORDER_DEGREE]   = "degree",
+    [GRAPH_ORDER_BFS]      = "bfs",
+    [GRAPH_ORDER_RCM]      = "rcm",
+    [GRAPH_ORDER_GORDER]   = "gorder",
+};
+
+#define GRAPH_ORDER_NUM_ORDERS (sizeof(graph_order_names) / sizeof(graph_order_names[0]))
+
+// Internal utility function that sorts vertices by total degree with a
+// counting sort. Ties keep increasing ID order.
+// \param graph      : Graph to sort.
+// \param reverse    : Transpose of graph.
+// \param descending : Whether the highest degree comes first.
+// \param sequence   : Array of num_vertices vertices (provided by caller).
+// Returns TRUE on success, FALSE otherwise.
+//
+static bool _graph_order_sort_by_degree(struct graph * graph, struct graph * reverse,
+                                        bool descending, unsigned int * sequence)
+{
+    size_t num_vertices = graph->num_vertices;
+    size_t max_degree   = 0;
+    for (size_t v = 0; v < num_vertices; v++) {
+        size_t degree = (size_t)(graph->offsets[v + 1] - graph->offsets[v])
+                      + (size_t)(reverse->offsets[v + 1] - reverse->offsets[v]);
+        if (degree > max_degree) {
+            max_degree = degree;
+        }
+    }
+
+    size_t * starts = (size_t*)calloc(max_degree + 2, sizeof(size_t));
+    if (starts == NULL) {
+        return false;
+    }
+
+    // Count each degree's vertices into the slot after it, prefix sum
+    // into starts, then place.
+    //
+    for (size_t v = 0; v < num_vertices; v++) {
+        size_t degree = (size_t)(graph->offsets[v + 1] - graph->offsets[v])
+                      + (size_t)(reverse->offsets[v + 1] - reverse->offsets[v]);
+        size_t key    = descending ? max_degree - degree : degree;
+        ++starts[key + 1];
+    }
+    for (size_t key = 0; key <= max_degree; key++) {
+        starts[key + 1] += starts[key];
+    }
+    for (size_t v = 0; v < num_vertices; v++) {
+        size_t degree = (size_t)(graph->offsets[v + 1] - graph->offsets[v])
+                      + (size_t)(reverse->offsets[v + 1] - reverse->offsets[v]);
+        size_t key    = descending ? max_degree - degree : degree;
+        sequence[starts[key]++] = (unsigned int)v;
+    }
+
+    free(starts);
+    return true;
+}
+
+// Internal comparison function for qsort() of (degree, vertex) keys.
+//
+static int _graph_order_compare_keys(const void * a, const void * b) {
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+// Internal utility function that lists vertices in the order an
+// undirected BFS discovers them. Each component starts from the first
+// undiscovered vertex of roots.
+// \param graph       : Graph to traverse.
+// \param reverse     : Transpose of graph.
+// \param roots       : Array of all num_vertices vertices in root order.
+// \param by_degree   : Whether to enqueue the neighbors of a vertex in
+//                      increasing degree order, as Cuthill-McKee does.
+// \param sequence    : Array of num_vertices vertices (provided by caller).
+// Returns TRUE on success, FALSE otherwise.
+//
+static bool _graph_order_traverse(struct graph * graph, struct graph * reverse,
+                                  const unsigned int * roots, bool by_degree,
+                                  unsigned int * sequence)
+{
+    size_t num_vertices = graph->num_vertices;
+    bool * discovered   = (bool*)calloc(num_vertices + 1, sizeof(bool));
+    uint64_t * keys     = NULL;
+    size_t keys_size    = 0;
+    if (discovered == NULL) {
+        return false;
+    }
+
+    // sequence doubles as the queue: everything before tail has been
+    // discovered, everything before head has been expanded.
+    //
+    size_t head = 0;
+    size_t tail = 0;
+    for (size_t r = 0; r < num_vertices; r++) {
+        if (discovered[roots[r]]) {
+            continue;
+        }
+        discovered[roots[r]] = true;
+        sequence[tail++]     = roots[r];
+
+        while (head < tail) {
+            unsigned int vertex = sequence[head++];
+            size_t first_new    = tail;
+            struct graph * sides[2] = {graph, reverse};
+            for (size_t side = 0; side < 2; side++) {
+                struct graph * g = sides[side];
+                for (graph_offset_t edge = g->offsets[vertex]; edge < g->offsets[vertex + 1]; edge++) {
+                    unsigned int neighbor = g->neighbors[edge];
+                    if (!discovered[neighbor]) {
+                        discovered[neighbor] = true;
+                        sequence[tail++]     = neighbor;
+                    }
+                }
+            }
+
+            if (!by_degree || tail - first_new < 2) {
+                continue;
+            }
+
+            // Sort the newly discovered run by degree, ties by ID.
+            //
+            size_t run = tail - first_new;
+            if (run > keys_size) {
+                free(keys);
+                keys_size = run;
+                keys      = (uint64_t*)malloc(keys_size * sizeof(uint64_t));
+                if (keys == NULL) {
+                    free(discovered);
+                    return false;
+                }
+            }
+            for (size_t k = 0; k < run; k++) {
+                unsigned int v = sequence[first_new + k];
+                uint64_t degree = (uint64_t)(graph->offsets[v + 1] - graph->offsets[v])
+                                + (uint64_t)(reverse->offsets[v + 1] - reverse->offsets[v]);
+                keys[k] = (degree << 32) | v;
+            }
+            qsort(keys, run, sizeof(uint64_t), _graph_order_compare_keys);
+            for (size_t k = 0; k < run; k++) {
+                sequence[first_new + k] = (unsigned int)keys[k];
+            }
+        }
+    }
+
+    free(keys);
+    free(discovered);
+    return true;
+}
+
+// Bucket lists of the Gorder heuristic, the "unit heap" of Wei et al.
+// Every unplaced vertex sits in the list of its score. Scores only
+// change by one, so moving a vertex between lists and tracking the
+// highest nonempty list are both constant time.
+//
+struct graph_order_heap {
+    int64_t * scores;           // -1 once a vertex is placed.
+    unsigned int * prev;
+    unsigned int * next;
+    unsigned int * heads;       // First vertex of each score's list.
+    size_t num_heads;
+    size_t top;                 // No list above it is nonempty.
+};
+
+static void _graph_order_heap_unlink(struct graph_order_heap * heap, unsigned int vertex) {
+    unsigned int prev = heap->prev[vertex];
+    unsigned int next = heap->next[vertex];
+    if (prev != GRAPH_ORDER_NONE) {
+        heap->next[prev] = next;
+    } else {
+        heap->heads[heap->scores[vertex]] = next;
+    }
+    if (next != GRAPH_ORDER_NONE) {
+        heap->prev[next] = prev;
+    }
+}
+
+static bool _graph_order_heap_link(struct graph_order_heap * heap, unsigned int vertex) {
+    size_t score = (size_t)heap->scores[vertex];
+    if (score >= heap->num_heads) {
+        size_t num_heads = heap->num_heads * 2 > score ? heap->num_heads * 2 : score + 1;
+        unsigned int * heads = (unsigned int*)realloc(heap->heads, num_heads * sizeof(unsigned int));
+        if (heads == NULL) {
+            return false;
+        }
+        memset(heads + heap->num_heads, 0xff, (num_heads - heap->num_heads) * sizeof(unsigned int));
+        heap->heads     = heads;
+        heap->num_heads = num_heads;
+    }
+
+    heap->prev[vertex] = GRAPH_ORDER_NONE;
+    heap->next[vertex] = heap->heads[score];
+    if (heap->heads[score] != GRAPH_ORDER_NONE) {
+        heap->prev[heap->heads[score]] = vertex;
+    }
+    heap->heads[score] = vertex;
+    if (score > heap->top) {
+        heap->top = score;
+    }
+    return true;
+}
+
+// Internal utility function that moves an unplaced vertex's score by
+// delta, which is 1 or -1.
+//
+static bool _graph_order_heap_update(struct graph_order_heap * heap, unsigned int vertex, int delta) {
+    if (heap->scores[vertex] < 0) {
+        return true;
+    }
+    _graph_order_heap_unlink(heap, vertex);
+    heap->scores[vertex] += delta;
+    return _graph_order_heap_link(heap, vertex);
+}
+
+// Internal utility function that adds delta to the score of every
+// vertex related to vertex: its out- and in-neighbors, and its
+// siblings, the other out-neighbors of its in-neighbors. Siblings
+// through in-neighbors of more than hub_degree out-edges are skipped,
+// since a hub relates too many vertices to tell any of them apart.
+// \param heap       : Pointer to bucket lists.
+// \param graph      : Graph being ordered.
+// \param reverse    : Transpose of graph.
+// \param vertex     : Vertex entering or leaving the window.
+// \param delta      : 1 when entering, -1 when leaving.
+// \param hub_degree : Largest out-degree to take siblings through.
+// Returns TRUE on success, FALSE otherwise.
+//
+static bool _graph_order_window_update(struct graph_order_heap * heap,
+                                       struct graph * graph, struct graph * reverse,
+                                       unsigned int vertex, int delta, size_t hub_degree)
+{
+    bool status = true;
+    for (graph_offset_t edge = graph->offsets[vertex]; edge < graph->offsets[vertex + 1]; edge++) {
+        status = _graph_order_heap_update(heap, graph->neighbors[edge], delta) && status;
+    }
+    for (graph_offset_t edge = reverse->offsets[vertex]; edge < reverse->offsets[vertex + 1]; edge++) {
+        unsigned int parent = reverse->neighbors[edge];
+        status = _graph_order_heap_update(heap, parent, delta) && status;
+        if ((size_t)(graph->offsets[parent + 1] - graph->offsets[parent]) > hub_degree) {
+            continue;
+        }
+        for (graph_offset_t sibling = graph->offsets[parent]; sibling < graph->offsets[parent + 1]; sibling++) {
+            if (graph->neighbors[sibling] != vertex) {
+                status = _graph_order_heap_update(heap, graph->neighbors[sibling], delta) && status;
+            }
+        }
+    }
+    return status;
+}
+
+// Internal utility function that places vertices greedily: the next
+// vertex is the unplaced one related most often to the last
+// GRAPH_ORDER_WINDOW placed ones. Ties prefer recently touched, then
+// higher degree vertices.
+// \param graph    : Graph to order.
+// \param reverse  : Transpose of graph.
+// \param sequence : Array of num_vertices vertices (provided by caller).
+// Returns TRUE on success, FALSE otherwise.
+//
+static bool _graph_order_gorder(struct graph * graph, struct graph * reverse, unsigned int * sequence) {
+    size_t num_vertices = graph->num_vertices;
+    size_t hub_degree   = 1;
+    while ((hub_degree + 1) * (hub_degree + 1) <= num_vertices) {
+        ++hub_degree;
+    }
+
+    struct graph_order_heap heap;
+    heap.scores    = (int64_t*)calloc(num_vertices + 1, sizeof(int64_t));
+    heap.prev      = (unsigned int*)malloc((num_vertices + 1) * sizeof(unsigned int));
+    heap.next      = (unsigned int*)malloc((num_vertices + 1) * sizeof(unsigned int));
+    heap.num_heads = 64;
+    heap.heads     = (unsigned int*)malloc(heap.num_heads * sizeof(unsigned int));
+    heap.top       = 0;
+    bool status    = heap.scores != NULL && heap.prev != NULL && heap.next != NULL
+        && heap.heads != NULL && _graph_order_sort_by_degree(graph, reverse, false, sequence);
+
+    if (status) {
+        // Linking in increasing degree order leaves the highest degree
+        // vertex at the head of the zero list.
+        //
+        memset(heap.heads, 0xff, heap.num_heads * sizeof(unsigned int));
+        for (size_t k = 0; k < num_vertices; k++) {
+            _graph_order_heap_link(&heap, sequence[k]);
+        }
+
+        for (size_t placed = 0; placed < num_vertices && status; placed++) {
+            while (heap.top > 0 && heap.heads[heap.top] == GRAPH_ORDER_NONE) {
+                --heap.top;
+            }
+            unsigned int vertex = heap.heads[heap.top];
+            _graph_order_heap_unlink(&heap, vertex);
+            heap.scores[vertex] = -1;
+            sequence[placed]    = vertex;
+
+            status = _graph_order_window_update(&heap, graph, reverse, vertex, 1, hub_degree);
+            if (placed >= GRAPH_ORDER_WINDOW) {
+                status = _graph_order_window_update(&heap, graph, reverse,
+                                                    sequence[placed - GRAPH_ORDER_WINDOW],
+                                                    -1, hub_degree) && status;
+            }
+        }
+    }
+
+    free(heap.scores);
+    free(heap.prev);
+    free(heap.next);
+    free(heap.heads);
+    return status;
+}
+
+// Computes an ordering of a graph's vertices.
+// \param graph       : Graph to order.
+// \param order       : Ordering to compute.
+// \param num_threads : Number of threads to build helper graphs with.
+// Returns an array of num_vertices new IDs indexed by the graph's
+// current IDs on success, NULL on failure. Free it with free().
+//
+unsigned int * graph_order_compute(struct graph * graph, enum graph_order order,
+                                   size_t num_threads)
+{
+    if (graph == NULL || (size_t)order >= GRAPH_ORDER_NUM_ORDERS) {
+        return NULL;
+    }
+
+    size_t num_vertices         = graph->num_vertices;
+    unsigned int * permutation  = (unsigned int*)malloc((num_vertices + 1) * sizeof(unsigned int));
+    unsigned int * sequence     = (unsigned int*)malloc((num_vertices + 1) * sizeof(unsigned int));
+    unsigned int * roots        = NULL;
+    struct graph * reverse      = NULL;
+    bool status = permutation != NULL && sequence != NULL;
+
+    if (status && order != GRAPH_ORDER_ORIGINAL) {
+        reverse = graph_create_transpose(graph, num_threads);
+        status  = reverse != NULL;
+    }
+
+    // Every ordering lists the vertices in their new order, from which
+    // the permutation follows.
+    //
+    if (status) {
+        switch (order) {
+        case GRAPH_ORDER_ORIGINAL:
+            for (size_t v = 0; v < num_vertices; v++) {
+                sequence[v] = (unsigned int)v;
+            }
+            break;
+        case GRAPH_ORDER_DEGREE:
+            status = _graph_order_sort_by_degree(graph, reverse, true, sequence);
+            break;
+        case GRAPH_ORDER_BFS:
+        case GRAPH_ORDER_RCM:
+            // BFS starts from the hubs. Cuthill-McKee starts from low
+            // degree vertices, which tend to lie on the periphery.
+            //
+            roots  = (unsigned int*)malloc((num_vertices + 1) * sizeof(unsigned int));
+            status = roots != NULL
+                && _graph_order_sort_by_degree(graph, reverse, order == GRAPH_ORDER_BFS, roots)
+                && _graph_order_traverse(graph, reverse, roots, order == GRAPH_ORDER_RCM, sequence);
+            break;
+        case GRAPH_ORDER_GORDER:
+            status = _graph_order_gorder(graph, reverse, sequence);
+            break;
+        }
+    }
+
+    if (status) {
+        for (size_t k = 0; k < num_vertices; k++) {
+            size_t position = order == GRAPH_ORDER_RCM ? num_vertices - 1 - k : k;
+            permutation[sequence[k]] = (unsigned int)position;
+        }
+    }
+
+    free(roots);
+    free(sequence);
+    graph_delete(reverse);
+    if (!status) {
+        free(permutation);
+        return NULL;
+    }
+    return permutation;
+}
+
+// Returns the name of an ordering, NULL if it is unknown.
+// \param order : Ordering.
+//
+const char * graph_order_name(enum graph_order order) {
+    if ((size_t)order >= GRAPH_ORDER_NUM_ORDERS) {
+        return NULL;
+    }
+    return graph_order_names[order];
+}
+
+// Looks up an ordering by name.
+// \param name  : Name as returned by graph_order_name().
+// \param order : Pointer to ordering (provided by caller).
+// Returns TRUE on success, FALSE if the name is unknown.
+//
+bool graph_order_parse(const char * name, enum graph_order * order) {
+    if (name == NULL || order == NULL) {
+        return false;
+    }
+
+    for (size_t o = 0; o < GRAPH_ORDER_NUM_ORDERS; o++) {
+        if (strcmp(name, graph_order_names[o]) == 0) {
+            *order = (enum graph_order)o;
+            return true;
+        }
+    }
+    return false;
+}
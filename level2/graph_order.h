@@ -0,0 +1,57 @@
+// MIT License. Copyright (c) 2025 Kshitij Jain
+// See LICENSE file in the root of this repository.
+
+#ifndef _GRAPH_ORDER_H
+#define _GRAPH_ORDER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "graph.h"
+
+// Vertex orderings that improve the memory locality of searches.
+//
+// Vertex IDs of the input follow creation order, so the neighbors of a
+// vertex are scattered over the whole offsets array and visited set,
+// and nearly every edge a search follows is a cache miss. An ordering
+// is a permutation for graph_create_permuted() that gives vertices
+// which are searched together nearby IDs.
+//
+// All orderings but degree treat the graph as undirected, since a
+// search may reach a vertex over either of its edge directions.
+
+enum graph_order {
+    GRAPH_ORDER_ORIGINAL,       // Keep the IDs of the input.
+    GRAPH_ORDER_DEGREE,         // Decreasing total degree, so hubs share
+                                // cache lines.
+    GRAPH_ORDER_BFS,            // Discovery order of a BFS from the hubs.
+    GRAPH_ORDER_RCM,            // Reverse Cuthill-McKee, which keeps
+                                // edges close to the diagonal.
+    GRAPH_ORDER_GORDER,         // Greedy window heuristic after Gorder,
+                                // which places vertices next to those
+                                // they share neighbors with.
+};
+
+// Computes an ordering of a graph's vertices.
+// \param graph       : Graph to order.
+// \param order       : Ordering to compute.
+// \param num_threads : Number of threads to build helper graphs with.
+// Returns an array of num_vertices new IDs indexed by the graph's
+// current IDs on success, NULL on failure. Free it with free().
+//
+unsigned int * graph_order_compute(struct graph * graph, enum graph_order order,
+                                   size_t num_threads);
+
+// Returns the name of an ordering, NULL if it is unknown.
+// \param order : Ordering.
+//
+const char * graph_order_name(enum graph_order order);
+
+// Looks up an ordering by name.
+// \param name  : Name as returned by graph_order_name().
+// \param order : Pointer to ordering (provided by caller).
+// Returns TRUE on success, FALSE if the name is unknown.
+//
+bool graph_order_parse(const char * name, enum graph_order * order);
+
+#endif
@@ -0,0 +1,1535 @@
+#include <fcntl.h>
+#include <math.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "bench_stats.h"
+#include "bfs.h"
+#include "bump_ptr_allocator.h"
+#include "compressed_graph.h"
+#include "dynamic_graph.h"
+#include "external_graph.h"
+#include "grail.h"
+#include "graph.h"
+#include "graph_cache.h"
+#include "graph_order.h"
+#include "mm_fast.h"
+#include "mmio.h"
+#include "msbfs.h"
+#include "pll_index.h"
+#include "query_executor.h"
+#include "query_server.h"
+#include "queue.h"
+#include "scc.h"
+
+// Check that valid compiler defines have been passed in.
+//
+#ifdef TEST_MM_FAST
+#define VALID_TEST
+#endif
+
+#ifdef TEST_GRAPH_BUILD
+#define VALID_TEST
+#endif
+
+#ifdef TEST_BFS_BIDIRECTIONAL
+#define VALID_TEST
+#endif
+
+#ifdef TEST_BFS_DIRECTION_OPTIMIZING
+#define VALID_TEST
+#endif
+
+#ifdef TEST_BFS_PARALLEL
+#define VALID_TEST
+#endif
+
+#ifdef TEST_QUERY_EXECUTOR
+#define VALID_TEST
+#endif
+
+#ifdef TEST_MSBFS
+#define VALID_TEST
+#endif
+
+#ifdef TEST_BFS_SHORTEST_PATH
+#define VALID_TEST
+#endif
+
+#ifdef TEST_GRAPH_ORDER
+#define VALID_TEST
+#endif
+
+#ifdef TEST_COMPRESSED_GRAPH
+#define VALID_TEST
+#endif
+
+#ifdef TEST_EXTERNAL_GRAPH
+#define VALID_TEST
+#endif
+
+#ifdef TEST_PLL_INDEX
+#define VALID_TEST
+#endif
+
+#ifdef TEST_SCC
+#define VALID_TEST
+#endif
+
+#ifdef TEST_GRAIL
+#define VALID_TEST
+#endif
+
+#ifdef TEST_DYNAMIC_GRAPH
+#define VALID_TEST
+#endif
+
+#ifdef TEST_QUERY_SERVER
+#define VALID_TEST
+#endif
+
+#ifdef TEST_BENCH_STATS
+#define VALID_TEST
+#endif
+
+#ifndef VALID_TEST
+#error "Improper set of compiler defines specified, check Makefile"
+#endif
+
+#define TEST(x) printf("Running test " #x "\n"); fflush(stdout);
+#define SUBTEST(x) printf("    Executing subtest " #x "\n"); fflush(stdout); \
+                   alarm(5);
+#define FAIL(cond, msg) if (cond) {\
+                        printf("    FAIL! "); \
+                        printf(#msg "\n"); \
+                        exit(-1);\
+                        }
+#define PASS(x) printf("PASS!\n"); alarm(0);
+
+// Vertices and edges of the graph built on several threads, with
+// enough edges per vertex that no thread count is cut back.
+//
+#define BUILD_VERTICES 1000
+#define BUILD_EDGES    600000
+
+// Vertices and edges of the random graph the reachability structures
+// are checked on, and the number of queries asked of them. The graph
+// is sparse enough that only about a third of the queries have a path.
+//
+#define REACHABILITY_VERTICES  2000
+#define REACHABILITY_EDGES     3000
+#define REACHABILITY_QUERIES   4000
+#define REACHABILITY_LANDMARKS 16
+
+// Edges of the denser graph searches are also checked on, which most
+// queries cross in a few levels with large frontiers.
+//
+#define BFS_DENSE_EDGES 40000
+
+// Threads of the pool parallel searches are checked on.
+//
+#define BFS_PARALLEL_THREADS 8
+
+// Most workers the query executor is checked with.
+//
+#define EXECUTOR_WORKERS 8
+
+// Batches of each size multi-source BFS is checked with.
+//
+#define MSBFS_ROUNDS 50
+
+// Samples the benchmark statistics are checked on.
+//
+#define BENCH_SAMPLES 100
+
+// Vertices of the graph dynamic_graph updates are checked on, small
+// enough to keep every edge in a bit matrix.
+//
+#define DYNAMIC_VERTICES 300
+
+uint64_t random_state = 0x9e3779b97f4a7c15ULL;
+
+void gracefully_exit_on_suspected_infinite_loop(int signal_number) {
+    // Use write() rather than printf(), which is not safe to call
+    // from a signal handler.
+    //
+    const char* err_msg = "        Likely stuck in infinite loop! Exiting.\n";
+    ssize_t retval      = write(STDOUT_FILENO, err_msg, strlen(err_msg));
+    (void)retval;
+    (void)signal_number;
+
+    exit(1);
+}
+
+// Returns the next value of a xorshift64* generator, so that every
+// run checks the same graphs.
+//
+uint64_t next_random(void) {
+    random_state ^= random_state >> 12;
+    random_state ^= random_state << 25;
+    random_state ^= random_state >> 27;
+    return random_state * 0x2545f4914f6cdd1dULL;
+}
+
+int compare_unsigned(const void * a, const void * b) {
+    unsigned int x = *(const unsigned int*)a;
+    unsigned int y = *(const unsigned int*)b;
+    return (x > y) - (x < y);
+}
+
+// Builds a graph of random edges between num_vertices vertices.
+//
+struct graph * create_random_graph(size_t num_vertices, size_t num_edges) {
+    unsigned int * sources = (unsigned int*)malloc(num_edges * sizeof(unsigned int));
+    unsigned int * targets = (unsigned int*)malloc(num_edges * sizeof(unsigned int));
+    struct graph * graph   = NULL;
+    if (sources != NULL && targets != NULL) {
+        for (size_t e = 0; e < num_edges; e++) {
+            sources[e] = (unsigned int)(next_random() % num_vertices);
+            targets[e] = (unsigned int)(next_random() % num_vertices);
+        }
+        graph = graph_create_from_edges(num_vertices, sources, targets, num_edges, 1);
+    }
+    free(sources);
+    free(targets);
+    return graph;
+}
+
+// Draws the next random query on a graph of num_vertices vertices.
+// Every tenth asks whether a vertex lies on a cycle.
+//
+void next_query(size_t query, size_t num_vertices, unsigned int * source, unsigned int * target) {
+    *source = (unsigned int)(next_random() % num_vertices);
+    *target = query % 10 == 0 ? *source : (unsigned int)(next_random() % num_vertices);
+}
+
+// Runs random queries with a search strategy and with BFS_FORWARD.
+// Returns TRUE if every answer agrees, FALSE otherwise.
+//
+bool bfs_mode_matches_forward(struct bfs_search * search, enum bfs_mode mode) {
+    for (size_t q = 0; q < REACHABILITY_QUERIES; q++) {
+        unsigned int source, target;
+        next_query(q, search->graph->num_vertices, &source, &target);
+        if (bfs_search_run(search, mode, source, target) != bfs_search_run(search, BFS_FORWARD, source, target)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+#ifdef TEST_MM_FAST
+// Matrix Market files the fast parser is checked against mmio.c on.
+// They cover comments and blank lines, a value column, a last line
+// without a newline and shorter than one SIMD block, and indices of
+// nine and ten digits.
+//
+const char * mm_fast_test_files[] = {
+    "%%MatrixMarket matrix coordinate pattern general\n"
+    "% comment\n"
+    "%\n"
+    "% another comment, longer than sixteen bytes\n"
+    "\n"
+    "5 5 6\n"
+    "1 2\n"
+    "\n"
+    "2 3\n"
+    "3 1\n"
+    "\n"
+    "\n"
+    "4 5\n"
+    "5 4\n"
+    "1 5\n"
+    "\n",
+
+    "%%MatrixMarket matrix coordinate real general\n"
+    "% values are skipped\n"
+    "4 4 5\n"
+    "1 2 1.5\n"
+    "2 3 -2.25e+03\n"
+    "3 4 0\n"
+    "4 1 12345.678901234567\n"
+    "2 2 7\n",
+
+    "%%MatrixMarket matrix coordinate pattern general\n"
+    "3 3 3\n"
+    "1 2\n"
+    "2 3\n"
+    "3 1",
+
+    "%%MatrixMarket matrix coordinate pattern general\n"
+    "2147483647 2147483647 4\n"
+    "123456789 987654321\n"
+    "1000000000 2147483647\n"
+    "999999999 1\n"
+    "2147483647 123456789",
+};
+
+// Writes a test file and parses it with both readers.
+// Returns TRUE if they agree, FALSE otherwise.
+//
+bool mm_fast_matches_mmio(const char * contents, size_t num_threads) {
+    char path[] = "/tmp/graph_test_program_XXXXXX";
+    int fd      = mkstemp(path);
+    if (fd < 0) {
+        return false;
+    }
+    size_t length = strlen(contents);
+    bool written  = write(fd, contents, length) == (ssize_t)length;
+    close(fd);
+
+    int m = 0, n = 0, nz = 0, mm_m = 0, mm_n = 0, mm_nz = 0;
+    unsigned int * sources = NULL;
+    unsigned int * targets = NULL;
+    int * mm_sources = NULL;
+    int * mm_targets = NULL;
+    double * values  = NULL;
+    MM_typecode matcode;
+    bool matches = written
+        && mm_read_crd_pattern_fast(path, &m, &n, &nz, &sources, &targets, num_threads) == 0
+        && mm_read_mtx_crd(path, &mm_m, &mm_n, &mm_nz, &mm_sources, &mm_targets, &values, &matcode) == 0
+        && m == mm_m && n == mm_n && nz == mm_nz && nz > 0;
+    for (int e = 0; matches && e < nz; e++) {
+        matches = sources[e] == (unsigned int)mm_sources[e] && targets[e] == (unsigned int)mm_targets[e];
+    }
+
+    free(sources);
+    free(targets);
+    free(mm_sources);
+    free(mm_targets);
+    free(values);
+    unlink(path);
+    return matches;
+}
+#endif
+
+void check_mm_fast_functionality(void) {
+#ifdef TEST_MM_FAST
+    TEST(mm_fast_check_against_mmio)
+
+    // Three threads split the small files mid-line and between blank
+    // lines.
+    //
+    size_t threads[2] = { 1, 3 };
+    for (size_t f = 0; f < sizeof(mm_fast_test_files) / sizeof(mm_fast_test_files[0]); f++) {
+        SUBTEST(mm_read_crd_pattern_fast)
+        for (size_t t = 0; t < 2; t++) {
+            FAIL(mm_fast_matches_mmio(mm_fast_test_files[f], threads[t]) == false,
+                 "mm_read_crd_pattern_fast() disagrees with mm_read_mtx_crd()")
+        }
+    }
+
+    PASS(mm_fast_check_against_mmio)
+#endif
+}
+
+void check_graph_build_functionality(void) {
+#ifdef TEST_GRAPH_BUILD
+    TEST(graph_build_check_threads)
+
+    // A hub holds a quarter of the edges, so that every thread has
+    // part of its row.
+    //
+    SUBTEST(graph_create_from_edges_reference)
+    unsigned int * sources   = (unsigned int*)malloc(BUILD_EDGES * sizeof(unsigned int));
+    unsigned int * targets   = (unsigned int*)malloc(BUILD_EDGES * sizeof(unsigned int));
+    graph_offset_t * offsets = (graph_offset_t*)calloc(BUILD_VERTICES + 1, sizeof(graph_offset_t));
+    unsigned int * neighbors = (unsigned int*)malloc(BUILD_EDGES * sizeof(unsigned int));
+    FAIL(sources == NULL || targets == NULL || offsets == NULL || neighbors == NULL,
+         "Failed to allocate edge list")
+    for (size_t e = 0; e < BUILD_EDGES; e++) {
+        sources[e] = e % 4 == 0 ? 0 : (unsigned int)(next_random() % BUILD_VERTICES);
+        targets[e] = (unsigned int)(next_random() % BUILD_VERTICES);
+        ++offsets[sources[e] + 1];
+    }
+
+    // A counting sort by source gives the expected rows, neighbors in
+    // edge list order.
+    //
+    for (size_t v = 0; v < BUILD_VERTICES; v++) {
+        offsets[v + 1] += offsets[v];
+    }
+    graph_offset_t * cursor = (graph_offset_t*)malloc(BUILD_VERTICES * sizeof(graph_offset_t));
+    FAIL(cursor == NULL,
+         "Failed to allocate cursors")
+    memcpy(cursor, offsets, BUILD_VERTICES * sizeof(graph_offset_t));
+    for (size_t e = 0; e < BUILD_EDGES; e++) {
+        neighbors[cursor[sources[e]]++] = targets[e];
+    }
+    free(cursor);
+
+    size_t threads[4] = { 1, 2, 7, GRAPH_MAX_BUILD_THREADS };
+    for (size_t t = 0; t < 4; t++) {
+        SUBTEST(graph_create_from_edges_threads)
+        struct graph * graph = graph_create_from_edges(BUILD_VERTICES, sources, targets, BUILD_EDGES, threads[t]);
+        FAIL(graph == NULL || graph->num_vertices != BUILD_VERTICES || graph->num_edges != BUILD_EDGES,
+             "graph_create_from_edges() failed")
+        FAIL(memcmp(graph->offsets, offsets, (BUILD_VERTICES + 1) * sizeof(graph_offset_t)) != 0,
+             "graph_create_from_edges() offsets depend on the thread count")
+        FAIL(memcmp(graph->neighbors, neighbors, BUILD_EDGES * sizeof(unsigned int)) != 0,
+             "graph_create_from_edges() neighbors depend on the thread count")
+        graph_delete(graph);
+    }
+
+    free(neighbors);
+    free(offsets);
+    free(targets);
+    free(sources);
+
+    PASS(graph_build_check_threads)
+#endif
+}
+
+void check_bfs_bidirectional_functionality(void) {
+#ifdef TEST_BFS_BIDIRECTIONAL
+    TEST(bfs_bidirectional_check_against_forward)
+
+    size_t edges[2] = { REACHABILITY_EDGES, BFS_DENSE_EDGES };
+    for (size_t g = 0; g < 2; g++) {
+        SUBTEST(bfs_search_run_bidirectional)
+        struct graph * graph = create_random_graph(REACHABILITY_VERTICES, edges[g]);
+        FAIL(graph == NULL,
+             "graph_create_from_edges() failed")
+        struct graph * reverse = graph_create_transpose(graph, 1);
+        FAIL(reverse == NULL,
+             "graph_create_transpose() failed")
+        struct bfs_search * search = bfs_search_create(graph, reverse, NULL, NULL, NULL, 0);
+        FAIL(search == NULL,
+             "bfs_search_create() failed")
+        FAIL(bfs_mode_matches_forward(search, BFS_BIDIRECTIONAL) == false,
+             "BFS_BIDIRECTIONAL disagrees with BFS_FORWARD")
+
+        bfs_search_delete(search);
+        graph_delete(reverse);
+        graph_delete(graph);
+    }
+
+    PASS(bfs_bidirectional_check_against_forward)
+#endif
+}
+
+void check_bfs_direction_optimizing_functionality(void) {
+#ifdef TEST_BFS_DIRECTION_OPTIMIZING
+    TEST(bfs_direction_optimizing_check_against_forward)
+
+    // On the dense graph the frontier outgrows the unvisited edges
+    // within a few levels, so searches switch to bottom-up and back.
+    //
+    size_t edges[2] = { REACHABILITY_EDGES, BFS_DENSE_EDGES };
+    for (size_t g = 0; g < 2; g++) {
+        SUBTEST(bfs_search_run_direction_optimizing)
+        struct graph * graph = create_random_graph(REACHABILITY_VERTICES, edges[g]);
+        FAIL(graph == NULL,
+             "graph_create_from_edges() failed")
+        struct graph * reverse = graph_create_transpose(graph, 1);
+        FAIL(reverse == NULL,
+             "graph_create_transpose() failed")
+        struct bfs_search * search = bfs_search_create(graph, reverse, NULL, NULL, NULL, 0);
+        FAIL(search == NULL,
+             "bfs_search_create() failed")
+        FAIL(bfs_mode_matches_forward(search, BFS_DIRECTION_OPTIMIZING) == false,
+             "BFS_DIRECTION_OPTIMIZING disagrees with BFS_FORWARD")
+
+        bfs_search_delete(search);
+        graph_delete(reverse);
+        graph_delete(graph);
+    }
+
+    PASS(bfs_direction_optimizing_check_against_forward)
+#endif
+}
+
+void check_bfs_parallel_functionality(void) {
+#ifdef TEST_BFS_PARALLEL
+    TEST(bfs_parallel_check_against_forward)
+
+    // One pool serves every thread count, as in the scaling curve,
+    // so workers are parked and woken between searches.
+    //
+    size_t edges[2]   = { REACHABILITY_EDGES, BFS_DENSE_EDGES };
+    size_t threads[5] = { 1, 2, 3, 5, BFS_PARALLEL_THREADS };
+    for (size_t g = 0; g < 2; g++) {
+        SUBTEST(bfs_search_create_parallel)
+        struct graph * graph = create_random_graph(REACHABILITY_VERTICES, edges[g]);
+        FAIL(graph == NULL,
+             "graph_create_from_edges() failed")
+        struct bfs_search * search = bfs_search_create(graph, NULL, NULL, NULL, NULL, BFS_PARALLEL_THREADS);
+        FAIL(search == NULL,
+             "bfs_search_create() failed")
+        FAIL(bfs_search_set_threads(search, 0) != false
+             || bfs_search_set_threads(search, BFS_PARALLEL_THREADS + 1) != false,
+             "bfs_search_set_threads() accepted an out of range thread count")
+
+        for (size_t t = 0; t < 5; t++) {
+            SUBTEST(bfs_search_run_parallel)
+            FAIL(bfs_search_set_threads(search, threads[t]) == false,
+                 "bfs_search_set_threads() failed")
+            FAIL(bfs_mode_matches_forward(search, BFS_PARALLEL) == false,
+                 "BFS_PARALLEL disagrees with BFS_FORWARD")
+        }
+
+        bfs_search_delete(search);
+        graph_delete(graph);
+    }
+
+    PASS(bfs_parallel_check_against_forward)
+#endif
+}
+
+void check_query_executor_functionality(void) {
+#ifdef TEST_QUERY_EXECUTOR
+    TEST(query_executor_check_against_serial)
+
+    SUBTEST(query_executor_create)
+    struct graph * graph = create_random_graph(REACHABILITY_VERTICES, REACHABILITY_EDGES);
+    FAIL(graph == NULL,
+         "graph_create_from_edges() failed")
+    struct bfs_search * search = bfs_search_create(graph, NULL, NULL, NULL, NULL, 0);
+    FAIL(search == NULL,
+         "bfs_search_create() failed")
+    struct query * queries = (struct query*)malloc(REACHABILITY_QUERIES * sizeof(struct query));
+    FAIL(queries == NULL,
+         "Failed to allocate queries")
+
+    // Forward searches grow their queues, so they also check that the
+    // workers were sized before running concurrently. Every executor
+    // runs several batches, the last of a single query, on the same
+    // workers.
+    //
+    enum bfs_mode modes[2] = { BFS_FORWARD, BFS_SHORTEST_PATH };
+    size_t workers[3]      = { 1, 4, EXECUTOR_WORKERS };
+    size_t batches[3]      = { REACHABILITY_QUERIES, REACHABILITY_QUERIES / 3, 1 };
+    for (size_t m = 0; m < 2; m++) {
+        for (size_t w = 0; w < 3; w++) {
+            SUBTEST(query_executor_run)
+            struct query_executor * executor = query_executor_create(graph, NULL, NULL, NULL, NULL,
+                                                                     modes[m], workers[w]);
+            FAIL(executor == NULL,
+                 "query_executor_create() failed")
+            for (size_t b = 0; b < 3; b++) {
+                for (size_t q = 0; q < batches[b]; q++) {
+                    next_query(q, REACHABILITY_VERTICES, &queries[q].source, &queries[q].target);
+                }
+                FAIL(query_executor_run(executor, queries, batches[b]) == false,
+                     "query_executor_run() failed")
+                for (size_t q = 0; q < batches[b]; q++) {
+                    bool found = bfs_search_run(search, modes[m], queries[q].source, queries[q].target);
+                    FAIL(queries[q].found != found
+                         || queries[q].nodes_visited != search->nodes_visited
+                         || queries[q].edges_examined != search->edges_examined,
+                         "query_executor_run() disagrees with a serial search")
+                }
+            }
+            query_executor_delete(executor);
+        }
+    }
+
+    free(queries);
+    bfs_search_delete(search);
+    graph_delete(graph);
+
+    PASS(query_executor_check_against_serial)
+#endif
+}
+
+void check_msbfs_functionality(void) {
+#ifdef TEST_MSBFS
+    TEST(msbfs_check_against_bfs)
+
+    size_t edges[2]   = { REACHABILITY_EDGES, BFS_DENSE_EDGES };
+    size_t batches[3] = { 1, MSBFS_WIDTH - 1, MSBFS_WIDTH };
+    for (size_t g = 0; g < 2; g++) {
+        SUBTEST(msbfs_create)
+        struct graph * graph = create_random_graph(REACHABILITY_VERTICES, edges[g]);
+        FAIL(graph == NULL,
+             "graph_create_from_edges() failed")
+        struct bfs_search * search = bfs_search_create(graph, NULL, NULL, NULL, NULL, 0);
+        FAIL(search == NULL,
+             "bfs_search_create() failed")
+        struct msbfs * msbfs = msbfs_create(graph);
+        FAIL(msbfs == NULL,
+             "msbfs_create() failed")
+
+        unsigned int sources[MSBFS_WIDTH + 1];
+        unsigned int targets[MSBFS_WIDTH + 1];
+        bool found[MSBFS_WIDTH + 1];
+        FAIL(msbfs_run(msbfs, sources, targets, MSBFS_WIDTH + 1, found) != false,
+             "msbfs_run() accepted more queries than bits")
+
+        // Every tenth query is its own target. Queries 3 and 5 name
+        // vertices past the last one, which have no path.
+        //
+        for (size_t b = 0; b < 3; b++) {
+            SUBTEST(msbfs_run)
+            for (size_t round = 0; round < MSBFS_ROUNDS; round++) {
+                for (size_t k = 0; k < batches[b]; k++) {
+                    next_query(k, REACHABILITY_VERTICES, &sources[k], &targets[k]);
+                }
+                if (batches[b] > 5) {
+                    sources[3] = REACHABILITY_VERTICES;
+                    targets[5] = UINT32_MAX;
+                }
+                FAIL(msbfs_run(msbfs, sources, targets, batches[b], found) == false,
+                     "msbfs_run() failed")
+                for (size_t k = 0; k < batches[b]; k++) {
+                    FAIL(found[k] != bfs_search_run(search, BFS_SHORTEST_PATH, sources[k], targets[k]),
+                         "msbfs_run() disagrees with BFS_SHORTEST_PATH")
+                }
+            }
+        }
+
+        msbfs_delete(msbfs);
+        bfs_search_delete(search);
+        graph_delete(graph);
+    }
+
+    PASS(msbfs_check_against_bfs)
+#endif
+}
+
+#ifdef TEST_BFS_SHORTEST_PATH
+// Returns TRUE if a graph has an edge from source to target.
+//
+bool graph_has_edge(struct graph * graph, unsigned int source, unsigned int target) {
+    for (graph_offset_t e = graph->offsets[source]; e < graph->offsets[source + 1]; e++) {
+        if (graph->neighbors[e] == target) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Finds the fewest edges on a path of at least one edge from source
+// to target with a plain array BFS, independent of bfs.c.
+// \param distance : Array of num_vertices entries (provided by caller).
+// \param queue    : Array of num_vertices entries (provided by caller).
+// Returns the number of edges, 0 if there is no path.
+//
+size_t reference_path_edges(struct graph * graph, unsigned int source, unsigned int target,
+                            size_t * distance, unsigned int * queue) {
+    for (size_t v = 0; v < graph->num_vertices; v++) {
+        distance[v] = 0;
+    }
+    size_t head = 0;
+    size_t tail = 0;
+    queue[tail++] = source;
+    while (head < tail) {
+        unsigned int vertex = queue[head++];
+        for (graph_offset_t e = graph->offsets[vertex]; e < graph->offsets[vertex + 1]; e++) {
+            unsigned int neighbor = graph->neighbors[e];
+            if (neighbor == target) {
+                return distance[vertex] + 1;
+            }
+            if (distance[neighbor] == 0 && neighbor != source) {
+                distance[neighbor] = distance[vertex] + 1;
+                queue[tail++]      = neighbor;
+            }
+        }
+    }
+    return 0;
+}
+#endif
+
+void check_bfs_shortest_path_functionality(void) {
+#ifdef TEST_BFS_SHORTEST_PATH
+    TEST(bfs_shortest_path_check_paths)
+
+    size_t edges[2] = { REACHABILITY_EDGES, BFS_DENSE_EDGES };
+    for (size_t g = 0; g < 2; g++) {
+        SUBTEST(bfs_search_run_shortest_path)
+        struct graph * graph = create_random_graph(REACHABILITY_VERTICES, edges[g]);
+        FAIL(graph == NULL,
+             "graph_create_from_edges() failed")
+        struct bfs_search * search = bfs_search_create(graph, NULL, NULL, NULL, NULL, 0);
+        FAIL(search == NULL,
+             "bfs_search_create() failed")
+        size_t * distance    = (size_t*)malloc(REACHABILITY_VERTICES * sizeof(size_t));
+        unsigned int * queue = (unsigned int*)malloc(REACHABILITY_VERTICES * sizeof(unsigned int));
+        FAIL(distance == NULL || queue == NULL,
+             "Failed to allocate reference search")
+
+        // The path is read back through the parent array, so every
+        // interior vertex must have its predecessor as parent.
+        //
+        for (size_t q = 0; q < REACHABILITY_QUERIES; q++) {
+            unsigned int source, target;
+            next_query(q, REACHABILITY_VERTICES, &source, &target);
+            size_t expected = reference_path_edges(graph, source, target, distance, queue);
+            bool found      = bfs_search_run(search, BFS_SHORTEST_PATH, source, target);
+            FAIL(found != (expected > 0) || search->path_length != (found ? expected + 1 : 0),
+                 "BFS_SHORTEST_PATH path does not have the fewest edges")
+            if (!found) {
+                continue;
+            }
+            FAIL(search->path[0] != source || search->path[search->path_length - 1] != target,
+                 "BFS_SHORTEST_PATH path does not run from source to target")
+            for (size_t i = 1; i < search->path_length; i++) {
+                FAIL(graph_has_edge(graph, search->path[i - 1], search->path[i]) == false,
+                     "BFS_SHORTEST_PATH path follows a missing edge")
+                FAIL(i + 1 < search->path_length && search->parent[search->path[i]] != search->path[i - 1],
+                     "BFS_SHORTEST_PATH path does not follow the parent array")
+            }
+        }
+
+        free(queue);
+        free(distance);
+        bfs_search_delete(search);
+        graph_delete(graph);
+    }
+
+    PASS(bfs_shortest_path_check_paths)
+#endif
+}
+
+void check_graph_order_functionality(void) {
+#ifdef TEST_GRAPH_ORDER
+    TEST(graph_order_check_relabeling)
+
+    SUBTEST(graph_order_compute)
+    struct graph * graph = create_random_graph(REACHABILITY_VERTICES, REACHABILITY_EDGES);
+    FAIL(graph == NULL,
+         "graph_create_from_edges() failed")
+    unsigned int * seen = (unsigned int*)malloc(REACHABILITY_VERTICES * sizeof(unsigned int));
+    FAIL(seen == NULL,
+         "Failed to allocate seen array")
+
+    // Each ordering is applied on top of the previous one, so the
+    // relabelings compose across all of them.
+    //
+    enum graph_order orders[4] = { GRAPH_ORDER_DEGREE, GRAPH_ORDER_BFS, GRAPH_ORDER_RCM, GRAPH_ORDER_GORDER };
+    struct graph * current = graph;
+    for (size_t o = 0; o < 4; o++) {
+        SUBTEST(graph_order_permutation)
+        unsigned int * permutation = graph_order_compute(current, orders[o], 2);
+        FAIL(permutation == NULL,
+             "graph_order_compute() failed")
+        memset(seen, 0, REACHABILITY_VERTICES * sizeof(unsigned int));
+        for (size_t v = 0; v < REACHABILITY_VERTICES; v++) {
+            FAIL(permutation[v] >= REACHABILITY_VERTICES || seen[permutation[v]]++ != 0,
+                 "graph_order_compute() did not return a permutation")
+        }
+
+        SUBTEST(graph_create_permuted)
+        struct graph * permuted = graph_create_permuted(current, permutation, 2);
+        FAIL(permuted == NULL || permuted->num_edges != graph->num_edges,
+             "graph_create_permuted() failed")
+        for (size_t v = 0; v < REACHABILITY_VERTICES; v++) {
+            graph_offset_t degree = current->offsets[v + 1] - current->offsets[v];
+            graph_offset_t start  = permuted->offsets[permutation[v]];
+            FAIL(permuted->offsets[permutation[v] + 1] - start != degree,
+                 "graph_create_permuted() changed a row's degree")
+            for (graph_offset_t e = 0; e < degree; e++) {
+                FAIL(permuted->neighbors[start + e] != permutation[current->neighbors[current->offsets[v] + e]],
+                     "graph_create_permuted() did not relabel a row in order")
+            }
+        }
+
+        SUBTEST(graph_vertex_id_round_trip)
+        for (unsigned int original = 0; original < REACHABILITY_VERTICES; original++) {
+            unsigned int vertex = graph_vertex_id(permuted, original);
+            FAIL(vertex != permutation[graph_vertex_id(current, original)],
+                 "graph_vertex_id() does not compose the relabelings")
+            FAIL(graph_original_id(permuted, vertex) != original,
+                 "graph_original_id() does not invert graph_vertex_id()")
+        }
+
+        free(permutation);
+        if (current != graph) {
+            graph_delete(current);
+        }
+        current = permuted;
+    }
+
+    // A mapped cache must carry the relabeling, or queries would name
+    // the wrong vertices.
+    //
+    SUBTEST(graph_cache_map_relabeled)
+    char path[] = "/tmp/graph_test_program_XXXXXX";
+    int fd      = mkstemp(path);
+    FAIL(fd < 0,
+         "mkstemp() failed")
+    close(fd);
+    struct graph_fingerprint source = { 0, 0, 0 };
+    FAIL(graph_cache_write(path, current, &source) == false,
+         "graph_cache_write() failed")
+    struct graph * mapped = graph_cache_map(path, &source, true);
+    FAIL(mapped == NULL || mapped->vertex_ids == NULL,
+         "graph_cache_map() failed")
+    FAIL(memcmp(mapped->offsets, current->offsets, (REACHABILITY_VERTICES + 1) * sizeof(graph_offset_t)) != 0
+         || memcmp(mapped->neighbors, current->neighbors, current->num_edges * sizeof(unsigned int)) != 0,
+         "graph_cache_map() rows differ from the written graph")
+    for (unsigned int original = 0; original < REACHABILITY_VERTICES; original++) {
+        FAIL(graph_vertex_id(mapped, original) != graph_vertex_id(current, original)
+             || graph_original_id(mapped, graph_vertex_id(mapped, original)) != original,
+             "graph_cache_map() lost the relabeling")
+    }
+    graph_delete(mapped);
+    unlink(path);
+
+    // Repeated and out of range IDs must be rejected before any edge
+    // is relabeled with them.
+    //
+    SUBTEST(graph_create_permuted_invalid)
+    for (size_t v = 0; v < REACHABILITY_VERTICES; v++) {
+        seen[v] = (unsigned int)v;
+    }
+    seen[1] = 0;
+    FAIL(graph_create_permuted(graph, seen, 2) != NULL,
+         "graph_create_permuted() accepted a repeated ID")
+    seen[1] = REACHABILITY_VERTICES;
+    FAIL(graph_create_permuted(graph, seen, 2) != NULL,
+         "graph_create_permuted() accepted an out of range ID")
+
+    free(seen);
+    graph_delete(current);
+    graph_delete(graph);
+
+    PASS(graph_order_check_relabeling)
+#endif
+}
+
+void check_compressed_graph_functionality(void) {
+#ifdef TEST_COMPRESSED_GRAPH
+    TEST(compressed_graph_check_round_trip)
+
+    // Rows of 0 to 9 neighbors, so that most end part way into a
+    // control byte, whose gaps take 1 to 4 bytes. Gaps past 3 bytes
+    // need IDs past 2^24, and the first gap of a row is zigzag
+    // encoded, so the graph needs almost 2^23 vertices for them.
+    //
+    SUBTEST(compressed_graph_create)
+    size_t num_vertices    = ((size_t)1 << 23) + 4096;
+    size_t num_rows        = 4096;
+    size_t num_edges       = 0;
+    unsigned int * sources = (unsigned int*)malloc(num_rows * 9 * sizeof(unsigned int));
+    unsigned int * targets = (unsigned int*)malloc(num_rows * 9 * sizeof(unsigned int));
+    FAIL(sources == NULL || targets == NULL,
+         "Failed to allocate edge list")
+    for (size_t r = 0; r < num_rows; r++) {
+        unsigned int vertex = r % 2 == 0 ? (unsigned int)r : (unsigned int)(num_vertices - r);
+        for (size_t k = 0; k < r % 10; k++) {
+            uint64_t spans[4] = { 1ULL << 7, 1ULL << 15, 1ULL << 23, num_vertices };
+            uint64_t span     = spans[next_random() % 4];
+            sources[num_edges] = vertex;
+            targets[num_edges] = (unsigned int)(next_random() % span);
+            if (vertex >= span && next_random() % 2 == 0) {
+                targets[num_edges] = (unsigned int)(vertex - targets[num_edges]);
+            }
+            ++num_edges;
+        }
+    }
+    struct graph * graph = graph_create_from_edges(num_vertices, sources, targets, num_edges, 1);
+    FAIL(graph == NULL,
+         "graph_create_from_edges() failed")
+    struct compressed_graph * compressed = compressed_graph_create(graph);
+    FAIL(compressed == NULL,
+         "compressed_graph_create() failed")
+    FAIL(compressed->num_vertices != num_vertices || compressed->num_edges != num_edges
+         || compressed->max_degree != 9,
+         "compressed_graph_create() did not keep the size of the graph")
+
+    SUBTEST(compressed_graph_decode_row)
+    unsigned int expected[9];
+    unsigned int simd[9 + COMPRESSED_GRAPH_DECODE_SLACK];
+    unsigned int scalar[9];
+    for (size_t v = 0; v < num_vertices; v++) {
+        size_t degree = graph->offsets[v + 1] - graph->offsets[v];
+        memcpy(expected, &graph->neighbors[graph->offsets[v]], degree * sizeof(unsigned int));
+        qsort(expected, degree, sizeof(unsigned int), compare_unsigned);
+        FAIL(compressed_graph_decode_row(compressed, (unsigned int)v, simd) != degree
+             || memcmp(simd, expected, degree * sizeof(unsigned int)) != 0,
+             "compressed_graph_decode_row() did not return the sorted row")
+        FAIL(compressed_graph_decode_row_scalar(compressed, (unsigned int)v, scalar) != degree
+             || memcmp(scalar, expected, degree * sizeof(unsigned int)) != 0,
+             "compressed_graph_decode_row_scalar() did not return the sorted row")
+    }
+
+    compressed_graph_delete(compressed);
+    graph_delete(graph);
+    free(sources);
+    free(targets);
+
+    PASS(compressed_graph_check_round_trip)
+#endif
+}
+
+void check_external_graph_functionality(void) {
+#ifdef TEST_EXTERNAL_GRAPH
+    TEST(external_graph_check_offsets)
+
+    SUBTEST(external_graph_open)
+    char path[] = "/tmp/graph_test_program_XXXXXX";
+    int fd      = mkstemp(path);
+    FAIL(fd < 0,
+         "mkstemp() failed")
+    struct graph * graph = create_random_graph(64, 512);
+    FAIL(graph == NULL,
+         "graph_create_from_edges() failed")
+    struct graph_fingerprint source = { 0, 0, 0 };
+    FAIL(graph_cache_write(path, graph, &source) == false,
+         "graph_cache_write() failed")
+    struct external_graph * external = external_graph_open(path);
+    FAIL(external == NULL || external->num_vertices != 64 || external->num_edges != 512,
+         "external_graph_open() rejected a valid cache")
+    external_graph_close(external);
+
+    // Swap two rows' offsets, so that one row ends before it starts
+    // while the array still ends at num_edges.
+    //
+    SUBTEST(external_graph_open_non_monotonic)
+    close(fd);
+    fd = open(path, O_RDWR);
+    FAIL(fd < 0,
+         "open() of the cache failed")
+    struct graph_cache_header header;
+    FAIL(pread(fd, &header, sizeof(header), 0) != (ssize_t)sizeof(header),
+         "pread() of the cache header failed")
+    graph_offset_t offsets[2];
+    off_t position = (off_t)(header.offsets_position + sizeof(graph_offset_t));
+    FAIL(pread(fd, offsets, sizeof(offsets), position) != (ssize_t)sizeof(offsets),
+         "pread() of the cache offsets failed")
+    FAIL(offsets[0] == offsets[1],
+         "Random graph has an empty row")
+    graph_offset_t swap = offsets[0];
+    offsets[0]          = offsets[1];
+    offsets[1]          = swap;
+    FAIL(pwrite(fd, offsets, sizeof(offsets), position) != (ssize_t)sizeof(offsets),
+         "pwrite() of the cache offsets failed")
+    external = external_graph_open(path);
+    FAIL(external != NULL,
+         "external_graph_open() accepted non-monotonic offsets")
+    struct graph * mapped = graph_cache_map(path, NULL, false);
+    FAIL(mapped != NULL,
+         "graph_cache_map() accepted non-monotonic offsets")
+
+    // Restore the offsets and point the first edge one past the last
+    // vertex. The map must reject it without checksum verification.
+    //
+    SUBTEST(graph_cache_map_neighbor_out_of_range)
+    FAIL(pwrite(fd, &offsets[1], sizeof(graph_offset_t), position) != (ssize_t)sizeof(graph_offset_t)
+         || pwrite(fd, &offsets[0], sizeof(graph_offset_t), position + (off_t)sizeof(graph_offset_t))
+            != (ssize_t)sizeof(graph_offset_t),
+         "pwrite() of the cache offsets failed")
+    mapped = graph_cache_map(path, NULL, false);
+    FAIL(mapped == NULL,
+         "graph_cache_map() rejected a restored cache")
+    graph_delete(mapped);
+    unsigned int neighbor = 64;
+    FAIL(pwrite(fd, &neighbor, sizeof(neighbor), (off_t)header.neighbors_position) != (ssize_t)sizeof(neighbor),
+         "pwrite() of the cache neighbors failed")
+    mapped = graph_cache_map(path, NULL, false);
+    FAIL(mapped != NULL,
+         "graph_cache_map() accepted an out of range neighbor")
+
+    close(fd);
+    unlink(path);
+    graph_delete(graph);
+
+    PASS(external_graph_check_offsets)
+#endif
+}
+
+void check_pll_index_functionality(void) {
+#ifdef TEST_PLL_INDEX
+    TEST(pll_index_check_against_bfs)
+
+    SUBTEST(pll_index_create)
+    struct graph * graph = create_random_graph(REACHABILITY_VERTICES, REACHABILITY_EDGES);
+    FAIL(graph == NULL,
+         "graph_create_from_edges() failed")
+    struct graph * reverse = graph_create_transpose(graph, 1);
+    FAIL(reverse == NULL,
+         "graph_create_transpose() failed")
+    struct bfs_search * search = bfs_search_create(graph, NULL, NULL, NULL, NULL, 0);
+    FAIL(search == NULL,
+         "bfs_search_create() failed")
+
+    // A few landmarks leave most queries to the fallback search, a
+    // landmark per vertex answers all of them from the labels.
+    //
+    size_t landmarks[2] = { REACHABILITY_LANDMARKS, REACHABILITY_VERTICES };
+    for (size_t l = 0; l < 2; l++) {
+        SUBTEST(pll_search_distance)
+        struct pll_index * index = pll_index_create(graph, reverse, landmarks[l]);
+        FAIL(index == NULL,
+             "pll_index_create() failed")
+        struct pll_search * pll = pll_search_create(index, graph);
+        FAIL(pll == NULL,
+             "pll_search_create() failed")
+
+        size_t reachable = 0;
+        for (size_t q = 0; q < REACHABILITY_QUERIES; q++) {
+            unsigned int source, target;
+            next_query(q, REACHABILITY_VERTICES, &source, &target);
+            bool expected = bfs_search_run(search, BFS_SHORTEST_PATH, source, target);
+            reachable    += expected;
+            FAIL(pll_search_reachable(pll, source, target) != expected,
+                 "pll_search_reachable() disagrees with BFS_SHORTEST_PATH")
+
+            // The path holds its two ends, so it has one edge less
+            // than vertices.
+            //
+            if (source != target) {
+                uint32_t distance = expected ? (uint32_t)(search->path_length - 1) : PLL_INFINITY;
+                FAIL(pll_search_distance(pll, source, target) != distance,
+                     "pll_search_distance() disagrees with BFS_SHORTEST_PATH")
+            }
+        }
+        FAIL(reachable == 0 || reachable == REACHABILITY_QUERIES,
+             "Random graph does not mix reachable and unreachable queries")
+
+        pll_search_delete(pll);
+        pll_index_delete(index);
+    }
+
+    bfs_search_delete(search);
+    graph_delete(reverse);
+    graph_delete(graph);
+
+    PASS(pll_index_check_against_bfs)
+#endif
+}
+
+void check_scc_functionality(void) {
+#ifdef TEST_SCC
+    TEST(scc_check_against_bfs)
+
+    SUBTEST(scc_graph_create)
+    struct graph * graph = create_random_graph(REACHABILITY_VERTICES, REACHABILITY_EDGES);
+    FAIL(graph == NULL,
+         "graph_create_from_edges() failed")
+    struct bfs_search * search = bfs_search_create(graph, NULL, NULL, NULL, NULL, 0);
+    FAIL(search == NULL,
+         "bfs_search_create() failed")
+    struct scc_graph * scc = scc_graph_create(graph, 2);
+    FAIL(scc == NULL,
+         "scc_graph_create() failed")
+    struct scc_search * condensed = scc_search_create(scc, NULL);
+    FAIL(condensed == NULL,
+         "scc_search_create() failed")
+
+    // Every edge either stays in its component or has a counterpart
+    // in the DAG, which has no self-loops.
+    //
+    SUBTEST(scc_graph_dag)
+    size_t total_size = 0;
+    for (size_t c = 0; c < scc->num_components; c++) {
+        total_size += scc->component_size[c];
+    }
+    FAIL(total_size != REACHABILITY_VERTICES || scc->dag->num_vertices != scc->num_components,
+         "scc_graph_create() did not partition the vertices")
+    for (size_t v = 0; v < REACHABILITY_VERTICES; v++) {
+        uint32_t from = scc->component[v];
+        for (graph_offset_t e = graph->offsets[v]; e < graph->offsets[v + 1]; e++) {
+            uint32_t to = scc->component[graph->neighbors[e]];
+            bool found  = from == to;
+            for (graph_offset_t d = scc->dag->offsets[from]; !found && d < scc->dag->offsets[from + 1]; d++) {
+                found = scc->dag->neighbors[d] == to;
+            }
+            FAIL(found == false,
+                 "scc_graph_create() lost an edge between components")
+        }
+    }
+    for (size_t c = 0; c < scc->num_components; c++) {
+        for (graph_offset_t d = scc->dag->offsets[c]; d < scc->dag->offsets[c + 1]; d++) {
+            FAIL(scc->dag->neighbors[d] == c,
+                 "scc_graph_create() left a self-loop in the DAG")
+        }
+    }
+
+    SUBTEST(scc_search_reachable)
+    size_t reachable = 0;
+    for (size_t q = 0; q < REACHABILITY_QUERIES; q++) {
+        unsigned int source, target;
+        next_query(q, REACHABILITY_VERTICES, &source, &target);
+        bool expected = bfs_search_run(search, BFS_SHORTEST_PATH, source, target);
+        reachable    += expected;
+        FAIL(scc_search_reachable(condensed, source, target) != expected,
+             "scc_search_reachable() disagrees with BFS_SHORTEST_PATH")
+        FAIL(scc->component[source] == scc->component[target]
+             && expected != (source != target || scc->cyclic[scc->component[source]]),
+             "Vertices of one component do not reach each other")
+    }
+    FAIL(reachable == 0 || reachable == REACHABILITY_QUERIES,
+         "Random graph does not mix reachable and unreachable queries")
+
+    scc_search_delete(condensed);
+    scc_graph_delete(scc);
+    bfs_search_delete(search);
+    graph_delete(graph);
+
+    PASS(scc_check_against_bfs)
+#endif
+}
+
+void check_grail_functionality(void) {
+#ifdef TEST_GRAIL
+    TEST(grail_check_against_bfs)
+
+    SUBTEST(grail_index_create)
+    struct graph * graph = create_random_graph(REACHABILITY_VERTICES, REACHABILITY_EDGES);
+    FAIL(graph == NULL,
+         "graph_create_from_edges() failed")
+    struct bfs_search * search = bfs_search_create(graph, NULL, NULL, NULL, NULL, 0);
+    FAIL(search == NULL,
+         "bfs_search_create() failed")
+    struct scc_graph * scc = scc_graph_create(graph, 1);
+    FAIL(scc == NULL,
+         "scc_graph_create() failed")
+    FAIL(grail_index_create(scc->dag, 0, 1) != NULL
+         || grail_index_create(scc->dag, GRAIL_MAX_LABELS + 1, 1) != NULL,
+         "grail_index_create() accepted an out of range label count")
+
+    // Labels may only rule out pairs that have no path, so the
+    // pruned search must give the same answers with any number of
+    // them.
+    //
+    size_t labels[2] = { 1, GRAIL_MAX_LABELS };
+    for (size_t l = 0; l < 2; l++) {
+        SUBTEST(grail_index_may_reach)
+        struct grail_index * grail = grail_index_create(scc->dag, labels[l], l + 1);
+        FAIL(grail == NULL,
+             "grail_index_create() failed")
+        struct scc_search * condensed = scc_search_create(scc, grail);
+        FAIL(condensed == NULL,
+             "scc_search_create() failed")
+
+        size_t rejected = 0;
+        for (size_t q = 0; q < REACHABILITY_QUERIES; q++) {
+            unsigned int source, target;
+            next_query(q, REACHABILITY_VERTICES, &source, &target);
+            bool expected = bfs_search_run(search, BFS_SHORTEST_PATH, source, target);
+            FAIL(scc_search_reachable(condensed, source, target) != expected,
+                 "scc_search_reachable() with labels disagrees with BFS_SHORTEST_PATH")
+            bool may_reach = grail_index_may_reach(grail, scc->component[source], scc->component[target]);
+            FAIL(expected && !may_reach,
+                 "grail_index_may_reach() ruled out a pair with a path")
+            rejected += !may_reach;
+        }
+        FAIL(rejected == 0,
+             "grail_index_may_reach() never ruled out a pair")
+
+        scc_search_delete(condensed);
+        grail_index_delete(grail);
+    }
+
+    scc_graph_delete(scc);
+    bfs_search_delete(search);
+    graph_delete(graph);
+
+    PASS(grail_check_against_bfs)
+#endif
+}
+
+#ifdef TEST_DYNAMIC_GRAPH
+// Checks a dynamic graph against a bit matrix of the edges it should
+// hold: edge counts, row layout and every (source, target) pair.
+//
+bool dynamic_graph_matches(struct dynamic_graph * dynamic, const uint8_t * edges) {
+    size_t num_edges = 0;
+    for (size_t v = 0; v < DYNAMIC_VERTICES; v++) {
+        const struct dynamic_graph_row * row = &dynamic->rows[v];
+        size_t degree = 0;
+        for (size_t u = 0; u < DYNAMIC_VERTICES; u++) {
+            bool present = edges[v * DYNAMIC_VERTICES + u] != 0;
+            degree      += present;
+            if (dynamic_graph_has_edge(dynamic, (unsigned int)v, (unsigned int)u) != present) {
+                return false;
+            }
+        }
+        if (row->degree != degree || row->start + row->degree > dynamic->rows[v + 1].start) {
+            return false;
+        }
+        num_edges += degree;
+    }
+    return dynamic->num_edges == num_edges
+           && dynamic->rows[0].start == 0
+           && dynamic->rows[DYNAMIC_VERTICES].start == dynamic->num_slots;
+}
+
+// Builds a graph holding exactly the edges set in a bit matrix.
+//
+struct graph * create_graph_from_matrix(const uint8_t * edges) {
+    unsigned int * sources = (unsigned int*)malloc(DYNAMIC_VERTICES * DYNAMIC_VERTICES * sizeof(unsigned int));
+    unsigned int * targets = (unsigned int*)malloc(DYNAMIC_VERTICES * DYNAMIC_VERTICES * sizeof(unsigned int));
+    struct graph * graph   = NULL;
+    if (sources != NULL && targets != NULL) {
+        size_t num_edges = 0;
+        for (size_t e = 0; e < DYNAMIC_VERTICES * DYNAMIC_VERTICES; e++) {
+            if (edges[e] != 0) {
+                sources[num_edges] = (unsigned int)(e / DYNAMIC_VERTICES);
+                targets[num_edges] = (unsigned int)(e % DYNAMIC_VERTICES);
+                num_edges++;
+            }
+        }
+        graph = graph_create_from_edges(DYNAMIC_VERTICES, sources, targets, num_edges, 1);
+    }
+    free(sources);
+    free(targets);
+    return graph;
+}
+
+// Checks BFS_DYNAMIC on a dynamic graph against BFS_SHORTEST_PATH on
+// a graph built from the bit matrix of its edges.
+//
+bool dynamic_graph_searches_match(struct dynamic_graph * dynamic, const uint8_t * edges) {
+    struct graph * graph       = create_graph_from_matrix(edges);
+    struct bfs_search * search = graph == NULL ? NULL : bfs_search_create(graph, NULL, NULL, NULL, dynamic, 0);
+    bool matches               = search != NULL;
+    for (size_t q = 0; matches && q < REACHABILITY_QUERIES; q++) {
+        unsigned int source, target;
+        next_query(q, DYNAMIC_VERTICES, &source, &target);
+        bool expected = bfs_search_run(search, BFS_SHORTEST_PATH, source, target);
+        matches       = bfs_search_run(search, BFS_DYNAMIC, source, target) == expected;
+    }
+    bfs_search_delete(search);
+    graph_delete(graph);
+    return matches;
+}
+#endif
+
+void check_dynamic_graph_functionality(void) {
+#ifdef TEST_DYNAMIC_GRAPH
+    TEST(dynamic_graph_check_updates)
+
+    SUBTEST(dynamic_graph_create)
+    uint8_t * edges = (uint8_t*)calloc(DYNAMIC_VERTICES * DYNAMIC_VERTICES, 1);
+    FAIL(edges == NULL,
+         "Failed to allocate edge matrix")
+    for (size_t e = 0; e < DYNAMIC_VERTICES; e++) {
+        edges[(next_random() % DYNAMIC_VERTICES) * DYNAMIC_VERTICES + next_random() % DYNAMIC_VERTICES] = 1;
+    }
+    struct graph * graph = create_graph_from_matrix(edges);
+    FAIL(graph == NULL,
+         "graph_create_from_edges() failed")
+    struct dynamic_graph * dynamic = dynamic_graph_create(graph);
+    FAIL(dynamic == NULL,
+         "dynamic_graph_create() failed")
+    FAIL(dynamic_graph_matches(dynamic, edges) == false,
+         "dynamic_graph_create() did not copy the graph")
+
+    // Growing to about a fifth of all pairs fills rows, and then the
+    // whole slot array, many times over. Half of the inserts go to a
+    // few rows, so that windows are respread unevenly.
+    //
+    SUBTEST(dynamic_graph_insert_edge)
+    for (size_t i = 0; i < 40000; i++) {
+        size_t source = i % 2 == 0 ? next_random() % 8 : next_random() % DYNAMIC_VERTICES;
+        size_t target = next_random() % DYNAMIC_VERTICES;
+        bool present  = edges[source * DYNAMIC_VERTICES + target] != 0;
+        FAIL(dynamic_graph_insert_edge(dynamic, (unsigned int)source, (unsigned int)target) == present,
+             "dynamic_graph_insert_edge() did not insert exactly the missing edges")
+        edges[source * DYNAMIC_VERTICES + target] = 1;
+    }
+    FAIL(dynamic->windows_respread == 0 || dynamic->reallocations == 0,
+         "dynamic_graph_insert_edge() never respread or reallocated")
+    FAIL(dynamic_graph_matches(dynamic, edges) == false,
+         "dynamic_graph_insert_edge() lost or invented edges")
+    FAIL(dynamic_graph_searches_match(dynamic, edges) == false,
+         "BFS_DYNAMIC disagrees with BFS_SHORTEST_PATH after inserts")
+
+    // Deleting almost everything drops the density below the minimum.
+    //
+    SUBTEST(dynamic_graph_delete_edge)
+    size_t reallocations = dynamic->reallocations;
+    for (size_t i = 0; i < 200000; i++) {
+        size_t source = next_random() % DYNAMIC_VERTICES;
+        size_t target = next_random() % DYNAMIC_VERTICES;
+        bool present  = edges[source * DYNAMIC_VERTICES + target] != 0;
+        FAIL(dynamic_graph_delete_edge(dynamic, (unsigned int)source, (unsigned int)target) != present,
+             "dynamic_graph_delete_edge() did not delete exactly the present edges")
+        edges[source * DYNAMIC_VERTICES + target] = 0;
+    }
+    FAIL(dynamic->reallocations == reallocations,
+         "dynamic_graph_delete_edge() never shrank the slots")
+    FAIL(dynamic_graph_matches(dynamic, edges) == false,
+         "dynamic_graph_delete_edge() lost or invented edges")
+    FAIL(dynamic_graph_searches_match(dynamic, edges) == false,
+         "BFS_DYNAMIC disagrees with BFS_SHORTEST_PATH after deletes")
+
+    SUBTEST(dynamic_graph_null_handling)
+    FAIL(dynamic_graph_insert_edge(dynamic, DYNAMIC_VERTICES, 0) != false
+         || dynamic_graph_delete_edge(dynamic, 0, DYNAMIC_VERTICES) != false
+         || dynamic_graph_has_edge(NULL, 0, 0) != false,
+         "dynamic_graph accepted an out of range vertex or NULL graph")
+
+    // Rows are sets, so parallel edges are copied once and a single
+    // deletion removes them.
+    //
+    SUBTEST(dynamic_graph_parallel_edges)
+    unsigned int parallel_sources[5] = { 0, 0, 0, 1, 1 };
+    unsigned int parallel_targets[5] = { 1, 2, 1, 0, 0 };
+    struct graph * parallel = graph_create_from_edges(DYNAMIC_VERTICES, parallel_sources, parallel_targets, 5, 1);
+    FAIL(parallel == NULL,
+         "graph_create_from_edges() failed")
+    struct dynamic_graph * deduplicated = dynamic_graph_create(parallel);
+    FAIL(deduplicated == NULL || deduplicated->num_edges != 3
+         || deduplicated->rows[0].degree != 2 || deduplicated->rows[1].degree != 1,
+         "dynamic_graph_create() kept parallel edges")
+    FAIL(dynamic_graph_delete_edge(deduplicated, 0, 1) == false
+         || dynamic_graph_has_edge(deduplicated, 0, 1) != false
+         || dynamic_graph_insert_edge(deduplicated, 0, 1) == false,
+         "dynamic_graph_delete_edge() left a parallel edge behind")
+    dynamic_graph_delete(deduplicated);
+    graph_delete(parallel);
+
+    dynamic_graph_delete(dynamic);
+    graph_delete(graph);
+    free(edges);
+
+    PASS(dynamic_graph_check_updates)
+#endif
+}
+
+#ifdef TEST_QUERY_SERVER
+// Chunks a client writes to the server, each in its own write() a
+// little after the last, so that the server reads them apart. They
+// cover pipelined and malformed requests, lines longer than
+// QUERY_SERVER_MAX_LINE, one of them split, a request split in two,
+// and a last request with no newline.
+//
+const char * query_server_test_chunks[] = {
+    "1 2\n3 4\n5 6\n0 0\n",
+    "abc\n1\n1 2 3\n4294967296 1\n\n",
+    "                                                                                1 2\n",
+    "111111111111111111111111111111111111111111111111111111111111111111111111",
+    "111 1\n7 8\n",
+    "12 3",
+    "4\n",
+    "9 10",
+};
+
+// Replies expected for the chunks, 1 marks a request that needs a
+// search and -1 one that is malformed.
+//
+const unsigned int query_server_test_sources[] = { 1, 3, 5, 0, 0, 0, 0, 0, 0, 0, 0, 7, 12, 9 };
+const unsigned int query_server_test_targets[] = { 2, 4, 6, 0, 0, 0, 0, 0, 0, 0, 0, 8, 34, 10 };
+const int query_server_test_replies[]          = { 1, 1, 1, 1, -1, -1, -1, -1, -1, -1, -1, 1, 1, 1 };
+
+// Writes the test chunks to a descriptor and closes it.
+//
+void * query_server_test_client(void * arg) {
+    int fd = *(int*)arg;
+    for (size_t c = 0; c < sizeof(query_server_test_chunks) / sizeof(query_server_test_chunks[0]); c++) {
+        size_t length = strlen(query_server_test_chunks[c]);
+        if (write(fd, query_server_test_chunks[c], length) != (ssize_t)length) {
+            break;
+        }
+        usleep(20000);
+    }
+    close(fd);
+    return NULL;
+}
+#endif
+
+void check_query_server_functionality(void) {
+#ifdef TEST_QUERY_SERVER
+    TEST(query_server_check_pipe)
+
+    SUBTEST(query_server_create)
+    struct graph * graph = create_random_graph(REACHABILITY_VERTICES, BFS_DENSE_EDGES);
+    FAIL(graph == NULL,
+         "graph_create_from_edges() failed")
+    struct bfs_search * search = bfs_search_create(graph, NULL, NULL, NULL, NULL, 0);
+    FAIL(search == NULL,
+         "bfs_search_create() failed")
+    struct query_executor * executor = query_executor_create(graph, NULL, NULL, NULL, NULL,
+                                                             BFS_SHORTEST_PATH, 2);
+    FAIL(executor == NULL,
+         "query_executor_create() failed")
+    struct query_server * server = query_server_create(executor);
+    FAIL(server == NULL,
+         "query_server_create() failed")
+
+    // The replies fit in the pipe, so the server never waits on the
+    // reader.
+    //
+    SUBTEST(query_server_serve)
+    int requests[2], replies[2];
+    FAIL(pipe(requests) != 0 || pipe(replies) != 0,
+         "pipe() failed")
+    pthread_t client;
+    FAIL(pthread_create(&client, NULL, query_server_test_client, &requests[1]) != 0,
+         "pthread_create() failed")
+    FAIL(query_server_serve(server, requests[0], replies[1]) == false,
+         "query_server_serve() failed")
+    pthread_join(client, NULL);
+    close(requests[0]);
+    close(replies[1]);
+
+    SUBTEST(query_server_replies)
+    char output[1024];
+    size_t bytes = 0;
+    ssize_t count;
+    while ((count = read(replies[0], output + bytes, sizeof(output) - 1 - bytes)) > 0) {
+        bytes += (size_t)count;
+    }
+    close(replies[0]);
+    output[bytes] = '\0';
+
+    size_t num_replies = sizeof(query_server_test_replies) / sizeof(query_server_test_replies[0]);
+    const char * cursor = output;
+    for (size_t r = 0; r < num_replies; r++) {
+        int found;
+        long nanoseconds;
+        int consumed;
+        FAIL(sscanf(cursor, "%d %ld\n%n", &found, &nanoseconds, &consumed) != 2,
+             "query_server_serve() sent too few replies")
+        cursor += consumed;
+        if (query_server_test_replies[r] < 0) {
+            FAIL(found != -1 || nanoseconds != 0,
+                 "query_server_serve() did not reject a malformed request with -1 0")
+        } else {
+            bool expected = bfs_search_run(search, BFS_SHORTEST_PATH, query_server_test_sources[r],
+                                           query_server_test_targets[r]);
+            FAIL(found != (expected ? 1 : 0) || nanoseconds < 0,
+                 "query_server_serve() reply disagrees with BFS_SHORTEST_PATH")
+        }
+    }
+    FAIL(*cursor != '\0',
+         "query_server_serve() sent too many replies")
+    FAIL(server->queries != num_replies || server->malformed != 7,
+         "query_server_serve() counted its requests wrong")
+
+    query_server_delete(server);
+    query_executor_delete(executor);
+    bfs_search_delete(search);
+    graph_delete(graph);
+
+    PASS(query_server_check_pipe)
+#endif
+}
+
+#ifdef TEST_BENCH_STATS
+// Returns TRUE if two statistics agree to within tolerance.
+//
+bool bench_stats_close(double value, double expected, double tolerance) {
+    return fabs(value - expected) <= tolerance;
+}
+
+// Returns the t quantile the mean interval of stats was computed with.
+//
+double bench_stats_t_of(const struct bench_stats * stats) {
+    return (stats->mean_ci_high - stats->mean) * sqrt((double)stats->count) / stats->stddev;
+}
+#endif
+
+void check_bench_stats_functionality(void) {
+#ifdef TEST_BENCH_STATS
+    TEST(bench_stats_check_ranks)
+
+    SUBTEST(bench_stats_median)
+    struct bench_stats stats;
+    long odd[3]  = { 5, 1, 3 };
+    long even[4] = { 4, 1, 3, 2 };
+    FAIL(bench_stats_compute(odd, 0, &stats) != false,
+         "bench_stats_compute() accepted no samples")
+    FAIL(bench_stats_compute(odd, 3, &stats) == false || stats.median != 3.0
+         || odd[0] != 1 || odd[1] != 3 || odd[2] != 5,
+         "bench_stats_compute() median of an odd count is not the middle sample")
+    FAIL(bench_stats_compute(even, 4, &stats) == false || stats.median != 2.5
+         || stats.min != 1.0 || stats.max != 4.0 || stats.mean != 2.5,
+         "bench_stats_compute() median of an even count is not the middle pair's mean")
+
+    // Nearest rank: the smallest sample with at least p percent of
+    // the samples at or below it.
+    //
+    SUBTEST(bench_stats_percentiles)
+    long samples[BENCH_SAMPLES];
+    size_t counts[3] = { 1, 10, BENCH_SAMPLES };
+    double p90[3]    = { 1.0, 9.0, 90.0 };
+    double p99[3]    = { 1.0, 10.0, 99.0 };
+    for (size_t c = 0; c < 3; c++) {
+        for (size_t i = 0; i < counts[c]; i++) {
+            samples[i] = (long)((i * 37) % counts[c]) + 1;
+        }
+        FAIL(bench_stats_compute(samples, counts[c], &stats) == false
+             || stats.p90 != p90[c] || stats.p99 != p99[c],
+             "bench_stats_compute() percentiles do not follow the nearest-rank rule")
+    }
+
+    // Ranks n/2 -+ z sqrt(n)/2 clamp to the whole range for up to
+    // three samples, and give ranks 40 and 61 at 100.
+    //
+    SUBTEST(bench_stats_median_ci)
+    for (size_t count = 1; count <= 3; count++) {
+        for (size_t i = 0; i < count; i++) {
+            samples[i] = (long)(10 * (count - i));
+        }
+        FAIL(bench_stats_compute(samples, count, &stats) == false
+             || stats.median_ci_low != 10.0 || stats.median_ci_high != (double)(10 * count),
+             "bench_stats_compute() median interval of a few samples is not their range")
+    }
+    for (size_t i = 0; i < BENCH_SAMPLES; i++) {
+        samples[i] = (long)(BENCH_SAMPLES - i);
+    }
+    FAIL(bench_stats_compute(samples, BENCH_SAMPLES, &stats) == false
+         || stats.median_ci_low != 40.0 || stats.median_ci_high != 61.0,
+         "bench_stats_compute() median interval ranks are wrong")
+
+    // 30 degrees of freedom is the last table entry, 31 the first
+    // from the Cornish-Fisher expansion, whose exact quantile is
+    // 2.039513.
+    //
+    SUBTEST(bench_stats_t_quantile)
+    for (size_t i = 0; i < 32; i++) {
+        samples[i] = (long)((i * 7919) % 1000);
+    }
+    FAIL(bench_stats_compute(samples, 31, &stats) == false
+         || bench_stats_close(bench_stats_t_of(&stats), 2.042, 1e-9) == false,
+         "bench_stats_compute() t quantile at 30 degrees is not the table's")
+
+    // The samples were sorted in place, so draw them again.
+    //
+    for (size_t i = 0; i < 32; i++) {
+        samples[i] = (long)((i * 7919) % 1000);
+    }
+    FAIL(bench_stats_compute(samples, 32, &stats) == false
+         || bench_stats_close(bench_stats_t_of(&stats), 2.039513, 1e-4) == false,
+         "bench_stats_compute() t quantile at 31 degrees is off")
+    FAIL(bench_stats_close(stats.mean_ci_low + stats.mean_ci_high, 2.0 * stats.mean, 1e-9) == false,
+         "bench_stats_compute() mean interval is not centered on the mean")
+
+    PASS(bench_stats_check_ranks)
+#endif
+}
+
+int main(void) {
+    // Set up signal handler for catching infinite loops.
+    //
+    signal(SIGALRM, gracefully_exit_on_suspected_infinite_loop);
+
+    // Searches allocate their queues through the queue's allocator.
+    //
+    queue_register_malloc(&custom_malloc);
+    queue_register_free(&custom_free);
+
+    bump_ptr_setup();
+
+    check_mm_fast_functionality();
+    check_graph_build_functionality();
+    check_bfs_bidirectional_functionality();
+    check_bfs_direction_optimizing_functionality();
+    check_bfs_parallel_functionality();
+    check_query_executor_functionality();
+    check_msbfs_functionality();
+    check_bfs_shortest_path_functionality();
+    check_graph_order_functionality();
+    check_compressed_graph_functionality();
+    check_external_graph_functionality();
+    check_pll_index_functionality();
+    check_scc_functionality();
+    check_grail_functionality();
+    check_dynamic_graph_functionality();
+    check_query_server_functionality();
+    check_bench_stats_functionality();
+
+    bump_ptr_cleanup();
+
+    return 0;
+}
@@ -128,6 +128,7 @@ bool linked_list_insert(struct linked_list* ll,
         ll->head = new_node;
         if (ll_size == 0) ll->tail = ll->head;
     } else if (index == ll_size) {
+        new_node->next = NULL;
         ll->tail->next = new_node;
         ll->tail = new_node;
     } else {
@@ -184,9 +185,7 @@ bool linked_list_remove(struct linked_list * ll,
     }
 
     if (index == 0) {
-        struct node* to_remove = ll->head;
-        ll->head = ll->head->next;
-        free_fptr(to_remove);
+        return linked_list_remove_front(ll);
     } else {
         struct iterator iter;
         _linked_list_init_iterator(&iter, ll, index-1);
@@ -204,6 +203,44 @@ bool linked_list_remove(struct linked_list * ll,
     return true;
 }
 
+// Reads the data at the head of the linked_list in O(1), without
+// creating an iterator.
+// \param ll   : Pointer to linked_list.
+// \param data : Pointer to data (provided by caller), written on success.
+// Returns TRUE on success, FALSE if the list is empty or NULL.
+//
+bool linked_list_front(struct linked_list* ll,
+                       unsigned int* data)
+{
+    if (ll == NULL || ll->size == 0) {
+        return false;
+    }
+
+    *data = ll->head->data;
+    return true;
+}
+
+// Unlinks and frees the head node of the linked_list in O(1).
+// \param ll : Pointer to linked_list.
+// Returns TRUE on success, FALSE if the list is empty or NULL.
+//
+bool linked_list_remove_front(struct linked_list* ll) {
+    if (ll == NULL || ll->size == 0) {
+        return false;
+    }
+
+    struct node* to_remove = ll->head;
+    ll->head = to_remove->next;
+    if (ll->size == 1) {
+        ll->head = NULL;
+        ll->tail = NULL;
+    }
+    free_fptr(to_remove);
+
+    ll->size -= 1;
+    return true;
+}
+
 // Creates an iterator struct at a particular index.
 // \param linked_list : Pointer to linked_list.
 // \param index       : Index of the linked list to start at.
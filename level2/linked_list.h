@@ -109,6 +109,21 @@ size_t linked_list_find(struct linked_list* ll,
 bool linked_list_remove(struct linked_list* ll,
                         size_t index);
 
+// Reads the data at the head of the linked_list in O(1), without
+// creating an iterator.
+// \param ll   : Pointer to linked_list.
+// \param data : Pointer to data (provided by caller), written on success.
+// Returns TRUE on success, FALSE if the list is empty or NULL.
+//
+bool linked_list_front(struct linked_list* ll,
+                       unsigned int* data);
+
+// Unlinks and frees the head node of the linked_list in O(1).
+// \param ll : Pointer to linked_list.
+// Returns TRUE on success, FALSE if the list is empty or NULL.
+//
+bool linked_list_remove_front(struct linked_list* ll);
+
 // Creates an iterator struct at a particular index.
 // \param linked_list : Pointer to linked_list.
 // \param index       : Index of the linked list to start at.
@@ -1,3 +1,4 @@
+#include <pthread.h>
 #include <signal.h>
 #include <stdbool.h>
 #include <stdio.h>
@@ -7,6 +8,7 @@
 
 #include "bump_ptr_allocator.h"
 #include "linked_list.h"
+#include "pqueue.h"
 #include "queue.h"
 
 // Check that valid compiler defines have been passed in.
@@ -19,6 +21,10 @@
 #define VALID_TEST
 #endif
 
+#ifdef TEST_PQUEUE
+#define VALID_TEST
+#endif
+
 #ifndef VALID_TEST
 #error "Improper set of compiler defines specified, check Makefile"
 #endif
@@ -146,6 +152,27 @@ void check_null_handling(void) {
     FAIL(popped_value != 7,
          "queue_pop(NULL, &popped_value) modified the variable popped_value")
 
+    SUBTEST(queue_push_n)
+    unsigned int push_values[2] = {1, 2};
+    status = queue_push_n(NULL, push_values, 2);
+    FAIL(status != false,
+         "queue_push_n(NULL, push_values, 2) did not return false");
+
+    SUBTEST(queue_pop_n)
+    size_t popped_count = queue_pop_n(NULL, push_values, 2);
+    FAIL(popped_count != 0,
+         "queue_pop_n(NULL, push_values, 2) did not return 0");
+
+    SUBTEST(queue_reserve)
+    status = queue_reserve(NULL, 16);
+    FAIL(status != false,
+         "queue_reserve(NULL, 16) did not return false");
+
+    SUBTEST(queue_clear)
+    status = queue_clear(NULL);
+    FAIL(status != false,
+         "queue_clear(NULL) did not return false");
+
     SUBTEST(queue_size)
     size_t size = queue_size(NULL);
     FAIL(size != SIZE_MAX,
@@ -478,6 +505,297 @@ void check_insertion_functionality(void) {
 #endif
 }
 
+void check_queue_batch_functionality(void) {
+#ifdef TEST_QUEUE
+    TEST(check_queue_batch_functionality)
+
+    SUBTEST(queue_push_n_grow)
+    // Push more values than the default capacity in a few batches,
+    // so that the ring buffer has to grow.
+    //
+    struct queue * queue = queue_create();
+    FAIL(queue == NULL,
+         "Failed to create new queue.")
+    unsigned int values[3 * QUEUE_DEFAULT_CAPACITY];
+    for (size_t i = 0; i < 3 * QUEUE_DEFAULT_CAPACITY; i++) {
+        values[i] = i;
+    }
+    for (size_t i = 0; i < 3; i++) {
+        bool status = queue_push_n(queue, values + i * QUEUE_DEFAULT_CAPACITY,
+                                   QUEUE_DEFAULT_CAPACITY);
+        FAIL(status == false,
+             "queue_push_n() failed on valid queue")
+    }
+    size_t size = queue_size(queue);
+    FAIL(size != 3 * QUEUE_DEFAULT_CAPACITY,
+         "queue_size() incorrect after queue_push_n()")
+
+    SUBTEST(queue_pop_n_order)
+    unsigned int popped[100];
+    size_t expected = 0;
+    size_t count    = 0;
+    while ((count = queue_pop_n(queue, popped, 100)) > 0) {
+        for (size_t i = 0; i < count; i++) {
+            FAIL(popped[i] != expected,
+                 "queue_pop_n() returned values out of order")
+            ++expected;
+        }
+    }
+    FAIL(expected != 3 * QUEUE_DEFAULT_CAPACITY,
+         "queue_pop_n() did not return every pushed value")
+    FAIL(queue_has_next(queue) != false,
+         "queue_has_next() returned true after queue_pop_n() drained the queue")
+
+    SUBTEST(queue_batch_wraparound)
+    // Interleave single and batched operations so the head and tail
+    // wrap around the end of the ring buffer.
+    //
+    unsigned int next_push = 0;
+    unsigned int next_pop  = 0;
+    for (size_t round = 0; round < 50; round++) {
+        unsigned int batch[37];
+        for (size_t i = 0; i < 37; i++) {
+            batch[i] = next_push++;
+        }
+        FAIL(queue_push_n(queue, batch, 37) == false,
+             "queue_push_n() failed during wraparound test")
+        FAIL(queue_push(queue, next_push++) == false,
+             "queue_push() failed during wraparound test")
+
+        unsigned int data = 0;
+        FAIL(queue_pop(queue, &data) == false || data != next_pop++,
+             "queue_pop() returned wrong value during wraparound test")
+        count = queue_pop_n(queue, popped, 30);
+        for (size_t i = 0; i < count; i++) {
+            FAIL(popped[i] != next_pop++,
+                 "queue_pop_n() returned wrong value during wraparound test")
+        }
+    }
+    while ((count = queue_pop_n(queue, popped, 100)) > 0) {
+        for (size_t i = 0; i < count; i++) {
+            FAIL(popped[i] != next_pop++,
+                 "queue_pop_n() returned wrong value while draining")
+        }
+    }
+    FAIL(next_pop != next_push,
+         "Number of values popped does not match number pushed")
+
+    SUBTEST(queue_reserve_keeps_contents)
+    for (size_t i = 0; i < 10; i++) {
+        queue_push(queue, i);
+    }
+    FAIL(queue_reserve(queue, 8 * QUEUE_DEFAULT_CAPACITY) == false,
+         "queue_reserve() failed on valid queue")
+    FAIL(queue->capacity < 8 * QUEUE_DEFAULT_CAPACITY,
+         "queue_reserve() did not grow the queue")
+    count = queue_pop_n(queue, popped, 100);
+    FAIL(count != 10,
+         "queue_reserve() changed the number of queued values")
+    for (size_t i = 0; i < count; i++) {
+        FAIL(popped[i] != i,
+             "queue_reserve() did not preserve queued values")
+    }
+
+    SUBTEST(queue_clear_keeps_capacity)
+    size_t capacity = queue->capacity;
+    queue_push_n(queue, values, 100);
+    FAIL(queue_clear(queue) == false,
+         "queue_clear() failed on valid queue")
+    FAIL(queue_size(queue) != 0 || queue_has_next(queue) != false,
+         "queue_clear() did not empty the queue")
+    FAIL(queue->capacity != capacity,
+         "queue_clear() changed the capacity of the queue")
+    queue_push(queue, 42);
+    unsigned int data = 0;
+    FAIL(queue_pop(queue, &data) == false || data != 42,
+         "queue unusable after queue_clear()")
+
+    queue_delete(queue);
+    PASS(check_queue_batch_functionality)
+#endif
+}
+
+#ifdef TEST_QUEUE
+// Consumer thread for the blocking queue test. Pops values until it
+// sees 0, and records how many it received.
+//
+void * blocking_queue_consumer(void * arg) {
+    struct queue * queue = (struct queue *)arg;
+    size_t received      = 0;
+    unsigned int data    = 0;
+    while (queue_pop_wait(queue, &data, -1) && data != 0) {
+        ++received;
+    }
+    return (void *)received;
+}
+#endif
+
+void check_blocking_queue_functionality(void) {
+#ifdef TEST_QUEUE
+    TEST(check_blocking_queue_functionality)
+
+    SUBTEST(queue_pop_wait_non_blocking_queue)
+    struct queue * queue = queue_create();
+    unsigned int data    = 7;
+    FAIL(queue_pop_wait(queue, &data, 0) != false || data != 7,
+         "queue_pop_wait() succeeded on a non-blocking queue")
+    queue_delete(queue);
+
+    SUBTEST(queue_pop_wait_timeout)
+    queue = queue_create_blocking();
+    FAIL(queue == NULL,
+         "Failed to create blocking queue.")
+    FAIL(queue_pop_wait(queue, &data, 1000000L) != false || data != 7,
+         "queue_pop_wait() on empty queue did not time out")
+
+    SUBTEST(queue_pop_wait_ready)
+    queue_push(queue, 5);
+    FAIL(queue_pop_wait(queue, &data, 0) == false || data != 5,
+         "queue_pop_wait() did not pop an available value")
+
+    SUBTEST(queue_pop_wait_producer_consumer)
+    // Two consumers sleep on the empty queue while this thread
+    // produces. Each consumer stops at a 0.
+    //
+    pthread_t consumers[2];
+    for (size_t i = 0; i < 2; i++) {
+        pthread_create(&consumers[i], NULL, blocking_queue_consumer, queue);
+    }
+    unsigned int values[100];
+    for (size_t i = 0; i < 100; i++) {
+        values[i] = i + 1;
+    }
+    for (size_t round = 0; round < 10; round++) {
+        FAIL(queue_push_n(queue, values, 100) == false,
+             "queue_push_n() failed on blocking queue")
+        usleep(1000);
+    }
+    queue_push(queue, 0);
+    queue_push(queue, 0);
+
+    size_t received = 0;
+    for (size_t i = 0; i < 2; i++) {
+        void * consumer_received = NULL;
+        pthread_join(consumers[i], &consumer_received);
+        received += (size_t)consumer_received;
+    }
+    FAIL(received != 1000,
+         "Consumers did not receive every value pushed")
+    FAIL(queue_size(queue) != 0,
+         "Blocking queue not empty after consumers finished")
+
+    queue_delete(queue);
+    PASS(check_blocking_queue_functionality)
+#endif
+}
+
+void check_pqueue_functionality(void) {
+#ifdef TEST_PQUEUE
+    TEST(pqueue_check_null_handling)
+    unsigned int item = 7;
+    double key        = 0.0;
+    SUBTEST(pqueue_push)
+    FAIL(pqueue_push(NULL, 1, 1.0) != false,
+         "pqueue_push(NULL, 1, 1.0) did not return false")
+    SUBTEST(pqueue_pop)
+    FAIL(pqueue_pop(NULL, &item, &key) != false || item != 7,
+         "pqueue_pop(NULL, &item, &key) did not return false")
+    SUBTEST(pqueue_size)
+    FAIL(pqueue_size(NULL) != SIZE_MAX,
+         "pqueue_size(NULL) did not return SIZE_MAX")
+    SUBTEST(radix_heap_push)
+    FAIL(radix_heap_push(NULL, 1, 1) != false,
+         "radix_heap_push(NULL, 1, 1) did not return false")
+    SUBTEST(radix_heap_size)
+    FAIL(radix_heap_size(NULL) != SIZE_MAX,
+         "radix_heap_size(NULL) did not return SIZE_MAX")
+    PASS(pqueue_check_null_handling)
+
+    TEST(check_pqueue_ordering)
+    SUBTEST(pqueue_pop_sorted)
+    // Push a scrambled permutation of keys and make sure they pop in
+    // order. 7919 is prime, so i * 7919 mod 1000 visits every key.
+    //
+    struct pqueue * pq = pqueue_create(1000);
+    FAIL(pq == NULL,
+         "Failed to create pqueue.")
+    for (unsigned int i = 0; i < 1000; i++) {
+        unsigned int k = (i * 7919) % 1000;
+        FAIL(pqueue_push(pq, k, (double)k) == false,
+             "pqueue_push() failed on valid pqueue")
+    }
+    FAIL(pqueue_size(pq) != 1000,
+         "pqueue_size() did not return 1000")
+    for (unsigned int i = 0; i < 1000; i++) {
+        FAIL(pqueue_pop(pq, &item, &key) == false,
+             "pqueue_pop() failed on non-empty pqueue")
+        FAIL(item != i || key != (double)i,
+             "pqueue_pop() returned items out of order")
+    }
+    FAIL(pqueue_pop(pq, &item, &key) != false,
+         "pqueue_pop() succeeded on empty pqueue")
+
+    SUBTEST(pqueue_decrease_key)
+    for (unsigned int i = 0; i < 100; i++) {
+        pqueue_push(pq, i, 100.0 + i);
+    }
+    FAIL(pqueue_decrease_key(pq, 57, 1.0) == false,
+         "pqueue_decrease_key() failed for item in heap")
+    FAIL(pqueue_decrease_key(pq, 58, 1000.0) != false,
+         "pqueue_decrease_key() allowed a key to increase")
+    FAIL(pqueue_decrease_key(pq, 500, 1.0) != false,
+         "pqueue_decrease_key() succeeded for item not in heap")
+    pqueue_push(pq, 3, 0.5);
+    FAIL(pqueue_next(pq, &item, &key) == false || item != 3 || key != 0.5,
+         "pqueue_push() of a present item did not decrease its key")
+    pqueue_pop(pq, &item, NULL);
+    FAIL(pqueue_pop(pq, &item, &key) == false || item != 57 || key != 1.0,
+         "Decreased key did not pop first")
+    FAIL(pqueue_contains(pq, 57) != false || pqueue_contains(pq, 58) != true,
+         "pqueue_contains() disagrees with heap contents")
+
+    SUBTEST(pqueue_clear)
+    FAIL(pqueue_clear(pq) == false || pqueue_size(pq) != 0,
+         "pqueue_clear() did not empty the pqueue")
+    FAIL(pqueue_contains(pq, 58) != false,
+         "pqueue_clear() left a stale position behind")
+    pqueue_delete(pq);
+    PASS(check_pqueue_ordering)
+
+    TEST(check_radix_heap_ordering)
+    SUBTEST(radix_heap_monotone)
+    // Mimic Dijkstra: every pushed key is at least the last popped one.
+    //
+    struct radix_heap * rh = radix_heap_create();
+    FAIL(rh == NULL,
+         "Failed to create radix_heap.")
+    for (unsigned int i = 0; i < 500; i++) {
+        radix_heap_push(rh, i, (i * 7919) % 500);
+    }
+    uint64_t last   = 0;
+    uint64_t rh_key = 0;
+    size_t popped   = 0;
+    while (radix_heap_pop(rh, &item, &rh_key)) {
+        FAIL(rh_key < last,
+             "radix_heap_pop() returned keys out of order")
+        last = rh_key;
+        ++popped;
+        if (popped % 3 == 0) {
+            FAIL(radix_heap_push(rh, item, rh_key + popped) == false,
+                 "radix_heap_push() of a monotone key failed")
+        }
+    }
+    // Every third pop re-pushes one item: 500 pushes plus 249 re-pushes.
+    //
+    FAIL(popped != 749,
+         "radix_heap_pop() did not return every pushed item")
+    FAIL(radix_heap_push(rh, 0, last - 1) != false,
+         "radix_heap_push() accepted a key below the last popped key")
+    radix_heap_delete(rh);
+    PASS(check_radix_heap_ordering)
+#endif
+}
+
 void check_linked_list_find_functionality(void) {
 #ifdef TEST_LINKED_LIST
     TEST(check_linked_list_find_functionality)
@@ -555,6 +873,32 @@ void check_linked_list_additional_delete_tests(void) {
     FAIL(status == false,
          "Failed to delete non-empty linked_list.")
 
+    SUBTEST(front_and_remove_front)
+    // Drain a list through the O(1) head fast path, then make sure
+    // the list is usable again once empty.
+    //
+    ll = linked_list_create();
+    for (size_t i = 1; i <= 5; i++) {
+        linked_list_insert_end(ll, i);
+    }
+    for (size_t i = 1; i <= 5; i++) {
+        unsigned int data = 0;
+        status = linked_list_front(ll, &data);
+        FAIL(status == false || data != i,
+             "linked_list_front() did not return the head value")
+        status = linked_list_remove_front(ll);
+        FAIL(status == false,
+             "linked_list_remove_front() failed on non-empty linked_list")
+    }
+    unsigned int data = 7;
+    FAIL(linked_list_front(ll, &data) != false || data != 7,
+         "linked_list_front() succeeded on empty linked_list")
+    FAIL(linked_list_remove_front(ll) != false,
+         "linked_list_remove_front() succeeded on empty linked_list")
+    FAIL(linked_list_insert_end(ll, 9) == false || linked_list_front(ll, &data) == false || data != 9,
+         "linked_list unusable after being drained by linked_list_remove_front()")
+    linked_list_delete(ll);
+
     PASS(linked_list_additional_delete_tests)
 #endif 
 }
@@ -570,12 +914,17 @@ int main(void) {
     linked_list_register_free(&custom_free);
     queue_register_malloc(&instrumented_malloc);
     queue_register_free(&custom_free);
+    pqueue_register_malloc(&instrumented_malloc);
+    pqueue_register_free(&custom_free);
 
     bump_ptr_setup();
 
     check_null_handling();
     check_empty_list_and_queue_properties();
     check_insertion_functionality();
+    check_queue_batch_functionality();
+    check_blocking_queue_functionality();
+    check_pqueue_functionality();
     check_linked_list_find_functionality();
 
     check_linked_list_additional_delete_tests();
@@ -0,0 +1,568 @@
+// MIT License. Copyright (c) 2025 Kshitij Jain
+// See LICENSE file in the root of this repository.
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define MM_FAST_SSE2
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define MM_FAST_NEON
+#endif
+
+#include "mmio.h"
+#include "mm_fast.h"
+
+// Bytes examined per SIMD compare.
+//
+#define MM_FAST_BLOCK_BYTES 16
+
+// Upper bound on the threads mm_read_crd_pattern_fast() uses.
+//
+#define MM_FAST_MAX_THREADS 256
+
+// Longest index accepted, UINT32_MAX has ten digits.
+//
+#define MM_FAST_MAX_DIGITS 10
+
+static inline bool _mm_fast_is_space(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+static inline bool _mm_fast_is_digit(char c) {
+    return (unsigned char)(c - '0') < 10;
+}
+
+#if defined(MM_FAST_NEON)
+// NEON has no movemask. Narrowing each 16-bit lane by 4 leaves one
+// nibble per byte, so the index of the first set byte is ctz / 4.
+//
+static inline size_t _mm_fast_neon_first(uint8x16_t matches) {
+    uint64_t nibbles = vget_lane_u64(vreinterpret_u64_u8(
+        vshrn_n_u16(vreinterpretq_u16_u8(matches), 4)), 0);
+    return nibbles == 0 ? MM_FAST_BLOCK_BYTES : (size_t)__builtin_ctzll(nibbles) / 4;
+}
+#endif
+
+// Internal utility functions that classify a 16 byte block and return
+// the index of the first byte in it that is a newline, is not a digit,
+// or is not whitespace respectively. 16 means no such byte.
+// PRECONDITION: 16 bytes are readable at p.
+//
+static inline size_t _mm_fast_first_newline(const char* p) {
+#if defined(MM_FAST_SSE2)
+    __m128i block = _mm_loadu_si128((const __m128i*)p);
+    uint32_t mask = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(block, _mm_set1_epi8('\n')));
+    return mask == 0 ? MM_FAST_BLOCK_BYTES : (size_t)__builtin_ctz(mask);
+#elif defined(MM_FAST_NEON)
+    uint8x16_t block = vld1q_u8((const uint8_t*)p);
+    return _mm_fast_neon_first(vceqq_u8(block, vdupq_n_u8('\n')));
+#else
+    for (size_t i = 0; i < MM_FAST_BLOCK_BYTES; i++) {
+        if (p[i] == '\n') {
+            return i;
+        }
+    }
+    return MM_FAST_BLOCK_BYTES;
+#endif
+}
+
+static inline size_t _mm_fast_first_non_digit(const char* p) {
+#if defined(MM_FAST_SSE2)
+    __m128i block  = _mm_loadu_si128((const __m128i*)p);
+    __m128i digits = _mm_and_si128(_mm_cmpgt_epi8(block, _mm_set1_epi8('0' - 1)),
+                                   _mm_cmplt_epi8(block, _mm_set1_epi8('9' + 1)));
+    uint32_t mask = ~(uint32_t)_mm_movemask_epi8(digits) & 0xffff;
+    return mask == 0 ? MM_FAST_BLOCK_BYTES : (size_t)__builtin_ctz(mask);
+#elif defined(MM_FAST_NEON)
+    uint8x16_t offset = vsubq_u8(vld1q_u8((const uint8_t*)p), vdupq_n_u8('0'));
+    return _mm_fast_neon_first(vcgeq_u8(offset, vdupq_n_u8(10)));
+#else
+    for (size_t i = 0; i < MM_FAST_BLOCK_BYTES; i++) {
+        if (!_mm_fast_is_digit(p[i])) {
+            return i;
+        }
+    }
+    return MM_FAST_BLOCK_BYTES;
+#endif
+}
+
+static inline size_t _mm_fast_first_non_space(const char* p) {
+#if defined(MM_FAST_SSE2)
+    __m128i block = _mm_loadu_si128((const __m128i*)p);
+    __m128i space = _mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8(' ')),
+                     _mm_cmpeq_epi8(block, _mm_set1_epi8('\t'))),
+        _mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8('\r')),
+                     _mm_cmpeq_epi8(block, _mm_set1_epi8('\n'))));
+    uint32_t mask = ~(uint32_t)_mm_movemask_epi8(space) & 0xffff;
+    return mask == 0 ? MM_FAST_BLOCK_BYTES : (size_t)__builtin_ctz(mask);
+#elif defined(MM_FAST_NEON)
+    uint8x16_t block = vld1q_u8((const uint8_t*)p);
+    uint8x16_t space = vorrq_u8(
+        vorrq_u8(vceqq_u8(block, vdupq_n_u8(' ')), vceqq_u8(block, vdupq_n_u8('\t'))),
+        vorrq_u8(vceqq_u8(block, vdupq_n_u8('\r')), vceqq_u8(block, vdupq_n_u8('\n'))));
+    return _mm_fast_neon_first(vmvnq_u8(space));
+#else
+    for (size_t i = 0; i < MM_FAST_BLOCK_BYTES; i++) {
+        if (!_mm_fast_is_space(p[i])) {
+            return i;
+        }
+    }
+    return MM_FAST_BLOCK_BYTES;
+#endif
+}
+
+// Internal utility function that finds the next newline.
+// \param p   : Start of the scan.
+// \param end : End of the mapped file.
+// Returns a pointer to the newline, or end if there is none.
+//
+static const char* _mm_fast_find_newline(const char* p, const char* end) {
+    while (end - p >= MM_FAST_BLOCK_BYTES) {
+        size_t i = _mm_fast_first_newline(p);
+        if (i < MM_FAST_BLOCK_BYTES) {
+            return p + i;
+        }
+        p += MM_FAST_BLOCK_BYTES;
+    }
+    while (p < end && *p != '\n') {
+        ++p;
+    }
+    return p;
+}
+
+// Internal utility function that counts newlines.
+// \param p   : Start of the scan.
+// \param end : End of the scan.
+// Returns the number of newlines in [p, end).
+//
+static size_t _mm_fast_count_newlines(const char* p, const char* end) {
+    size_t count = 0;
+    while (end - p >= MM_FAST_BLOCK_BYTES) {
+#if defined(MM_FAST_SSE2)
+        __m128i block = _mm_loadu_si128((const __m128i*)p);
+        count += (size_t)__builtin_popcount(
+            (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(block, _mm_set1_epi8('\n'))));
+#elif defined(MM_FAST_NEON)
+        uint8x16_t block = vld1q_u8((const uint8_t*)p);
+        count += vaddvq_u8(vandq_u8(vceqq_u8(block, vdupq_n_u8('\n')), vdupq_n_u8(1)));
+#else
+        for (size_t i = 0; i < MM_FAST_BLOCK_BYTES; i++) {
+            count += p[i] == '\n';
+        }
+#endif
+        p += MM_FAST_BLOCK_BYTES;
+    }
+    while (p < end) {
+        count += *p++ == '\n';
+    }
+    return count;
+}
+
+// Internal utility function that skips whitespace, newlines included.
+// Fields are usually separated by exactly one byte, so that case is
+// checked before falling back to block compares.
+// \param p   : Start of the scan.
+// \param end : End of the mapped file.
+// Returns a pointer to the next non-whitespace byte, or end.
+//
+static inline const char* _mm_fast_skip_space(const char* p, const char* end) {
+    if (p < end && !_mm_fast_is_space(*p)) {
+        return p;
+    }
+    if (p + 1 < end && !_mm_fast_is_space(p[1])) {
+        return p + 1;
+    }
+    while (end - p >= MM_FAST_BLOCK_BYTES) {
+        size_t i = _mm_fast_first_non_space(p);
+        p += i;
+        if (i < MM_FAST_BLOCK_BYTES) {
+            return p;
+        }
+    }
+    while (p < end && _mm_fast_is_space(*p)) {
+        ++p;
+    }
+    return p;
+}
+
+// Internal utility function that converts up to eight ASCII digits
+// with three multiplies instead of one per digit.
+// PRECONDITION: 8 bytes are readable at p and 1 <= len <= 8.
+// \param p   : First digit.
+// \param len : Number of digits.
+// Returns the value of the digits.
+//
+static inline uint32_t _mm_fast_parse_eight(const char* p, size_t len) {
+    uint64_t val;
+    memcpy(&val, p, sizeof(val));
+
+    // Digits sit in the low len bytes. Shifting left drops the bytes
+    // past them and leaves zero bytes, which read as leading zeros.
+    //
+    val <<= (8 - len) * 8;
+    val = ((val & 0x0F0F0F0F0F0F0F0FULL) * 2561) >> 8;
+    val = ((val & 0x00FF00FF00FF00FFULL) * 6553601) >> 16;
+    return (uint32_t)(((val & 0x0000FFFF0000FFFFULL) * 42949672960001ULL) >> 32);
+}
+
+// Internal utility function that parses an unsigned integer.
+// \param p     : First digit.
+// \param end   : End of the mapped file.
+// \param value : Pointer to parsed value (provided by caller).
+// Returns a pointer past the last digit, NULL if there is no valid
+// integer at p.
+//
+static inline const char* _mm_fast_parse_uint(const char* p, const char* end, unsigned int* value) {
+    if (end - p >= MM_FAST_BLOCK_BYTES) {
+        size_t len = _mm_fast_first_non_digit(p);
+        if (len == 0 || len > MM_FAST_MAX_DIGITS) {
+            return NULL;
+        }
+        if (len <= 8) {
+            *value = _mm_fast_parse_eight(p, len);
+            return p + len;
+        }
+
+        uint64_t high = 0;
+        for (size_t i = 0; i < len - 8; i++) {
+            high = high * 10 + (uint64_t)(p[i] - '0');
+        }
+        uint64_t result = high * 100000000ULL + _mm_fast_parse_eight(p + len - 8, 8);
+        if (result > UINT32_MAX) {
+            return NULL;
+        }
+        *value = (unsigned int)result;
+        return p + len;
+    }
+
+    // Near the end of the file, where a block load could overrun.
+    //
+    uint64_t result = 0;
+    const char* start = p;
+    while (p < end && _mm_fast_is_digit(*p) && p - start < MM_FAST_MAX_DIGITS) {
+        result = result * 10 + (uint64_t)(*p - '0');
+        ++p;
+    }
+    if (p == start || result > UINT32_MAX || (p < end && _mm_fast_is_digit(*p))) {
+        return NULL;
+    }
+    *value = (unsigned int)result;
+    return p;
+}
+
+// Internal utility function that parses coordinate entries.
+// \param p       : Start of the first entry.
+// \param end     : End of the range to parse.
+// \param pattern : Whether entries have no value columns.
+// \param I       : Row index output array.
+// \param J       : Column index output array.
+// \param max     : Capacity of I and J.
+// \param count   : Pointer to number of entries parsed (provided by caller).
+// Returns 0 on success, an MM_* error code otherwise.
+//
+static int _mm_fast_parse_entries(const char* p, const char* end, bool pattern,
+                                  unsigned int* I, unsigned int* J,
+                                  size_t max, size_t* count) {
+    size_t k = 0;
+    for (;;) {
+        p = _mm_fast_skip_space(p, end);
+        if (p == end) {
+            break;
+        }
+        if (k == max) {
+            break;
+        }
+
+        p = _mm_fast_parse_uint(p, end, &I[k]);
+        if (p == NULL) {
+            return MM_PREMATURE_EOF;
+        }
+        p = _mm_fast_skip_space(p, end);
+        p = _mm_fast_parse_uint(p, end, &J[k]);
+        if (p == NULL) {
+            return MM_PREMATURE_EOF;
+        }
+        if (!pattern) {
+            p = _mm_fast_find_newline(p, end);
+        }
+        ++k;
+    }
+
+    *count = k;
+    return 0;
+}
+
+// Internal utility function that parses the banner line.
+// \param p       : Start of the file.
+// \param end     : End of the banner line.
+// \param pattern : Pointer to whether the matrix is a pattern matrix.
+// Returns 0 on success, an MM_* error code otherwise.
+//
+static int _mm_fast_parse_banner(const char* p, const char* end, bool* pattern) {
+    size_t banner_len = strlen(MatrixMarketBanner);
+    if ((size_t)(end - p) < banner_len || strncmp(p, MatrixMarketBanner, banner_len) != 0) {
+        return MM_NO_HEADER;
+    }
+
+    // Split the remaining words: object, format, field, symmetry.
+    //
+    char words[4][MM_MAX_TOKEN_LENGTH];
+    size_t num_words = 0;
+    p += banner_len;
+    while (num_words < 4) {
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) {
+            ++p;
+        }
+        const char* word = p;
+        while (p < end && !_mm_fast_is_space(*p)) {
+            ++p;
+        }
+        size_t len = (size_t)(p - word);
+        if (len == 0 || len >= MM_MAX_TOKEN_LENGTH) {
+            return MM_PREMATURE_EOF;
+        }
+        memcpy(words[num_words], word, len);
+        words[num_words][len] = '\0';
+        ++num_words;
+    }
+
+    if (strcasecmp(words[0], MM_MTX_STR) != 0) {
+        return MM_UNSUPPORTED_TYPE;
+    }
+    if (strcasecmp(words[1], MM_SPARSE_STR) != 0) {
+        return MM_UNSUPPORTED_TYPE;
+    }
+
+    *pattern = strcasecmp(words[2], MM_PATTERN_STR) == 0;
+    return 0;
+}
+
+// A line-aligned slice of the entry section, parsed by one thread.
+//
+struct mm_fast_chunk {
+    const char* begin;
+    const char* end;
+    bool pattern;
+    unsigned int* I;
+    unsigned int* J;
+    size_t first;       // Slot of the chunk's first entry in I and J.
+    size_t capacity;    // Upper bound on the chunk's entries.
+    size_t count;       // Entries actually parsed.
+    int status;
+};
+
+// Internal utility function that bounds a chunk's entry count by its
+// line count, so every chunk can be given its slots before parsing.
+//
+static void* _mm_fast_size_chunk(void* arg) {
+    struct mm_fast_chunk* chunk = (struct mm_fast_chunk*)arg;
+    chunk->capacity = _mm_fast_count_newlines(chunk->begin, chunk->end) + 1;
+    return NULL;
+}
+
+// Internal utility function that parses a chunk into its slots.
+//
+static void* _mm_fast_parse_chunk(void* arg) {
+    struct mm_fast_chunk* chunk = (struct mm_fast_chunk*)arg;
+    chunk->status = _mm_fast_parse_entries(chunk->begin, chunk->end, chunk->pattern,
+                                           chunk->I + chunk->first, chunk->J + chunk->first,
+                                           chunk->capacity, &chunk->count);
+    return NULL;
+}
+
+// Internal utility function that runs fn on every chunk, one thread
+// per chunk, and waits for all of them. Chunks whose thread cannot be
+// started run on the calling thread instead.
+// \param chunks     : Array of chunks.
+// \param num_chunks : Number of chunks.
+// \param fn         : Function to run on each chunk.
+//
+static void _mm_fast_run_chunks(struct mm_fast_chunk* chunks, size_t num_chunks,
+                                void* (*fn)(void*)) {
+    pthread_t threads[MM_FAST_MAX_THREADS];
+    bool started[MM_FAST_MAX_THREADS];
+
+    for (size_t c = 0; c < num_chunks; c++) {
+        started[c] = c > 0 && pthread_create(&threads[c], NULL, fn, &chunks[c]) == 0;
+    }
+    for (size_t c = 0; c < num_chunks; c++) {
+        if (!started[c]) {
+            fn(&chunks[c]);
+        }
+    }
+    for (size_t c = 1; c < num_chunks; c++) {
+        if (started[c]) {
+            pthread_join(threads[c], NULL);
+        }
+    }
+}
+
+// Reads the structure of a coordinate Matrix Market file. Value
+// columns of non-pattern matrices are skipped. Indices are returned
+// 1-based, exactly as they appear in the file.
+// \param fname : Path of the .mtx file.
+// \param M_    : Pointer to number of rows (provided by caller).
+// \param N_    : Pointer to number of columns (provided by caller).
+// \param nz_   : Pointer to number of entries read (provided by caller).
+// \param I_    : Pointer to row index array, allocated with malloc().
+// \param J_    : Pointer to column index array, allocated with malloc().
+// \param num_threads : Number of threads to parse with. 0 means 1.
+// Returns 0 on success, one of the MM_* error codes from mmio.h otherwise.
+//
+int mm_read_crd_pattern_fast(const char *fname, int *M_, int *N_, int *nz_,
+                             unsigned int **I_, unsigned int **J_,
+                             size_t num_threads)
+{
+    int fd = open(fname, O_RDONLY);
+    if (fd < 0) {
+        return MM_COULD_NOT_READ_FILE;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        return MM_PREMATURE_EOF;
+    }
+
+    size_t bytes = (size_t)st.st_size;
+    const char* data = (const char*)mmap(NULL, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        return MM_COULD_NOT_READ_FILE;
+    }
+    madvise((void*)data, bytes, MADV_SEQUENTIAL);
+
+    const char* end = data + bytes;
+    const char* p   = data;
+    bool pattern    = false;
+    unsigned int* I = NULL;
+    unsigned int* J = NULL;
+
+    const char* line_end = _mm_fast_find_newline(p, end);
+    int status = _mm_fast_parse_banner(p, line_end, &pattern);
+    if (status != 0) {
+        goto out;
+    }
+
+    // Skip comments, then read "M N nz".
+    //
+    p = line_end;
+    for (;;) {
+        p = _mm_fast_skip_space(p, end);
+        if (p == end || *p != '%') {
+            break;
+        }
+        p = _mm_fast_find_newline(p, end);
+    }
+
+    unsigned int size[3];
+    for (size_t i = 0; i < 3; i++) {
+        p = _mm_fast_skip_space(p, end);
+        p = _mm_fast_parse_uint(p, end, &size[i]);
+        if (p == NULL || size[i] > INT32_MAX) {
+            status = MM_PREMATURE_EOF;
+            goto out;
+        }
+    }
+
+    // Split the entries on line boundaries, one chunk per thread.
+    //
+    if (num_threads == 0) {
+        num_threads = 1;
+    }
+    if (num_threads > MM_FAST_MAX_THREADS) {
+        num_threads = MM_FAST_MAX_THREADS;
+    }
+
+    struct mm_fast_chunk chunks[MM_FAST_MAX_THREADS];
+    const char* body = p;
+    for (size_t c = 0; c < num_threads; c++) {
+        const char* begin = c == 0 ? body : chunks[c - 1].end;
+        const char* split = body + (size_t)(end - body) * (c + 1) / num_threads;
+        if (split < begin) {
+            split = begin;
+        }
+        if (c + 1 < num_threads) {
+            split = _mm_fast_find_newline(split, end);
+            split = split < end ? split + 1 : end;
+        }
+
+        memset(&chunks[c], 0, sizeof(struct mm_fast_chunk));
+        chunks[c].begin   = begin;
+        chunks[c].end     = split;
+        chunks[c].pattern = pattern;
+    }
+
+    _mm_fast_run_chunks(chunks, num_threads, _mm_fast_size_chunk);
+
+    size_t capacity = 0;
+    for (size_t c = 0; c < num_threads; c++) {
+        chunks[c].first = capacity;
+        capacity += chunks[c].capacity;
+    }
+    if (capacity < size[2]) {
+        capacity = size[2];
+    }
+
+    I = (unsigned int*)malloc((capacity + 1) * sizeof(unsigned int));
+    J = (unsigned int*)malloc((capacity + 1) * sizeof(unsigned int));
+    if (I == NULL || J == NULL) {
+        status = MM_COULD_NOT_READ_FILE;
+        goto out;
+    }
+    for (size_t c = 0; c < num_threads; c++) {
+        chunks[c].I = I;
+        chunks[c].J = J;
+    }
+
+    _mm_fast_run_chunks(chunks, num_threads, _mm_fast_parse_chunk);
+
+    // Blank lines leave gaps after a chunk's entries. Close them, and
+    // ignore anything past the declared entry count.
+    //
+    size_t count = 0;
+    for (size_t c = 0; c < num_threads && status == 0 && count < size[2]; c++) {
+        status = chunks[c].status;
+        size_t n = chunks[c].count;
+        if (n > size[2] - count) {
+            n = size[2] - count;
+        }
+        if (chunks[c].first != count) {
+            memmove(I + count, I + chunks[c].first, n * sizeof(unsigned int));
+            memmove(J + count, J + chunks[c].first, n * sizeof(unsigned int));
+        }
+        count += n;
+    }
+    if (status == 0 && count != size[2]) {
+        status = MM_PREMATURE_EOF;
+    }
+
+    if (status == 0) {
+        *M_  = (int)size[0];
+        *N_  = (int)size[1];
+        *nz_ = (int)size[2];
+        *I_  = I;
+        *J_  = J;
+        I = NULL;
+        J = NULL;
+    }
+
+out:
+    free(I);
+    free(J);
+    munmap((void*)data, bytes);
+    return status;
+}
@@ -0,0 +1,34 @@
+// MIT License. Copyright (c) 2025 Kshitij Jain
+// See LICENSE file in the root of this repository.
+
+#ifndef _MM_FAST_H
+#define _MM_FAST_H
+
+#include <stddef.h>
+
+// High throughput reader for Matrix Market coordinate files.
+//
+// mmio.c reads every entry with fscanf(), which interprets its format
+// string and consults the locale for each integer. This reader maps
+// the file, finds line and field boundaries with SIMD compares (SSE2
+// on x86-64, NEON on AArch64, scalar elsewhere) and converts indices
+// with a hand-rolled SWAR digit parser. The entries are split on line
+// boundaries and parsed by several threads at once.
+
+// Reads the structure of a coordinate Matrix Market file. Value
+// columns of non-pattern matrices are skipped. Indices are returned
+// 1-based, exactly as they appear in the file.
+// \param fname : Path of the .mtx file.
+// \param M_    : Pointer to number of rows (provided by caller).
+// \param N_    : Pointer to number of columns (provided by caller).
+// \param nz_   : Pointer to number of entries read (provided by caller).
+// \param I_    : Pointer to row index array, allocated with malloc().
+// \param J_    : Pointer to column index array, allocated with malloc().
+// \param num_threads : Number of threads to parse with. 0 means 1.
+// Returns 0 on success, one of the MM_* error codes from mmio.h otherwise.
+//
+int mm_read_crd_pattern_fast(const char *fname, int *M_, int *N_, int *nz_,
+                             unsigned int **I_, unsigned int **J_,
+                             size_t num_threads);
+
+#endif
@@ -120,6 +120,8 @@ int mm_is_valid(MM_typecode matcode);		/* too complex for a macro */
 
 int mm_write_mtx_crd(char fname[], int M, int N, int nz, int I[], int J[],
 				 double val[], MM_typecode matcode);
+int mm_read_mtx_crd(char *fname, int *M, int *N, int *nz, int **I, int **J,
+				double **val, MM_typecode *matcode);
 int mm_read_mtx_crd_data(FILE *f, int M, int N, int nz, int I[], int J[],
 				double val[], MM_typecode matcode);
 int mm_read_mtx_crd_entry(FILE *f, int *I, int *J, double *real, double *img,
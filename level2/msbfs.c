@@ -0,0 +1,147 @@
+// MIT License. Copyright (c) 2025 Kshitij Jain
+// See LICENSE file in the root of this repository.
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "msbfs.h"
+
+// Creates the state for batched searches of a graph.
+// \param graph : Graph to search.
+// Returns a new MS-BFS on success, NULL on failure.
+//
+struct msbfs * msbfs_create(struct graph * graph) {
+    if (graph == NULL) {
+        return NULL;
+    }
+
+    struct msbfs * msbfs = (struct msbfs*)calloc(1, sizeof(struct msbfs));
+    if (msbfs == NULL) {
+        return NULL;
+    }
+    msbfs->graph      = graph;
+    msbfs->seen       = (msbfs_mask_t*)calloc(graph->num_vertices + 1, sizeof(msbfs_mask_t));
+    msbfs->visit      = (msbfs_mask_t*)calloc(graph->num_vertices + 1, sizeof(msbfs_mask_t));
+    msbfs->visit_next = (msbfs_mask_t*)calloc(graph->num_vertices + 1, sizeof(msbfs_mask_t));
+    if (msbfs->seen == NULL || msbfs->visit == NULL || msbfs->visit_next == NULL) {
+        msbfs_delete(msbfs);
+        return NULL;
+    }
+    return msbfs;
+}
+
+// Deletes an MS-BFS and frees all memory associated with it. The
+// graph is owned by the caller and is not freed.
+// \param msbfs : Pointer to MS-BFS to delete.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool msbfs_delete(struct msbfs * msbfs) {
+    if (msbfs == NULL) {
+        return false;
+    }
+
+    free(msbfs->seen);
+    free(msbfs->visit);
+    free(msbfs->visit_next);
+    free(msbfs);
+    return true;
+}
+
+// Answers a batch of reachability queries in one traversal. Query k
+// asks for a path of at least one edge from sources[k] to targets[k].
+// \param msbfs       : Pointer to MS-BFS.
+// \param sources     : Array of num_queries source vertices.
+// \param targets     : Array of num_queries target vertices.
+// \param num_queries : Number of queries, at most MSBFS_WIDTH.
+// \param found       : Array of num_queries answers (provided by caller).
+// Returns TRUE on success, FALSE otherwise.
+//
+bool msbfs_run(struct msbfs * msbfs, const unsigned int * sources,
+               const unsigned int * targets, size_t num_queries, bool * found)
+{
+    if (msbfs == NULL || num_queries > MSBFS_WIDTH
+        || (num_queries > 0 && (sources == NULL || targets == NULL || found == NULL))) {
+        return false;
+    }
+
+    struct graph * graph = msbfs->graph;
+    size_t num_vertices  = graph->num_vertices;
+    msbfs->levels         = 0;
+    msbfs->edges_examined = 0;
+
+    memset(msbfs->seen, 0, num_vertices * sizeof(msbfs_mask_t));
+    memset(msbfs->visit, 0, num_vertices * sizeof(msbfs_mask_t));
+
+    // Bits of the searches still running. A search stops as soon as
+    // its target is reached.
+    //
+    msbfs_mask_t active = 0;
+    for (size_t k = 0; k < num_queries; k++) {
+        found[k] = false;
+        if (sources[k] < num_vertices) {
+            msbfs->seen[sources[k]]  |= (msbfs_mask_t)1 << k;
+            msbfs->visit[sources[k]] |= (msbfs_mask_t)1 << k;
+            active |= (msbfs_mask_t)1 << k;
+        }
+    }
+
+    while (active != 0) {
+        ++msbfs->levels;
+
+        // Expand: one read of each frontier row serves every search
+        // that has the row's vertex in its frontier.
+        //
+        for (size_t v = 0; v < num_vertices; v++) {
+            msbfs_mask_t frontier = msbfs->visit[v];
+            if (frontier == 0) {
+                continue;
+            }
+            msbfs->visit[v] = 0;
+            frontier &= active;
+            if (frontier == 0) {
+                continue;
+            }
+
+            graph_offset_t begin = graph->offsets[v];
+            graph_offset_t end   = graph->offsets[v + 1];
+            msbfs->edges_examined += end - begin;
+            for (graph_offset_t edge = begin; edge < end; edge++) {
+                msbfs->visit_next[graph->neighbors[edge]] |= frontier;
+            }
+        }
+
+        // A search is done once an edge reached its target. This is
+        // checked before seen vertices are filtered out, so a source
+        // that is its own target is found through a cycle.
+        //
+        for (size_t k = 0; k < num_queries; k++) {
+            msbfs_mask_t bit = (msbfs_mask_t)1 << k;
+            if ((active & bit) && targets[k] < num_vertices && (msbfs->visit_next[targets[k]] & bit)) {
+                found[k] = true;
+                active &= ~bit;
+            }
+        }
+
+        // Keep only first visits as the next frontier.
+        //
+        bool frontier_empty = true;
+        for (size_t v = 0; v < num_vertices; v++) {
+            msbfs_mask_t next = msbfs->visit_next[v];
+            if (next == 0) {
+                continue;
+            }
+            msbfs->visit_next[v] = 0;
+            next &= ~msbfs->seen[v] & active;
+            if (next != 0) {
+                msbfs->seen[v] |= next;
+                msbfs->visit[v] = next;
+                frontier_empty  = false;
+            }
+        }
+        if (frontier_empty) {
+            break;
+        }
+    }
+
+    return true;
+}
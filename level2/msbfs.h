@@ -0,0 +1,64 @@
+// MIT License. Copyright (c) 2025 Kshitij Jain
+// See LICENSE file in the root of this repository.
+
+#ifndef _MSBFS_H
+#define _MSBFS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "graph.h"
+
+// Bit-parallel multi-source BFS (MS-BFS), after Then et al.
+//
+// Up to MSBFS_WIDTH searches share one traversal. Every vertex holds
+// one bit per search in each of three masks: seen, visit (the current
+// frontier) and visit_next. A level reads each adjacency list once and
+// ORs the frontier bits of its vertex into all of its neighbors, so
+// searches whose frontiers overlap split the cost of reading edges.
+
+// Searches per batch, one per bit of a mask word.
+//
+#define MSBFS_WIDTH 64
+
+typedef uint64_t msbfs_mask_t;
+
+struct msbfs {
+    struct graph * graph;
+    msbfs_mask_t * seen;            // num_vertices entries each.
+    msbfs_mask_t * visit;
+    msbfs_mask_t * visit_next;
+
+    // Statistics of the last batch.
+    //
+    size_t levels;
+    size_t edges_examined;
+};
+
+// Creates the state for batched searches of a graph.
+// \param graph : Graph to search.
+// Returns a new MS-BFS on success, NULL on failure.
+//
+struct msbfs * msbfs_create(struct graph * graph);
+
+// Deletes an MS-BFS and frees all memory associated with it. The
+// graph is owned by the caller and is not freed.
+// \param msbfs : Pointer to MS-BFS to delete.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool msbfs_delete(struct msbfs * msbfs);
+
+// Answers a batch of reachability queries in one traversal. Query k
+// asks for a path of at least one edge from sources[k] to targets[k].
+// \param msbfs       : Pointer to MS-BFS.
+// \param sources     : Array of num_queries source vertices.
+// \param targets     : Array of num_queries target vertices.
+// \param num_queries : Number of queries, at most MSBFS_WIDTH.
+// \param found       : Array of num_queries answers (provided by caller).
+// Returns TRUE on success, FALSE otherwise.
+//
+bool msbfs_run(struct msbfs * msbfs, const unsigned int * sources,
+               const unsigned int * targets, size_t num_queries, bool * found);
+
+#endif
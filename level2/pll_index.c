@@ -0,0 +1,783 @@
+// MIT License. Copyright (c) 2025 Kshitij Jain
+// See LICENSE file in the root of this repository.
+
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "pll_index.h"
+
+// End of a label list under construction.
+//
+#define PLL_END SIZE_MAX
+
+// A label entry under construction. The entries of a vertex form a
+// list through a shared pool, newest landmark first, so that adding
+// one is O(1) and the pool can grow without moving per-vertex arrays.
+//
+struct _pll_entry {
+    uint32_t landmark;
+    uint32_t distance;
+    size_t next;
+};
+
+struct _pll_labels {
+    struct _pll_entry * entries;
+    size_t size;
+    size_t capacity;
+    size_t * heads;                 // num_vertices list heads.
+    uint32_t * counts;              // num_vertices list lengths.
+};
+
+// State of an index build.
+//
+struct _pll_builder {
+    struct pll_index * index;
+    struct _pll_labels out;
+    struct _pll_labels in;
+    uint32_t * root_distance;       // num_landmarks entries.
+    struct visited_set * visited;
+    unsigned int * level;
+    unsigned int * next_level;
+};
+
+// Internal utility function that merges an out-label and an in-label
+// and returns the shortest distance through a landmark they share.
+// \param index  : Pointer to index.
+// \param source : Vertex whose out-label to read.
+// \param target : Vertex whose in-label to read.
+// Returns the distance, PLL_INFINITY if the labels share no landmark.
+//
+static uint32_t _pll_label_distance(const struct pll_index * index, unsigned int source,
+                                    unsigned int target)
+{
+    const struct pll_label * out     = index->out_labels + index->out_offsets[source];
+    const struct pll_label * out_end = index->out_labels + index->out_offsets[source + 1];
+    const struct pll_label * in      = index->in_labels + index->in_offsets[target];
+    const struct pll_label * in_end  = index->in_labels + index->in_offsets[target + 1];
+
+    uint32_t best = PLL_INFINITY;
+    while (out < out_end && in < in_end) {
+        if (out->landmark < in->landmark) {
+            ++out;
+        } else if (out->landmark > in->landmark) {
+            ++in;
+        } else {
+            uint32_t distance = out->distance + in->distance;
+            if (distance < best) {
+                best = distance;
+            }
+            ++out;
+            ++in;
+        }
+    }
+    return best;
+}
+
+// Internal utility function that prepends an entry to the label of a
+// vertex.
+// Returns TRUE on success, FALSE if the pool could not grow.
+//
+static bool _pll_labels_add(struct _pll_labels * labels, unsigned int vertex,
+                            uint32_t landmark, uint32_t distance)
+{
+    if (labels->size == labels->capacity) {
+        size_t capacity = labels->capacity * 2;
+        struct _pll_entry * entries = (struct _pll_entry*)realloc(labels->entries,
+                                                                  capacity * sizeof(struct _pll_entry));
+        if (entries == NULL) {
+            return false;
+        }
+        labels->entries  = entries;
+        labels->capacity = capacity;
+    }
+
+    struct _pll_entry * entry = &labels->entries[labels->size];
+    entry->landmark = landmark;
+    entry->distance = distance;
+    entry->next     = labels->heads[vertex];
+    labels->heads[vertex] = labels->size++;
+    ++labels->counts[vertex];
+    return true;
+}
+
+// Internal utility function that checks whether the labels built so
+// far give a distance of at most depth between the root of a pruned
+// BFS and a vertex it reached. root_distance holds the root's side.
+//
+static inline bool _pll_covered(const struct _pll_builder * builder, const struct _pll_labels * labels,
+                                unsigned int vertex, uint32_t depth)
+{
+    for (size_t e = labels->heads[vertex]; e != PLL_END; e = labels->entries[e].next) {
+        uint32_t root = builder->root_distance[labels->entries[e].landmark];
+        if (root != PLL_INFINITY && root + labels->entries[e].distance <= depth) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Internal utility function that runs the pruned BFS of one landmark
+// in one direction.
+// \param builder : Pointer to build state.
+// \param graph   : Graph to walk, the transpose for the backward BFS.
+// \param root    : Landmark vertex.
+// \param rank    : Rank of the landmark.
+// \param fixed   : Labels holding the root's side of each distance.
+// \param labels  : Labels the reached vertices are added to.
+// Returns TRUE on success, FALSE otherwise.
+//
+static bool _pll_pruned_bfs(struct _pll_builder * builder, struct graph * graph,
+                            unsigned int root, uint32_t rank,
+                            const struct _pll_labels * fixed, struct _pll_labels * labels)
+{
+    for (size_t e = fixed->heads[root]; e != PLL_END; e = fixed->entries[e].next) {
+        builder->root_distance[fixed->entries[e].landmark] = fixed->entries[e].distance;
+    }
+
+    bool status = true;
+    visited_set_clear(builder->visited);
+    visited_set_insert(builder->visited, root);
+    builder->level[0] = root;
+    size_t level_size = 1;
+    for (uint32_t depth = 0; status && level_size > 0; depth++) {
+        size_t next_size = 0;
+        for (size_t i = 0; i < level_size; i++) {
+            unsigned int vertex = builder->level[i];
+            if (_pll_covered(builder, labels, vertex, depth)) {
+                continue;
+            }
+            if (!_pll_labels_add(labels, vertex, rank, depth)) {
+                status = false;
+                break;
+            }
+
+            for (graph_offset_t edge = graph->offsets[vertex]; edge < graph->offsets[vertex + 1]; edge++) {
+                unsigned int neighbor = graph->neighbors[edge];
+                if (visited_set_insert(builder->visited, neighbor)) {
+                    builder->next_level[next_size++] = neighbor;
+                }
+            }
+        }
+
+        unsigned int * swap  = builder->level;
+        builder->level       = builder->next_level;
+        builder->next_level  = swap;
+        level_size           = next_size;
+    }
+
+    for (size_t e = fixed->heads[root]; e != PLL_END; e = fixed->entries[e].next) {
+        builder->root_distance[fixed->entries[e].landmark] = PLL_INFINITY;
+    }
+    return status;
+}
+
+// Internal utility function that copies labels under construction into
+// sorted arrays.
+// \param labels       : Labels to copy.
+// \param num_vertices : Number of vertices.
+// \param offsets      : Pointer to new offsets array (provided by caller).
+// \param entries      : Pointer to new labels array (provided by caller).
+// Returns TRUE on success, FALSE otherwise.
+//
+static bool _pll_labels_compact(const struct _pll_labels * labels, size_t num_vertices,
+                                uint64_t ** offsets, struct pll_label ** entries)
+{
+    *offsets = (uint64_t*)malloc((num_vertices + 1) * sizeof(uint64_t));
+    *entries = (struct pll_label*)malloc((labels->size + 1) * sizeof(struct pll_label));
+    if (*offsets == NULL || *entries == NULL) {
+        return false;
+    }
+
+    (*offsets)[0] = 0;
+    for (size_t v = 0; v < num_vertices; v++) {
+        (*offsets)[v + 1] = (*offsets)[v] + labels->counts[v];
+    }
+
+    // Lists run newest landmark first, so fill each label from its end.
+    //
+    for (size_t v = 0; v < num_vertices; v++) {
+        uint64_t position = (*offsets)[v + 1];
+        for (size_t e = labels->heads[v]; e != PLL_END; e = labels->entries[e].next) {
+            --position;
+            (*entries)[position].landmark = labels->entries[e].landmark;
+            (*entries)[position].distance = labels->entries[e].distance;
+        }
+    }
+    return true;
+}
+
+// Internal utility function that sets up a label list per vertex.
+//
+static bool _pll_labels_init(struct _pll_labels * labels, size_t num_vertices) {
+    labels->capacity = num_vertices + 1;
+    labels->entries  = (struct _pll_entry*)malloc(labels->capacity * sizeof(struct _pll_entry));
+    labels->heads    = (size_t*)malloc(num_vertices * sizeof(size_t));
+    labels->counts   = (uint32_t*)calloc(num_vertices, sizeof(uint32_t));
+    if (labels->entries == NULL || labels->heads == NULL || labels->counts == NULL) {
+        return false;
+    }
+    for (size_t v = 0; v < num_vertices; v++) {
+        labels->heads[v] = PLL_END;
+    }
+    return true;
+}
+
+static void _pll_labels_free(struct _pll_labels * labels) {
+    free(labels->entries);
+    free(labels->heads);
+    free(labels->counts);
+}
+
+// Internal utility function that fills in the rank of every vertex
+// from the landmark list.
+// Returns TRUE on success, FALSE otherwise.
+//
+static bool _pll_index_init_rank(struct pll_index * index) {
+    index->rank = (uint32_t*)malloc((index->num_vertices + 1) * sizeof(uint32_t));
+    if (index->rank == NULL) {
+        return false;
+    }
+    for (size_t v = 0; v < index->num_vertices; v++) {
+        index->rank[v] = PLL_NOT_LANDMARK;
+    }
+    for (size_t r = 0; r < index->num_landmarks; r++) {
+        if (index->landmarks[r] >= index->num_vertices) {
+            return false;
+        }
+        index->rank[index->landmarks[r]] = (uint32_t)r;
+    }
+    return true;
+}
+
+// Graphs whose degrees _pll_compare_degree() compares.
+//
+static const struct graph * _pll_sort_graph;
+static const struct graph * _pll_sort_reverse;
+
+// Internal comparison function for qsort() of vertices by decreasing
+// total degree, lower IDs first among equals.
+//
+static int _pll_compare_degree(const void * a, const void * b) {
+    unsigned int x = *(const unsigned int*)a;
+    unsigned int y = *(const unsigned int*)b;
+    graph_offset_t dx = _pll_sort_graph->offsets[x + 1] - _pll_sort_graph->offsets[x]
+                        + _pll_sort_reverse->offsets[x + 1] - _pll_sort_reverse->offsets[x];
+    graph_offset_t dy = _pll_sort_graph->offsets[y + 1] - _pll_sort_graph->offsets[y]
+                        + _pll_sort_reverse->offsets[y + 1] - _pll_sort_reverse->offsets[y];
+    if (dx != dy) {
+        return dx > dy ? -1 : 1;
+    }
+    return (x > y) - (x < y);
+}
+
+// Builds the labels of the num_landmarks highest degree vertices.
+// \param graph         : Graph to index.
+// \param reverse       : Transpose of graph.
+// \param num_landmarks : Number of landmarks, at most num_vertices.
+// Returns a new index on success, NULL on failure.
+//
+struct pll_index * pll_index_create(struct graph * graph, struct graph * reverse,
+                                    size_t num_landmarks)
+{
+    if (graph == NULL || reverse == NULL || reverse->num_vertices != graph->num_vertices
+        || num_landmarks > graph->num_vertices || num_landmarks >= PLL_NOT_LANDMARK) {
+        return NULL;
+    }
+
+    struct pll_index * index = (struct pll_index*)calloc(1, sizeof(struct pll_index));
+    if (index == NULL) {
+        return NULL;
+    }
+    index->num_vertices  = graph->num_vertices;
+    index->num_landmarks = num_landmarks;
+
+    // Hubs first. The comparison reads the graphs through statics, so
+    // concurrent builds are not supported.
+    //
+    unsigned int * by_degree = (unsigned int*)malloc((graph->num_vertices + 1) * sizeof(unsigned int));
+    index->landmarks         = (unsigned int*)malloc((num_landmarks + 1) * sizeof(unsigned int));
+    if (by_degree == NULL || index->landmarks == NULL) {
+        free(by_degree);
+        pll_index_delete(index);
+        return NULL;
+    }
+    for (size_t v = 0; v < graph->num_vertices; v++) {
+        by_degree[v] = (unsigned int)v;
+    }
+    _pll_sort_graph   = graph;
+    _pll_sort_reverse = reverse;
+    qsort(by_degree, graph->num_vertices, sizeof(unsigned int), _pll_compare_degree);
+    memcpy(index->landmarks, by_degree, num_landmarks * sizeof(unsigned int));
+    free(by_degree);
+    if (!_pll_index_init_rank(index)) {
+        pll_index_delete(index);
+        return NULL;
+    }
+
+    struct _pll_builder builder;
+    memset(&builder, 0, sizeof(builder));
+    builder.index         = index;
+    builder.root_distance = (uint32_t*)malloc((num_landmarks + 1) * sizeof(uint32_t));
+    builder.visited       = visited_set_create(graph->num_vertices);
+    builder.level         = (unsigned int*)malloc((graph->num_vertices + 1) * sizeof(unsigned int));
+    builder.next_level    = (unsigned int*)malloc((graph->num_vertices + 1) * sizeof(unsigned int));
+    bool status = builder.root_distance != NULL && builder.visited != NULL
+        && builder.level != NULL && builder.next_level != NULL
+        && _pll_labels_init(&builder.out, graph->num_vertices)
+        && _pll_labels_init(&builder.in, graph->num_vertices);
+    if (status) {
+        for (size_t r = 0; r < num_landmarks; r++) {
+            builder.root_distance[r] = PLL_INFINITY;
+        }
+    }
+
+    // The forward BFS fills in-labels, measuring from the root's
+    // out-label, and the backward BFS the other way around.
+    //
+    for (size_t r = 0; status && r < num_landmarks; r++) {
+        unsigned int root = index->landmarks[r];
+        status = _pll_pruned_bfs(&builder, graph, root, (uint32_t)r, &builder.out, &builder.in)
+            && _pll_pruned_bfs(&builder, reverse, root, (uint32_t)r, &builder.in, &builder.out);
+    }
+
+    status = status
+        && _pll_labels_compact(&builder.out, graph->num_vertices, &index->out_offsets, &index->out_labels)
+        && _pll_labels_compact(&builder.in, graph->num_vertices, &index->in_offsets, &index->in_labels);
+
+    _pll_labels_free(&builder.out);
+    _pll_labels_free(&builder.in);
+    free(builder.root_distance);
+    visited_set_delete(builder.visited);
+    free(builder.level);
+    free(builder.next_level);
+    if (!status) {
+        pll_index_delete(index);
+        return NULL;
+    }
+    return index;
+}
+
+// Deletes an index and frees all memory associated with it.
+// \param index : Pointer to index to delete.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool pll_index_delete(struct pll_index * index) {
+    if (index == NULL) {
+        return false;
+    }
+
+    if (index->mapping != NULL) {
+        munmap(index->mapping, index->mapping_bytes);
+    } else {
+        free(index->landmarks);
+        free(index->out_offsets);
+        free(index->out_labels);
+        free(index->in_offsets);
+        free(index->in_labels);
+    }
+    free(index->rank);
+    free(index);
+    return true;
+}
+
+// Returns the number of bytes used by the labels and their offsets.
+// \param index : Pointer to index.
+// Returns size on success, SIZE_MAX otherwise.
+//
+size_t pll_index_memory_bytes(struct pll_index * index) {
+    if (index == NULL) {
+        return SIZE_MAX;
+    }
+
+    return 2 * (index->num_vertices + 1) * sizeof(uint64_t)
+        + (size_t)(index->out_offsets[index->num_vertices] + index->in_offsets[index->num_vertices])
+          * sizeof(struct pll_label);
+}
+
+// Internal utility function that rounds a file position up to the
+// next array boundary.
+//
+static uint64_t _pll_index_align(uint64_t position) {
+    return (position + GRAPH_CACHE_ALIGNMENT - 1) & ~(uint64_t)(GRAPH_CACHE_ALIGNMENT - 1);
+}
+
+// Internal utility function that writes a whole buffer at a position.
+// \param fd       : File descriptor.
+// \param data     : Bytes to write.
+// \param bytes    : Number of bytes.
+// \param position : File offset to write at.
+// Returns TRUE on success, FALSE otherwise.
+//
+static bool _pll_index_pwrite_all(int fd, const void * data, size_t bytes, uint64_t position) {
+    const char * p = (const char*)data;
+    while (bytes > 0) {
+        ssize_t written = pwrite(fd, p, bytes, (off_t)position);
+        if (written <= 0) {
+            return false;
+        }
+        p        += written;
+        bytes    -= (size_t)written;
+        position += (uint64_t)written;
+    }
+    return true;
+}
+
+// Internal utility function that checks that an array lies inside a
+// file, without the size arithmetic wrapping around. Arrays must also
+// start on a GRAPH_CACHE_ALIGNMENT boundary.
+// \param position      : File offset of the array.
+// \param count         : Number of elements.
+// \param element_bytes : Size of an element.
+// \param file_bytes    : Size of the file.
+// Returns TRUE if the array fits, FALSE otherwise.
+//
+static bool _pll_index_array_fits(uint64_t position, uint64_t count, uint64_t element_bytes,
+                                  uint64_t file_bytes)
+{
+    uint64_t bytes, end;
+    return position % GRAPH_CACHE_ALIGNMENT == 0
+        && !__builtin_mul_overflow(count, element_bytes, &bytes)
+        && !__builtin_add_overflow(position, bytes, &end)
+        && end <= file_bytes;
+}
+
+// Internal utility function that checks the labels of a mapped index:
+// the offsets start at 0, never decrease and end at num_labels, and
+// every label names the rank of a landmark.
+// \param offsets       : Array of num_vertices + 1 label offsets.
+// \param labels        : Array of num_labels labels.
+// \param num_vertices  : Number of vertices.
+// \param num_labels    : Number of labels.
+// \param num_landmarks : Number of landmarks.
+// Returns TRUE if the labels are valid, FALSE otherwise.
+//
+static bool _pll_index_labels_check(const uint64_t * offsets, const struct pll_label * labels,
+                                    size_t num_vertices, uint64_t num_labels,
+                                    size_t num_landmarks)
+{
+    if (offsets[0] != 0 || offsets[num_vertices] != num_labels) {
+        return false;
+    }
+    for (size_t v = 0; v < num_vertices; v++) {
+        if (offsets[v + 1] < offsets[v]) {
+            return false;
+        }
+    }
+    for (uint64_t l = 0; l < num_labels; l++) {
+        if (labels[l].landmark >= num_landmarks) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Writes an index to a file. The file is written under a temporary
+// name and renamed into place, so readers never observe a partial
+// index.
+// \param path   : Path of the index file.
+// \param index  : Index to write.
+// \param source : Fingerprint of the file the graph was parsed from.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool pll_index_write(const char * path, struct pll_index * index,
+                     const struct graph_fingerprint * source)
+{
+    if (path == NULL || index == NULL || source == NULL) {
+        return false;
+    }
+
+    size_t offsets_bytes = (index->num_vertices + 1) * sizeof(uint64_t);
+    struct pll_index_header header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, PLL_INDEX_MAGIC, sizeof(header.magic));
+    header.version              = PLL_INDEX_VERSION;
+    header.num_vertices         = index->num_vertices;
+    header.num_landmarks        = index->num_landmarks;
+    header.num_out_labels       = index->out_offsets[index->num_vertices];
+    header.num_in_labels        = index->in_offsets[index->num_vertices];
+    header.landmarks_position   = _pll_index_align(sizeof(header));
+    header.out_offsets_position = _pll_index_align(header.landmarks_position
+                                      + index->num_landmarks * sizeof(unsigned int));
+    header.out_labels_position  = _pll_index_align(header.out_offsets_position + offsets_bytes);
+    header.in_offsets_position  = _pll_index_align(header.out_labels_position
+                                      + header.num_out_labels * sizeof(struct pll_label));
+    header.in_labels_position   = _pll_index_align(header.in_offsets_position + offsets_bytes);
+    header.source               = *source;
+
+    char tmp_path[4096];
+    if (snprintf(tmp_path, sizeof(tmp_path), "%s.tmp.%ld", path, (long)getpid())
+        >= (int)sizeof(tmp_path)) {
+        return false;
+    }
+
+    int fd = open(tmp_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+
+    bool status = _pll_index_pwrite_all(fd, &header, sizeof(header), 0)
+        && _pll_index_pwrite_all(fd, index->landmarks, index->num_landmarks * sizeof(unsigned int),
+                                 header.landmarks_position)
+        && _pll_index_pwrite_all(fd, index->out_offsets, offsets_bytes, header.out_offsets_position)
+        && _pll_index_pwrite_all(fd, index->out_labels, header.num_out_labels * sizeof(struct pll_label),
+                                 header.out_labels_position)
+        && _pll_index_pwrite_all(fd, index->in_offsets, offsets_bytes, header.in_offsets_position)
+        && _pll_index_pwrite_all(fd, index->in_labels, header.num_in_labels * sizeof(struct pll_label),
+                                 header.in_labels_position)
+        && fsync(fd) == 0;
+    status = (close(fd) == 0) && status;
+
+    if (!status || rename(tmp_path, path) != 0) {
+        unlink(tmp_path);
+        return false;
+    }
+
+    return true;
+}
+
+// Maps an index file read-only and returns an index backed by it.
+// \param path          : Path of the index file.
+// \param source        : Expected source fingerprint, or NULL to skip the check.
+// \param num_landmarks : Expected number of landmarks.
+// Returns a new index on success, NULL if the file is missing, stale or
+// corrupt. Free it with pll_index_delete().
+//
+struct pll_index * pll_index_map(const char * path, const struct graph_fingerprint * source,
+                                 size_t num_landmarks)
+{
+    if (path == NULL) {
+        return NULL;
+    }
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return NULL;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(struct pll_index_header)) {
+        close(fd);
+        return NULL;
+    }
+
+    size_t bytes = (size_t)st.st_size;
+    void * mapping = mmap(NULL, bytes, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        return NULL;
+    }
+
+    const struct pll_index_header * header = (const struct pll_index_header*)mapping;
+    uint64_t num_offsets;
+    bool valid = memcmp(header->magic, PLL_INDEX_MAGIC, sizeof(header->magic)) == 0
+        && header->version == PLL_INDEX_VERSION
+        && header->num_landmarks == num_landmarks
+        && header->num_vertices <= UINT_MAX
+        && header->num_landmarks <= header->num_vertices
+        && !__builtin_add_overflow(header->num_vertices, 1, &num_offsets)
+        && _pll_index_array_fits(header->landmarks_position, header->num_landmarks,
+                                 sizeof(unsigned int), bytes)
+        && _pll_index_array_fits(header->out_offsets_position, num_offsets, sizeof(uint64_t), bytes)
+        && _pll_index_array_fits(header->out_labels_position, header->num_out_labels,
+                                 sizeof(struct pll_label), bytes)
+        && _pll_index_array_fits(header->in_offsets_position, num_offsets, sizeof(uint64_t), bytes)
+        && _pll_index_array_fits(header->in_labels_position, header->num_in_labels,
+                                 sizeof(struct pll_label), bytes);
+    if (valid && source != NULL) {
+        valid = header->source.size == source->size
+            && header->source.mtime_sec == source->mtime_sec
+            && header->source.mtime_nsec == source->mtime_nsec;
+    }
+
+    struct pll_index * index = valid ? (struct pll_index*)calloc(1, sizeof(struct pll_index)) : NULL;
+    if (index == NULL) {
+        munmap(mapping, bytes);
+        return NULL;
+    }
+
+    index->num_vertices  = header->num_vertices;
+    index->num_landmarks = header->num_landmarks;
+    index->landmarks     = (unsigned int*)((char*)mapping + header->landmarks_position);
+    index->out_offsets   = (uint64_t*)((char*)mapping + header->out_offsets_position);
+    index->out_labels    = (struct pll_label*)((char*)mapping + header->out_labels_position);
+    index->in_offsets    = (uint64_t*)((char*)mapping + header->in_offsets_position);
+    index->in_labels     = (struct pll_label*)((char*)mapping + header->in_labels_position);
+    index->mapping       = mapping;
+    index->mapping_bytes = bytes;
+
+    // Queries index the labels through the offsets and compare ranks
+    // without bounds checks, so both are checked once here.
+    //
+    if (!_pll_index_labels_check(index->out_offsets, index->out_labels, index->num_vertices,
+                                 header->num_out_labels, index->num_landmarks)
+        || !_pll_index_labels_check(index->in_offsets, index->in_labels, index->num_vertices,
+                                    header->num_in_labels, index->num_landmarks)
+        || !_pll_index_init_rank(index)) {
+        pll_index_delete(index);
+        return NULL;
+    }
+    return index;
+}
+
+// Creates the state for answering queries on an index.
+// \param index : Index to query.
+// \param graph : Graph the index was built from, for fallback searches.
+// Returns a new search on success, NULL on failure.
+//
+struct pll_search * pll_search_create(struct pll_index * index, struct graph * graph) {
+    if (index == NULL || graph == NULL || graph->num_vertices != index->num_vertices) {
+        return NULL;
+    }
+
+    struct pll_search * search = (struct pll_search*)calloc(1, sizeof(struct pll_search));
+    if (search == NULL) {
+        return NULL;
+    }
+    search->index      = index;
+    search->graph      = graph;
+    search->visited    = visited_set_create(graph->num_vertices);
+    search->level      = (unsigned int*)malloc((graph->num_vertices + 1) * sizeof(unsigned int));
+    search->next_level = (unsigned int*)malloc((graph->num_vertices + 1) * sizeof(unsigned int));
+    if (search->visited == NULL || search->level == NULL || search->next_level == NULL) {
+        pll_search_delete(search);
+        return NULL;
+    }
+    return search;
+}
+
+// Deletes a search and frees all memory associated with it. The index
+// and graph are owned by the caller and are not freed.
+// \param search : Pointer to search to delete.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool pll_search_delete(struct pll_search * search) {
+    if (search == NULL) {
+        return false;
+    }
+
+    visited_set_delete(search->visited);
+    free(search->level);
+    free(search->next_level);
+    free(search);
+    return true;
+}
+
+// Internal utility function for the fallback search, a BFS from the
+// source for paths shorter than bound.
+// \param search          : Pointer to search state.
+// \param source          : Vertex to start from.
+// \param target          : Vertex to look for.
+// \param bound           : Only paths with fewer edges are looked for.
+// \param avoid_landmarks : Whether to skip paths through landmarks,
+//                          which the labels cover.
+// Returns the length of the shortest such path, bound if there is none.
+//
+static uint32_t _pll_fallback(struct pll_search * search, unsigned int source, unsigned int target,
+                              uint32_t bound, bool avoid_landmarks)
+{
+    const struct graph * graph = search->graph;
+    const uint32_t * rank      = search->index->rank;
+    search->used_fallback = true;
+
+    visited_set_clear(search->visited);
+    visited_set_insert(search->visited, source);
+    search->level[0]  = source;
+    size_t level_size = 1;
+
+    // A level at distance depth can only lead to paths of depth + 1
+    // edges.
+    //
+    for (uint32_t depth = 0; level_size > 0 && depth + 1 < bound; depth++) {
+        size_t next_size = 0;
+        for (size_t i = 0; i < level_size; i++) {
+            unsigned int vertex = search->level[i];
+            ++search->nodes_visited;
+            for (graph_offset_t edge = graph->offsets[vertex]; edge < graph->offsets[vertex + 1]; edge++) {
+                unsigned int neighbor = graph->neighbors[edge];
+                if (neighbor == target) {
+                    return depth + 1;
+                }
+                if (avoid_landmarks && rank[neighbor] != PLL_NOT_LANDMARK) {
+                    continue;
+                }
+                if (visited_set_insert(search->visited, neighbor)) {
+                    search->next_level[next_size++] = neighbor;
+                }
+            }
+        }
+
+        unsigned int * swap = search->level;
+        search->level       = search->next_level;
+        search->next_level  = swap;
+        level_size          = next_size;
+    }
+    return bound;
+}
+
+// Internal utility function shared by the queries.
+// \param search       : Pointer to search state.
+// \param source       : Vertex to start from.
+// \param target       : Vertex to look for.
+// \param reachability : Whether any path will do, rather than a shortest one.
+// Returns the distance, or for reachability any finite value if a
+// path exists, PLL_INFINITY otherwise.
+//
+static uint32_t _pll_query(struct pll_search * search, unsigned int source, unsigned int target,
+                           bool reachability)
+{
+    struct pll_index * index = search->index;
+    search->used_fallback = false;
+    search->nodes_visited = 0;
+    if (source >= index->num_vertices || target >= index->num_vertices) {
+        return PLL_INFINITY;
+    }
+
+    // A landmark source asking for a cycle back to itself matches its
+    // own (landmark, 0) entries, so it needs a plain search.
+    //
+    if (source == target && index->rank[source] != PLL_NOT_LANDMARK) {
+        return _pll_fallback(search, source, target, PLL_INFINITY, false);
+    }
+
+    // Every path from or to a landmark goes through it.
+    //
+    uint32_t distance = _pll_label_distance(index, source, target);
+    if (index->rank[source] != PLL_NOT_LANDMARK || index->rank[target] != PLL_NOT_LANDMARK
+        || (reachability && distance != PLL_INFINITY)) {
+        return distance;
+    }
+    return _pll_fallback(search, source, target, distance, true);
+}
+
+// Computes the length of a shortest path of at least one edge.
+// \param search : Pointer to search state.
+// \param source : Vertex to start from.
+// \param target : Vertex to look for.
+// Returns the number of edges on the path, PLL_INFINITY if there is
+// none or on error.
+//
+uint32_t pll_search_distance(struct pll_search * search, unsigned int source, unsigned int target) {
+    if (search == NULL) {
+        return PLL_INFINITY;
+    }
+    return _pll_query(search, source, target, false);
+}
+
+// Checks whether there is a path of at least one edge.
+// \param search : Pointer to search state.
+// \param source : Vertex to start from.
+// \param target : Vertex to look for.
+// Returns TRUE if a path exists, FALSE if not or on error.
+//
+bool pll_search_reachable(struct pll_search * search, unsigned int source, unsigned int target) {
+    if (search == NULL) {
+        return false;
+    }
+    return _pll_query(search, source, target, true) != PLL_INFINITY;
+}
@@ -0,0 +1,187 @@
+// MIT License. Copyright (c) 2025 Kshitij Jain
+// See LICENSE file in the root of this repository.
+
+#ifndef _PLL_INDEX_H
+#define _PLL_INDEX_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "graph.h"
+#include "graph_cache.h"
+#include "visited.h"
+
+// 2-hop distance labels from pruned landmark labeling (PLL), after
+// Akiba et al., restricted to the highest degree vertices.
+//
+// Landmarks are taken in decreasing total degree. Each one runs a BFS
+// forward and one backward, and a vertex reached at distance d gets
+// the entry (landmark, d) in its in-label or out-label, unless the
+// labels built so far already give a distance of at most d. Most of
+// the graph is pruned after the first few hubs. The distance of a pair
+// over paths through any landmark is then the smallest
+//     out_label(source).d + in_label(target).d
+// over the landmarks the two sorted labels share.
+//
+// Paths that avoid every landmark are not covered. A query finishes
+// with a BFS that neither expands nor enters landmarks and stops once
+// it cannot beat the label distance, which is short whenever a hub is
+// close by.
+//
+// Vertex IDs are those of the graph the index was built from,
+// including any relabeling it carries.
+
+// Distance of unreachable pairs.
+//
+#define PLL_INFINITY UINT32_MAX
+
+// Rank of vertices that are not landmarks.
+//
+#define PLL_NOT_LANDMARK UINT32_MAX
+
+// On-disk form, written by pll_index_write() and mmap()ed read-only
+// by pll_index_map(). Each array starts on a GRAPH_CACHE_ALIGNMENT
+// boundary:
+//     struct pll_index_header
+//     unsigned int          landmarks[num_landmarks]
+//     uint64_t              out_offsets[num_vertices + 1]
+//     struct pll_label      out_labels[num_out_labels]
+//     uint64_t              in_offsets[num_vertices + 1]
+//     struct pll_label      in_labels[num_in_labels]
+//
+#define PLL_INDEX_MAGIC   "PWPLL\0\0"
+#define PLL_INDEX_VERSION 1
+
+struct pll_label {
+    uint32_t landmark;              // Rank of the landmark.
+    uint32_t distance;
+};
+
+struct pll_index_header {
+    char     magic[8];
+    uint32_t version;
+    uint32_t reserved;
+    uint64_t num_vertices;
+    uint64_t num_landmarks;
+    uint64_t num_out_labels;
+    uint64_t num_in_labels;
+    uint64_t landmarks_position;
+    uint64_t out_offsets_position;
+    uint64_t out_labels_position;
+    uint64_t in_offsets_position;
+    uint64_t in_labels_position;
+    struct graph_fingerprint source;
+};
+
+struct pll_index {
+    size_t num_vertices;
+    size_t num_landmarks;
+    unsigned int * landmarks;       // num_landmarks vertices, by rank.
+    uint32_t * rank;                // num_vertices entries, always malloc()ed.
+
+    // Label of vertex v is labels[offsets[v]] up to labels[offsets[v + 1]],
+    // sorted by landmark rank. Out-labels hold landmarks v reaches,
+    // in-labels landmarks that reach v.
+    //
+    uint64_t * out_offsets;
+    struct pll_label * out_labels;
+    uint64_t * in_offsets;
+    struct pll_label * in_labels;
+
+    // Non-NULL when the arrays above point into a read-only mmap()ed
+    // index file rather than into malloc()ed memory.
+    //
+    void * mapping;
+    size_t mapping_bytes;
+};
+
+// Per-thread state of the fallback searches of an index.
+//
+struct pll_search {
+    struct pll_index * index;
+    struct graph * graph;
+    struct visited_set * visited;
+    unsigned int * level;           // num_vertices entries each.
+    unsigned int * next_level;
+
+    // Statistics of the last query.
+    //
+    bool used_fallback;
+    size_t nodes_visited;           // Vertices expanded by the fallback.
+};
+
+// Builds the labels of the num_landmarks highest degree vertices.
+// \param graph         : Graph to index.
+// \param reverse       : Transpose of graph.
+// \param num_landmarks : Number of landmarks, at most num_vertices.
+// Returns a new index on success, NULL on failure.
+//
+struct pll_index * pll_index_create(struct graph * graph, struct graph * reverse,
+                                    size_t num_landmarks);
+
+// Deletes an index and frees all memory associated with it.
+// \param index : Pointer to index to delete.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool pll_index_delete(struct pll_index * index);
+
+// Returns the number of bytes used by the labels and their offsets.
+// \param index : Pointer to index.
+// Returns size on success, SIZE_MAX otherwise.
+//
+size_t pll_index_memory_bytes(struct pll_index * index);
+
+// Writes an index to a file. The file is written under a temporary
+// name and renamed into place, so readers never observe a partial
+// index.
+// \param path   : Path of the index file.
+// \param index  : Index to write.
+// \param source : Fingerprint of the file the graph was parsed from.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool pll_index_write(const char * path, struct pll_index * index,
+                     const struct graph_fingerprint * source);
+
+// Maps an index file read-only and returns an index backed by it.
+// \param path          : Path of the index file.
+// \param source        : Expected source fingerprint, or NULL to skip the check.
+// \param num_landmarks : Expected number of landmarks.
+// Returns a new index on success, NULL if the file is missing, stale or
+// corrupt. Free it with pll_index_delete().
+//
+struct pll_index * pll_index_map(const char * path, const struct graph_fingerprint * source,
+                                 size_t num_landmarks);
+
+// Creates the state for answering queries on an index.
+// \param index : Index to query.
+// \param graph : Graph the index was built from, for fallback searches.
+// Returns a new search on success, NULL on failure.
+//
+struct pll_search * pll_search_create(struct pll_index * index, struct graph * graph);
+
+// Deletes a search and frees all memory associated with it. The index
+// and graph are owned by the caller and are not freed.
+// \param search : Pointer to search to delete.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool pll_search_delete(struct pll_search * search);
+
+// Computes the length of a shortest path of at least one edge.
+// \param search : Pointer to search state.
+// \param source : Vertex to start from.
+// \param target : Vertex to look for.
+// Returns the number of edges on the path, PLL_INFINITY if there is
+// none or on error.
+//
+uint32_t pll_search_distance(struct pll_search * search, unsigned int source, unsigned int target);
+
+// Checks whether there is a path of at least one edge.
+// \param search : Pointer to search state.
+// \param source : Vertex to start from.
+// \param target : Vertex to look for.
+// Returns TRUE if a path exists, FALSE if not or on error.
+//
+bool pll_search_reachable(struct pll_search * search, unsigned int source, unsigned int target);
+
+#endif
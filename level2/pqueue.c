@@ -0,0 +1,468 @@
+// MIT License. Copyright (c) 2025 Kshitij Jain
+// See LICENSE file in the root of this repository.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pqueue.h"
+
+// Function pointers to (potentially) custom malloc() and
+// free() functions.
+//
+static void * (*malloc_fptr)(size_t size) = NULL;
+static void   (*free_fptr)(void* addr)    = NULL;
+
+// Heap arity. Children of slot i are slots 4i + 1 through 4i + 4.
+//
+#define PQUEUE_ARITY 4
+#define PQUEUE_CACHE_LINE_BYTES 64
+
+// Slots are shifted by this many entries so that every group of four
+// siblings starts on a cache line boundary.
+//
+#define PQUEUE_SLOT_OFFSET (PQUEUE_ARITY - 1)
+
+// Initial number of entries in a radix heap bucket.
+//
+#define RADIX_HEAP_DEFAULT_BUCKET_CAPACITY 16
+
+// Internal utility function that moves an entry towards the root
+// until its parent's key is no greater than its own.
+// \param pq    : Pointer to pqueue.
+// \param i     : Slot the entry starts at.
+// \param entry : Entry to place.
+//
+static void _pqueue_sift_up(struct pqueue* pq, size_t i, struct pqueue_entry entry) {
+  struct pqueue_entry* heap = pq->heap;
+
+  while (i > 0) {
+    size_t parent = (i - 1) / PQUEUE_ARITY;
+    if (heap[parent].key <= entry.key) {
+      break;
+    }
+
+    heap[i] = heap[parent];
+    pq->position[heap[i].item] = (uint32_t)i;
+    i = parent;
+  }
+
+  heap[i] = entry;
+  pq->position[entry.item] = (uint32_t)i;
+}
+
+// Internal utility function that moves an entry away from the root
+// until none of its children have a smaller key.
+// \param pq    : Pointer to pqueue.
+// \param i     : Slot the entry starts at.
+// \param entry : Entry to place.
+//
+static void _pqueue_sift_down(struct pqueue* pq, size_t i, struct pqueue_entry entry) {
+  struct pqueue_entry* heap = pq->heap;
+  size_t size = pq->size;
+
+  for (;;) {
+    size_t first = i * PQUEUE_ARITY + 1;
+    if (first >= size) {
+      break;
+    }
+
+    size_t last = first + PQUEUE_ARITY;
+    if (last > size) {
+      last = size;
+    }
+
+    size_t smallest = first;
+    for (size_t child = first + 1; child < last; child++) {
+      if (heap[child].key < heap[smallest].key) {
+        smallest = child;
+      }
+    }
+
+    if (heap[smallest].key >= entry.key) {
+      break;
+    }
+
+    heap[i] = heap[smallest];
+    pq->position[heap[i].item] = (uint32_t)i;
+    i = smallest;
+  }
+
+  heap[i] = entry;
+  pq->position[entry.item] = (uint32_t)i;
+}
+
+// Creates a new 4-ary heap.
+// PRECONDITION: Register malloc() and free() functions via the
+//               pqueue_register_malloc() and
+//               pqueue_register_free() functions.
+// \param max_items : Items pushed must be less than max_items.
+// Returns a new pqueue on success, NULL on failure.
+//
+struct pqueue * pqueue_create(size_t max_items) {
+  if (max_items == 0 || max_items >= PQUEUE_NOT_IN_HEAP) {
+    return NULL;
+  }
+
+  struct pqueue* pq = (struct pqueue*)malloc_fptr(sizeof(struct pqueue));
+  if (pq == NULL) {
+    return NULL;
+  }
+
+  size_t heap_bytes = (max_items + PQUEUE_SLOT_OFFSET) * sizeof(struct pqueue_entry)
+                      + PQUEUE_CACHE_LINE_BYTES;
+  pq->heap_allocation = malloc_fptr(heap_bytes);
+  pq->position = (uint32_t*)malloc_fptr(max_items * sizeof(uint32_t));
+  if (pq->heap_allocation == NULL || pq->position == NULL) {
+    free_fptr(pq->heap_allocation);
+    free_fptr(pq->position);
+    free_fptr(pq);
+    return NULL;
+  }
+
+  uintptr_t aligned = ((uintptr_t)pq->heap_allocation + PQUEUE_CACHE_LINE_BYTES - 1)
+                      & ~(uintptr_t)(PQUEUE_CACHE_LINE_BYTES - 1);
+  pq->heap = (struct pqueue_entry*)aligned + PQUEUE_SLOT_OFFSET;
+
+  memset(pq->position, 0xff, max_items * sizeof(uint32_t));
+  pq->max_items = max_items;
+  pq->size = 0;
+  return pq;
+}
+
+// Deletes a pqueue.
+// \param pq : Pointer to pqueue to delete.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool pqueue_delete(struct pqueue * pq) {
+  if (pq == NULL) {
+    return false;
+  }
+
+  free_fptr(pq->heap_allocation);
+  free_fptr(pq->position);
+  free_fptr(pq);
+  return true;
+}
+
+// Pushes an item with the given key. If the item is already in the
+// heap, this behaves like pqueue_decrease_key().
+// \param pq   : Pointer to pqueue.
+// \param item : Item to insert, less than max_items.
+// \param key  : Priority of the item, smaller pops first.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool pqueue_push(struct pqueue * pq, unsigned int item, double key) {
+  if (pq == NULL || item >= pq->max_items) {
+    return false;
+  }
+
+  if (pq->position[item] != PQUEUE_NOT_IN_HEAP) {
+    return pqueue_decrease_key(pq, item, key);
+  }
+
+  struct pqueue_entry entry = { key, item };
+  pq->size += 1;
+  _pqueue_sift_up(pq, pq->size - 1, entry);
+  return true;
+}
+
+// Pops the item with the smallest key.
+// \param pq   : Pointer to pqueue.
+// \param item : Pointer to popped item (provided by caller), if pop occurs.
+// \param key  : Pointer to popped key (provided by caller), may be NULL.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool pqueue_pop(struct pqueue * pq, unsigned int * item, double * key) {
+  if (pq == NULL || pq->size == 0) {
+    return false;
+  }
+
+  struct pqueue_entry top = pq->heap[0];
+  *item = top.item;
+  if (key != NULL) {
+    *key = top.key;
+  }
+
+  pq->position[top.item] = PQUEUE_NOT_IN_HEAP;
+  pq->size -= 1;
+  if (pq->size > 0) {
+    _pqueue_sift_down(pq, 0, pq->heap[pq->size]);
+  }
+
+  return true;
+}
+
+// Returns the item with the smallest key, but does not pop it.
+// \param pq   : Pointer to pqueue.
+// \param item : Pointer to item (provided by caller).
+// \param key  : Pointer to key (provided by caller), may be NULL.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool pqueue_next(struct pqueue * pq, unsigned int * item, double * key) {
+  if (pq == NULL || pq->size == 0) {
+    return false;
+  }
+
+  *item = pq->heap[0].item;
+  if (key != NULL) {
+    *key = pq->heap[0].key;
+  }
+  return true;
+}
+
+// Lowers the key of an item already in the heap.
+// \param pq   : Pointer to pqueue.
+// \param item : Item whose key is lowered.
+// \param key  : New key, must not be greater than the current one.
+// Returns TRUE on success, FALSE if the item is not in the heap or
+// the key would increase.
+//
+bool pqueue_decrease_key(struct pqueue * pq, unsigned int item, double key) {
+  if (!pqueue_contains(pq, item)) {
+    return false;
+  }
+
+  size_t i = pq->position[item];
+  if (key > pq->heap[i].key) {
+    return false;
+  }
+
+  struct pqueue_entry entry = { key, item };
+  _pqueue_sift_up(pq, i, entry);
+  return true;
+}
+
+// Returns whether an item is currently in the heap.
+// \param pq   : Pointer to pqueue.
+// \param item : Item to look up.
+// Returns TRUE if present, FALSE otherwise.
+//
+bool pqueue_contains(struct pqueue * pq, unsigned int item) {
+  if (pq == NULL || item >= pq->max_items) {
+    return false;
+  }
+
+  return pq->position[item] != PQUEUE_NOT_IN_HEAP;
+}
+
+// Returns the size of the pqueue.
+// \param pq : Pointer to pqueue.
+// Returns size on success, SIZE_MAX otherwise.
+//
+size_t pqueue_size(struct pqueue * pq) {
+  if (pq == NULL) {
+    return SIZE_MAX;
+  }
+
+  return pq->size;
+}
+
+// Empties the pqueue, keeping its memory for reuse.
+// \param pq : Pointer to pqueue.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool pqueue_clear(struct pqueue * pq) {
+  if (pq == NULL) {
+    return false;
+  }
+
+  // Only items still in the heap have a position to reset.
+  //
+  for (size_t i = 0; i < pq->size; i++) {
+    pq->position[pq->heap[i].item] = PQUEUE_NOT_IN_HEAP;
+  }
+  pq->size = 0;
+  return true;
+}
+
+// Internal utility function that maps a key to its radix heap bucket:
+// 0 if it equals the last popped key, otherwise one plus the index of
+// the highest bit in which the two differ.
+// \param last_key : Last key popped from the heap.
+// \param key      : Key to place.
+// Returns the bucket index.
+//
+static size_t _radix_heap_bucket_index(uint64_t last_key, uint64_t key) {
+  uint64_t diff = key ^ last_key;
+  return diff == 0 ? 0 : 64 - (size_t)__builtin_clzll(diff);
+}
+
+// Internal utility function that appends an entry to a bucket.
+// \param bucket : Pointer to bucket.
+// \param entry  : Entry to append.
+// Returns TRUE on success, FALSE otherwise.
+//
+static bool _radix_heap_bucket_push(struct radix_heap_bucket* bucket,
+                                    struct radix_heap_entry entry) {
+  if (bucket->size == bucket->capacity) {
+    size_t capacity = bucket->capacity == 0
+                      ? RADIX_HEAP_DEFAULT_BUCKET_CAPACITY
+                      : bucket->capacity * 2;
+    struct radix_heap_entry* entries =
+        (struct radix_heap_entry*)malloc_fptr(capacity * sizeof(struct radix_heap_entry));
+    if (entries == NULL) {
+      return false;
+    }
+
+    if (bucket->entries != NULL) {
+      memcpy(entries, bucket->entries, bucket->size * sizeof(struct radix_heap_entry));
+      free_fptr(bucket->entries);
+    }
+    bucket->entries = entries;
+    bucket->capacity = capacity;
+  }
+
+  bucket->entries[bucket->size++] = entry;
+  return true;
+}
+
+// Creates a new radix heap.
+// PRECONDITION: Register malloc() and free() functions via the
+//               pqueue_register_malloc() and
+//               pqueue_register_free() functions.
+// Returns a new radix_heap on success, NULL on failure.
+//
+struct radix_heap * radix_heap_create(void) {
+  struct radix_heap* rh = (struct radix_heap*)malloc_fptr(sizeof(struct radix_heap));
+  if (rh == NULL) {
+    return NULL;
+  }
+
+  memset(rh, 0, sizeof(struct radix_heap));
+  return rh;
+}
+
+// Deletes a radix_heap.
+// \param rh : Pointer to radix_heap to delete.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool radix_heap_delete(struct radix_heap * rh) {
+  if (rh == NULL) {
+    return false;
+  }
+
+  for (size_t i = 0; i < RADIX_HEAP_NUM_BUCKETS; i++) {
+    if (rh->buckets[i].entries != NULL) {
+      free_fptr(rh->buckets[i].entries);
+    }
+  }
+  free_fptr(rh);
+  return true;
+}
+
+// Pushes an item with the given key.
+// \param rh   : Pointer to radix_heap.
+// \param item : Item to insert.
+// \param key  : Priority, must not be less than the last popped key.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool radix_heap_push(struct radix_heap * rh, unsigned int item, uint64_t key) {
+  if (rh == NULL || key < rh->last_key) {
+    return false;
+  }
+
+  struct radix_heap_entry entry = { key, item };
+  size_t bucket = _radix_heap_bucket_index(rh->last_key, key);
+  if (!_radix_heap_bucket_push(&rh->buckets[bucket], entry)) {
+    return false;
+  }
+
+  rh->size += 1;
+  return true;
+}
+
+// Pops an item with the smallest key.
+// \param rh   : Pointer to radix_heap.
+// \param item : Pointer to popped item (provided by caller), if pop occurs.
+// \param key  : Pointer to popped key (provided by caller), may be NULL.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool radix_heap_pop(struct radix_heap * rh, unsigned int * item, uint64_t * key) {
+  if (rh == NULL || rh->size == 0) {
+    return false;
+  }
+
+  // Bucket 0 holds keys equal to last_key. If it is empty, the first
+  // non-empty bucket holds the minimum; make that the new last_key and
+  // redistribute the bucket, which moves every entry to a lower one.
+  //
+  if (rh->buckets[0].size == 0) {
+    size_t i = 1;
+    while (rh->buckets[i].size == 0) {
+      ++i;
+    }
+
+    struct radix_heap_bucket* bucket = &rh->buckets[i];
+    uint64_t min_key = bucket->entries[0].key;
+    for (size_t e = 1; e < bucket->size; e++) {
+      if (bucket->entries[e].key < min_key) {
+        min_key = bucket->entries[e].key;
+      }
+    }
+
+    rh->last_key = min_key;
+    for (size_t e = 0; e < bucket->size; e++) {
+      struct radix_heap_entry entry = bucket->entries[e];
+      size_t target = _radix_heap_bucket_index(min_key, entry.key);
+      if (!_radix_heap_bucket_push(&rh->buckets[target], entry)) {
+        // Entries [0, e) have moved, keep the rest in place.
+        //
+        memmove(bucket->entries, bucket->entries + e,
+                (bucket->size - e) * sizeof(struct radix_heap_entry));
+        bucket->size -= e;
+        return false;
+      }
+    }
+    bucket->size = 0;
+  }
+
+  struct radix_heap_bucket* bucket = &rh->buckets[0];
+  struct radix_heap_entry entry = bucket->entries[--bucket->size];
+  *item = entry.item;
+  if (key != NULL) {
+    *key = entry.key;
+  }
+
+  rh->size -= 1;
+  return true;
+}
+
+// Returns the size of the radix_heap.
+// \param rh : Pointer to radix_heap.
+// Returns size on success, SIZE_MAX otherwise.
+//
+size_t radix_heap_size(struct radix_heap * rh) {
+  if (rh == NULL) {
+    return SIZE_MAX;
+  }
+
+  return rh->size;
+}
+
+// Empties the radix_heap and resets its last popped key to 0, keeping
+// bucket memory for reuse.
+// \param rh : Pointer to radix_heap.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool radix_heap_clear(struct radix_heap * rh) {
+  if (rh == NULL) {
+    return false;
+  }
+
+  for (size_t i = 0; i < RADIX_HEAP_NUM_BUCKETS; i++) {
+    rh->buckets[i].size = 0;
+  }
+  rh->last_key = 0;
+  rh->size = 0;
+  return true;
+}
+
+bool pqueue_register_malloc(void * (*malloc)(size_t)) {
+  malloc_fptr = malloc;
+  return true;
+}
+
+bool pqueue_register_free(void (*free)(void*)) {
+  free_fptr = free;
+  return true;
+}
@@ -0,0 +1,198 @@
+// MIT License. Copyright (c) 2025 Kshitij Jain
+// See LICENSE file in the root of this repository.
+
+#ifndef _PQUEUE_H
+#define _PQUEUE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Priority queues for shortest path style workloads.
+//
+// Two implementations are provided:
+// 0. struct pqueue, a 4-ary implicit min-heap keyed on doubles, with
+//    decrease-key through a per-item position index. Items are
+//    unsigned ints in [0, max_items), e.g. vertex IDs.
+// 1. struct radix_heap, a min-heap for monotone integer keys: a key
+//    pushed must never be smaller than the last key popped. This is
+//    the case for Dijkstra with non-negative integer weights.
+//
+// As with the queue, make use of malloc_fptr() and free_fptr() for
+// all memory, registered via pqueue_register_malloc() and
+// pqueue_register_free().
+
+// Value of pqueue.position[item] for items not in the heap.
+//
+#define PQUEUE_NOT_IN_HEAP UINT32_MAX
+
+// A single heap slot. Four of these fill one 64 byte cache line, so
+// all children of a node are fetched together.
+//
+struct pqueue_entry {
+    double key;
+    unsigned int item;
+};
+
+// Definition of the 4-ary heap.
+//
+struct pqueue {
+    struct pqueue_entry* heap;     // Cache line aligned slot array.
+    void* heap_allocation;         // Unaligned pointer for free_fptr().
+    uint32_t* position;            // Heap slot of each item.
+    size_t max_items;
+    size_t size;
+};
+
+// A single radix heap entry.
+//
+struct radix_heap_entry {
+    uint64_t key;
+    unsigned int item;
+};
+
+// A radix heap bucket, a growable array of entries.
+//
+struct radix_heap_bucket {
+    struct radix_heap_entry* entries;
+    size_t size;
+    size_t capacity;
+};
+
+// Number of buckets: one for keys equal to the last popped key, plus
+// one per bit position where a key may first differ from it.
+//
+#define RADIX_HEAP_NUM_BUCKETS 65
+
+// Definition of the radix heap.
+//
+struct radix_heap {
+    struct radix_heap_bucket buckets[RADIX_HEAP_NUM_BUCKETS];
+    uint64_t last_key;
+    size_t size;
+};
+
+// Creates a new 4-ary heap.
+// PRECONDITION: Register malloc() and free() functions via the
+//               pqueue_register_malloc() and
+//               pqueue_register_free() functions.
+// \param max_items : Items pushed must be less than max_items.
+// Returns a new pqueue on success, NULL on failure.
+//
+struct pqueue * pqueue_create(size_t max_items);
+
+// Deletes a pqueue.
+// \param pq : Pointer to pqueue to delete.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool pqueue_delete(struct pqueue * pq);
+
+// Pushes an item with the given key. If the item is already in the
+// heap, this behaves like pqueue_decrease_key().
+// \param pq   : Pointer to pqueue.
+// \param item : Item to insert, less than max_items.
+// \param key  : Priority of the item, smaller pops first.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool pqueue_push(struct pqueue * pq, unsigned int item, double key);
+
+// Pops the item with the smallest key.
+// \param pq   : Pointer to pqueue.
+// \param item : Pointer to popped item (provided by caller), if pop occurs.
+// \param key  : Pointer to popped key (provided by caller), may be NULL.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool pqueue_pop(struct pqueue * pq, unsigned int * item, double * key);
+
+// Returns the item with the smallest key, but does not pop it.
+// \param pq   : Pointer to pqueue.
+// \param item : Pointer to item (provided by caller).
+// \param key  : Pointer to key (provided by caller), may be NULL.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool pqueue_next(struct pqueue * pq, unsigned int * item, double * key);
+
+// Lowers the key of an item already in the heap.
+// \param pq   : Pointer to pqueue.
+// \param item : Item whose key is lowered.
+// \param key  : New key, must not be greater than the current one.
+// Returns TRUE on success, FALSE if the item is not in the heap or
+// the key would increase.
+//
+bool pqueue_decrease_key(struct pqueue * pq, unsigned int item, double key);
+
+// Returns whether an item is currently in the heap.
+// \param pq   : Pointer to pqueue.
+// \param item : Item to look up.
+// Returns TRUE if present, FALSE otherwise.
+//
+bool pqueue_contains(struct pqueue * pq, unsigned int item);
+
+// Returns the size of the pqueue.
+// \param pq : Pointer to pqueue.
+// Returns size on success, SIZE_MAX otherwise.
+//
+size_t pqueue_size(struct pqueue * pq);
+
+// Empties the pqueue, keeping its memory for reuse.
+// \param pq : Pointer to pqueue.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool pqueue_clear(struct pqueue * pq);
+
+// Creates a new radix heap.
+// PRECONDITION: Register malloc() and free() functions via the
+//               pqueue_register_malloc() and
+//               pqueue_register_free() functions.
+// Returns a new radix_heap on success, NULL on failure.
+//
+struct radix_heap * radix_heap_create(void);
+
+// Deletes a radix_heap.
+// \param rh : Pointer to radix_heap to delete.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool radix_heap_delete(struct radix_heap * rh);
+
+// Pushes an item with the given key.
+// \param rh   : Pointer to radix_heap.
+// \param item : Item to insert.
+// \param key  : Priority, must not be less than the last popped key.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool radix_heap_push(struct radix_heap * rh, unsigned int item, uint64_t key);
+
+// Pops an item with the smallest key.
+// \param rh   : Pointer to radix_heap.
+// \param item : Pointer to popped item (provided by caller), if pop occurs.
+// \param key  : Pointer to popped key (provided by caller), may be NULL.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool radix_heap_pop(struct radix_heap * rh, unsigned int * item, uint64_t * key);
+
+// Returns the size of the radix_heap.
+// \param rh : Pointer to radix_heap.
+// Returns size on success, SIZE_MAX otherwise.
+//
+size_t radix_heap_size(struct radix_heap * rh);
+
+// Empties the radix_heap and resets its last popped key to 0, keeping
+// bucket memory for reuse.
+// \param rh : Pointer to radix_heap.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool radix_heap_clear(struct radix_heap * rh);
+
+// Registers malloc() function.
+// \param malloc : Function pointer to malloc()-like function.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool pqueue_register_malloc(void * (*malloc)(size_t));
+
+// Registers free() function.
+// \param free : Function pointer to free()-like function.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool pqueue_register_free(void (*free)(void*));
+
+#endif
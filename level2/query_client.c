@@ -0,0 +1,295 @@
+// MIT License. Copyright (c) 2025 Kshitij Jain
+// See LICENSE file in the root of this repository.
+
+// Load generator for the query server of queue_performance -s. It
+// replays the node list against the server, with up to a pipeline
+// depth of requests in flight, and prints the throughput and the
+// latency distribution seen by the client.
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "query_server.h"
+
+#define GRAB_CLOCK(x) clock_gettime(CLOCK_MONOTONIC, &x);
+
+// Requests sent unless -n says otherwise, and the pipeline depth
+// unless -d does.
+//
+#define DEFAULT_REQUESTS 1000
+#define DEFAULT_DEPTH    64
+
+// Bytes buffered towards and from the server.
+//
+#define CLIENT_BUFFER_BYTES (64 * 1024)
+
+long compute_timespec_diff(struct timespec start, struct timespec stop) {
+    return (stop.tv_sec - start.tv_sec) * 1000000000L + (stop.tv_nsec - start.tv_nsec);
+}
+
+int compare_longs(const void * a, const void * b) {
+    long x = *(const long*)a;
+    long y = *(const long*)b;
+    return (x > y) - (x < y);
+}
+
+// Reads every (source, target) pair of a node list.
+// \param path        : Path of the node list.
+// \param num_queries : Pointer to number of pairs (provided by caller).
+// Returns a new array of 2 * num_queries IDs, NULL on failure.
+//
+unsigned int * read_node_list(const char * path, size_t * num_queries) {
+    FILE * node_fptr = fopen(path, "r");
+    if (node_fptr == NULL) {
+        return NULL;
+    }
+
+    size_t capacity    = 128;
+    size_t count       = 0;
+    unsigned int * ids = (unsigned int*)malloc(2 * capacity * sizeof(unsigned int));
+    while (ids != NULL && fscanf(node_fptr, "%u %u\n", &ids[2 * count], &ids[2 * count + 1]) == 2) {
+        if (++count == capacity) {
+            capacity *= 2;
+            unsigned int * grown = (unsigned int*)realloc(ids, 2 * capacity * sizeof(unsigned int));
+            if (grown == NULL) {
+                free(ids);
+            }
+            ids = grown;
+        }
+    }
+    fclose(node_fptr);
+
+    if (ids != NULL && count == 0) {
+        free(ids);
+        ids = NULL;
+    }
+    *num_queries = count;
+    return ids;
+}
+
+// Connects to the server. The descriptor does not block, so that a
+// client sending a deep pipeline cannot stall while the server waits
+// for it to read replies.
+// \param path : Path of the server's socket.
+// Returns the connected descriptor, -1 on failure.
+//
+int connect_to_server(const char * path) {
+    struct sockaddr_un address;
+    if (strlen(path) >= sizeof(address.sun_path)) {
+        return -1;
+    }
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, path);
+    if (connect(fd, (struct sockaddr*)&address, sizeof(address)) != 0
+        || fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+void print_usage(const char * program) {
+    printf("Usage: %s [-d depth] [-f node_list] [-n requests] socket\n", program);
+    printf("  -d  Requests in flight at most. Defaults to %d.\n", DEFAULT_DEPTH);
+    printf("  -f  Node list to replay. Defaults to nodes.\n");
+    printf("  -n  Requests to send, cycling through the node list.\n");
+    printf("      Defaults to %d.\n", DEFAULT_REQUESTS);
+}
+
+int main(int argc, char ** argv) {
+    long num_requests      = DEFAULT_REQUESTS;
+    long depth             = DEFAULT_DEPTH;
+    const char * node_path = "nodes";
+
+    int option;
+    while ((option = getopt(argc, argv, "d:f:n:")) != -1) {
+        switch (option) {
+        case 'd':
+            depth = strtol(optarg, NULL, 10);
+            if (depth < 1) {
+                print_usage(argv[0]);
+                return 1;
+            }
+            break;
+        case 'f':
+            node_path = optarg;
+            break;
+        case 'n':
+            num_requests = strtol(optarg, NULL, 10);
+            if (num_requests < 1) {
+                print_usage(argv[0]);
+                return 1;
+            }
+            break;
+        default:
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (optind + 1 != argc) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    size_t num_queries = 0;
+    unsigned int * ids = read_node_list(node_path, &num_queries);
+    if (ids == NULL) {
+        printf("Error reading node list %s.\n", node_path);
+        return 1;
+    }
+
+    // Replies come back in request order, so reply r belongs to the
+    // request sent at sent_at[r].
+    //
+    int status                = 1;
+    size_t total              = (size_t)num_requests;
+    struct timespec * sent_at = (struct timespec*)malloc(total * sizeof(struct timespec));
+    long * latencies          = (long*)malloc(total * sizeof(long));
+    long * search_times       = (long*)malloc(total * sizeof(long));
+    char * send_buffer        = (char*)malloc(CLIENT_BUFFER_BYTES);
+    char * receive_buffer     = (char*)malloc(CLIENT_BUFFER_BYTES);
+    int fd                    = -1;
+    if (sent_at == NULL || latencies == NULL || search_times == NULL
+        || send_buffer == NULL || receive_buffer == NULL) {
+        printf("Failed to allocate client state.\n");
+        goto out;
+    }
+    fd = connect_to_server(argv[optind]);
+    if (fd < 0) {
+        printf("Error connecting to %s.\n", argv[optind]);
+        goto out;
+    }
+
+    size_t sent         = 0;
+    size_t received     = 0;
+    size_t paths_found  = 0;
+    size_t errors       = 0;
+    size_t send_size    = 0;
+    size_t send_offset  = 0;
+    size_t receive_size = 0;
+    bool failed         = false;
+
+    struct timespec start, stop;
+    GRAB_CLOCK(start)
+    while (received < total && !failed) {
+        // Top up the pipeline while there is room for another line.
+        //
+        if (send_offset == send_size) {
+            send_size   = 0;
+            send_offset = 0;
+        }
+        while (sent < total && sent - received < (size_t)depth
+               && send_size + QUERY_SERVER_MAX_LINE <= CLIENT_BUFFER_BYTES) {
+            size_t q = sent % num_queries;
+            send_size += (size_t)snprintf(send_buffer + send_size, QUERY_SERVER_MAX_LINE, "%u %u\n",
+                                          ids[2 * q], ids[2 * q + 1]);
+            GRAB_CLOCK(sent_at[sent])
+            ++sent;
+        }
+
+        struct pollfd poll_fd;
+        poll_fd.fd     = fd;
+        poll_fd.events = POLLIN | (send_offset < send_size ? POLLOUT : 0);
+        if (poll(&poll_fd, 1, -1) < 0) {
+            failed = errno != EINTR;
+            continue;
+        }
+
+        if ((poll_fd.revents & POLLOUT) && send_offset < send_size) {
+            ssize_t count = write(fd, send_buffer + send_offset, send_size - send_offset);
+            if (count < 0 && errno != EINTR && errno != EAGAIN) {
+                failed = true;
+            } else if (count > 0) {
+                send_offset += (size_t)count;
+            }
+        }
+
+        if (poll_fd.revents & (POLLIN | POLLHUP | POLLERR)) {
+            ssize_t count = read(fd, receive_buffer + receive_size, CLIENT_BUFFER_BYTES - receive_size);
+            if (count <= 0) {
+                failed = count == 0 || (errno != EINTR && errno != EAGAIN);
+                continue;
+            }
+            receive_size += (size_t)count;
+
+            struct timespec now;
+            GRAB_CLOCK(now)
+            size_t begin = 0;
+            for (size_t i = 0; i < receive_size && received < total; i++) {
+                if (receive_buffer[i] != '\n') {
+                    continue;
+                }
+                int found   = 0;
+                long search = 0;
+                receive_buffer[i] = '\0';
+                if (sscanf(receive_buffer + begin, "%d %ld", &found, &search) != 2 || found < 0) {
+                    ++errors;
+                }
+                paths_found            += found == 1;
+                search_times[received]  = search;
+                latencies[received]     = compute_timespec_diff(sent_at[received], now);
+                ++received;
+                begin = i + 1;
+            }
+            memmove(receive_buffer, receive_buffer + begin, receive_size - begin);
+            receive_size -= begin;
+        }
+    }
+    GRAB_CLOCK(stop)
+
+    if (failed) {
+        printf("Connection failed after %zu of %zu replies.\n", received, total);
+        goto out;
+    }
+
+    long nanoseconds   = compute_timespec_diff(start, stop);
+    long search_total  = 0;
+    long latency_total = 0;
+    for (size_t r = 0; r < total; r++) {
+        search_total  += search_times[r];
+        latency_total += latencies[r];
+    }
+    qsort(latencies, total, sizeof(long), compare_longs);
+
+    printf("Requests: %zu Pipeline depth: %ld Paths found: %zu Errors: %zu\n",
+           total, depth, paths_found, errors);
+    printf("Elapsed [s]: %0.3f (%0.1f queries/s)\n", (float)nanoseconds / 1000000000.0f,
+           (float)total * 1000000000.0f / (float)nanoseconds);
+    printf("Latency [us]: mean %0.1f p50 %0.1f p90 %0.1f p99 %0.1f max %0.1f\n",
+           (float)latency_total / (float)total / 1000.0f,
+           (float)latencies[total / 2] / 1000.0f,
+           (float)latencies[total * 9 / 10] / 1000.0f,
+           (float)latencies[total * 99 / 100] / 1000.0f,
+           (float)latencies[total - 1] / 1000.0f);
+    printf("Mean search time [us]: %0.1f, queueing, server and transport time [us]: %0.1f\n",
+           (float)search_total / (float)total / 1000.0f,
+           (float)(latency_total - search_total) / (float)total / 1000.0f);
+    status = 0;
+
+out:
+    if (fd >= 0) {
+        close(fd);
+    }
+    free(ids);
+    free(sent_at);
+    free(latencies);
+    free(search_times);
+    free(send_buffer);
+    free(receive_buffer);
+    return status;
+}
@@ -0,0 +1,239 @@
+// MIT License. Copyright (c) 2025 Kshitij Jain
+// See LICENSE file in the root of this repository.
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "query_executor.h"
+
+struct query_executor_worker {
+    struct query_executor * executor;
+    struct bfs_search * search;
+    pthread_t thread;
+};
+
+static void * _query_executor_worker_main(void * arg);
+
+// Internal utility function that starts the worker threads. New
+// workers block on pool_lock until the barriers are sized for the
+// threads that actually came up.
+// \param executor : Pointer to executor.
+// Returns TRUE on success, FALSE otherwise.
+//
+static bool _query_executor_start_workers(struct query_executor * executor) {
+    pthread_mutex_lock(&executor->pool_lock);
+    executor->num_threads = 1;
+    for (size_t w = 1; w < executor->num_workers; w++) {
+        struct query_executor_worker * worker = &executor->workers[w];
+        if (pthread_create(&worker->thread, NULL, _query_executor_worker_main, worker) != 0) {
+            break;
+        }
+        ++executor->num_threads;
+    }
+    unsigned count = (unsigned)executor->num_threads;
+    bool status = pthread_barrier_init(&executor->start_barrier, NULL, count) == 0;
+    if (status && pthread_barrier_init(&executor->done_barrier, NULL, count) != 0) {
+        pthread_barrier_destroy(&executor->start_barrier);
+        status = false;
+    }
+    executor->pool_started = status;
+    pthread_mutex_unlock(&executor->pool_lock);
+
+    return status;
+}
+
+// Creates an executor and the search state of all of its workers.
+// \param graph       : Graph to search.
+// \param reverse     : Transpose of graph, or NULL if mode does not need it.
+// \param compressed  : Compressed rows of graph, or NULL if mode does not
+//                      need them.
+// \param external    : Rows of graph on disk, or NULL if mode does not
+//                      need them.
+// \param dynamic     : Updatable copy of graph, or NULL if mode does not
+//                      need it. It must not be updated while a batch runs.
+// \param mode        : Search strategy of every query. A BFS_PARALLEL
+//                      search runs on its worker alone.
+// \param num_workers : Number of worker threads. 0 means 1.
+// Returns a new executor on success, NULL on failure.
+//
+struct query_executor * query_executor_create(struct graph * graph, struct graph * reverse,
+                                              struct compressed_graph * compressed,
+                                              struct external_graph * external,
+                                              struct dynamic_graph * dynamic,
+                                              enum bfs_mode mode, size_t num_workers)
+{
+    if (graph == NULL || (bfs_mode_needs_reverse(mode) && reverse == NULL)
+        || (bfs_mode_needs_compressed(mode) && compressed == NULL)
+        || (bfs_mode_needs_external(mode) && external == NULL)
+        || (bfs_mode_needs_dynamic(mode) && dynamic == NULL)) {
+        return NULL;
+    }
+    if (num_workers == 0) {
+        num_workers = 1;
+    }
+
+    struct query_executor * executor = (struct query_executor*)calloc(1, sizeof(struct query_executor));
+    if (executor == NULL) {
+        return NULL;
+    }
+    executor->mode    = mode;
+    executor->workers = (struct query_executor_worker*)calloc(num_workers,
+                                                              sizeof(struct query_executor_worker));
+    if (executor->workers == NULL) {
+        free(executor);
+        return NULL;
+    }
+    pthread_mutex_init(&executor->pool_lock, NULL);
+
+    for (size_t w = 0; w < num_workers; w++) {
+        executor->workers[w].executor = executor;
+        executor->workers[w].search   = bfs_search_create(graph, reverse, compressed, external, dynamic,
+                                                          mode == BFS_PARALLEL ? 1 : 0);
+        ++executor->num_workers;
+        if (executor->workers[w].search == NULL
+            || !bfs_search_reserve(executor->workers[w].search, mode)) {
+            query_executor_delete(executor);
+            return NULL;
+        }
+    }
+
+    if (!_query_executor_start_workers(executor)) {
+        query_executor_delete(executor);
+        return NULL;
+    }
+    return executor;
+}
+
+// Deletes an executor and frees all memory associated with it. The
+// graphs are owned by the caller and are not freed.
+// \param executor : Pointer to executor to delete.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool query_executor_delete(struct query_executor * executor) {
+    if (executor == NULL) {
+        return false;
+    }
+
+    // If the barriers could not be set up, workers see pool_started
+    // unset and exit. Otherwise they all reach start_barrier and exit
+    // once it releases them.
+    //
+    pthread_mutex_lock(&executor->pool_lock);
+    executor->shutdown = true;
+    pthread_mutex_unlock(&executor->pool_lock);
+    if (executor->pool_started) {
+        pthread_barrier_wait(&executor->start_barrier);
+    }
+    for (size_t w = 1; w < executor->num_threads; w++) {
+        pthread_join(executor->workers[w].thread, NULL);
+    }
+    if (executor->pool_started) {
+        pthread_barrier_destroy(&executor->start_barrier);
+        pthread_barrier_destroy(&executor->done_barrier);
+    }
+    pthread_mutex_destroy(&executor->pool_lock);
+
+    for (size_t w = 0; w < executor->num_workers; w++) {
+        bfs_search_delete(executor->workers[w].search);
+    }
+    free(executor->workers);
+    free(executor);
+    return true;
+}
+
+// Internal utility function that computes the nanoseconds between two
+// clock readings.
+//
+static long _query_executor_elapsed(struct timespec start, struct timespec stop) {
+    return (stop.tv_sec - start.tv_sec) * 1000000000L + (stop.tv_nsec - start.tv_nsec);
+}
+
+// Internal utility function that runs queries on one worker until the
+// batch is drained.
+//
+static void _query_executor_drain(struct query_executor_worker * worker) {
+    struct query_executor * executor = worker->executor;
+
+    for (;;) {
+        size_t index = __atomic_fetch_add(&executor->next_query, 1, __ATOMIC_RELAXED);
+        if (index >= executor->num_queries) {
+            return;
+        }
+
+        struct query * query = &executor->queries[index];
+        struct timespec start, stop, cpu_start, cpu_stop;
+        struct graph * graph = worker->search->graph;
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu_start);
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        query->found = bfs_search_run(worker->search, executor->mode,
+                                      graph_vertex_id(graph, query->source),
+                                      graph_vertex_id(graph, query->target));
+        clock_gettime(CLOCK_MONOTONIC, &stop);
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu_stop);
+
+        query->nanoseconds     = _query_executor_elapsed(start, stop);
+        query->cpu_nanoseconds = _query_executor_elapsed(cpu_start, cpu_stop);
+        query->nodes_visited   = worker->search->nodes_visited;
+        query->edges_examined  = worker->search->edges_examined;
+    }
+}
+
+// Internal utility function that parks a worker thread between
+// batches.
+//
+static void * _query_executor_worker_main(void * arg) {
+    struct query_executor_worker * worker = (struct query_executor_worker*)arg;
+    struct query_executor * executor      = worker->executor;
+
+    pthread_mutex_lock(&executor->pool_lock);
+    bool started = executor->pool_started;
+    pthread_mutex_unlock(&executor->pool_lock);
+    if (!started) {
+        return NULL;
+    }
+
+    for (;;) {
+        pthread_barrier_wait(&executor->start_barrier);
+        if (executor->shutdown) {
+            return NULL;
+        }
+        _query_executor_drain(worker);
+        pthread_barrier_wait(&executor->done_barrier);
+    }
+}
+
+// Runs a batch of queries and waits for all of them to finish.
+// Queries are handed out one at a time, so long searches do not hold
+// up the short ones queued behind them.
+// \param executor    : Pointer to executor.
+// \param queries     : Array of queries, results are written in place.
+// \param num_queries : Number of queries.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool query_executor_run(struct query_executor * executor,
+                        struct query * queries, size_t num_queries)
+{
+    if (executor == NULL || (queries == NULL && num_queries > 0)) {
+        return false;
+    }
+
+    executor->queries     = queries;
+    executor->num_queries = num_queries;
+    executor->next_query  = 0;
+
+    // Worker 0 runs on the calling thread. Workers whose thread could
+    // not be started left their share to the others. The batch is
+    // published before start_barrier releases the workers, and
+    // done_barrier holds the caller until every query is written.
+    //
+    if (num_queries <= 1 || executor->num_threads == 1) {
+        _query_executor_drain(&executor->workers[0]);
+        return true;
+    }
+    pthread_barrier_wait(&executor->start_barrier);
+    _query_executor_drain(&executor->workers[0]);
+    pthread_barrier_wait(&executor->done_barrier);
+
+    return true;
+}
@@ -0,0 +1,104 @@
+// MIT License. Copyright (c) 2025 Kshitij Jain
+// See LICENSE file in the root of this repository.
+
+#ifndef _QUERY_EXECUTOR_H
+#define _QUERY_EXECUTOR_H
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "bfs.h"
+#include "graph.h"
+
+// Runs batches of independent reachability queries on a pool of
+// worker threads.
+//
+// The graphs are shared read-only. Every worker owns a struct
+// bfs_search, and with it a private queue and visited set, so workers
+// never write to shared memory except to claim the next query.
+
+// One query of a batch. source and target are input vertex IDs, which
+// the executor translates for relabeled graphs. The executor fills in
+// everything after target.
+//
+struct query {
+    unsigned int source;
+    unsigned int target;
+
+    bool found;
+    size_t nodes_visited;
+    size_t edges_examined;
+    long nanoseconds;           // Wall time of this query alone.
+    long cpu_nanoseconds;       // CPU time of its worker during the query,
+                                // which excludes time spent descheduled
+                                // when workers outnumber cores.
+};
+
+struct query_executor_worker;
+
+struct query_executor {
+    enum bfs_mode mode;
+    size_t num_workers;
+    struct query_executor_worker * workers;
+
+    // Worker threads, started once and parked on start_barrier between
+    // batches, so that a batch costs two barrier waits rather than a
+    // thread start per worker. Worker 0 is the thread that calls
+    // query_executor_run(). num_threads counts the workers that run,
+    // the caller included.
+    //
+    size_t num_threads;
+    pthread_mutex_t pool_lock;
+    pthread_barrier_t start_barrier;
+    pthread_barrier_t done_barrier;
+    bool pool_started;
+    bool shutdown;
+
+    // Batch being run. Workers claim queries through next_query.
+    //
+    struct query * queries;
+    size_t num_queries;
+    size_t next_query;
+};
+
+// Creates an executor and the search state of all of its workers.
+// \param graph       : Graph to search.
+// \param reverse     : Transpose of graph, or NULL if mode does not need it.
+// \param compressed  : Compressed rows of graph, or NULL if mode does not
+//                      need them.
+// \param external    : Rows of graph on disk, or NULL if mode does not
+//                      need them.
+// \param dynamic     : Updatable copy of graph, or NULL if mode does not
+//                      need it. It must not be updated while a batch runs.
+// \param mode        : Search strategy of every query. A BFS_PARALLEL
+//                      search runs on its worker alone.
+// \param num_workers : Number of worker threads. 0 means 1.
+// Returns a new executor on success, NULL on failure.
+//
+struct query_executor * query_executor_create(struct graph * graph, struct graph * reverse,
+                                              struct compressed_graph * compressed,
+                                              struct external_graph * external,
+                                              struct dynamic_graph * dynamic,
+                                              enum bfs_mode mode, size_t num_workers);
+
+// Deletes an executor and frees all memory associated with it. The
+// graphs are owned by the caller and are not freed.
+// \param executor : Pointer to executor to delete.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool query_executor_delete(struct query_executor * executor);
+
+// Runs a batch of queries and waits for all of them to finish.
+// Queries are handed out one at a time, so long searches do not hold
+// up the short ones queued behind them. A batch of one query runs on
+// the calling thread without waking the other workers.
+// \param executor    : Pointer to executor.
+// \param queries     : Array of queries, results are written in place.
+// \param num_queries : Number of queries.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool query_executor_run(struct query_executor * executor,
+                        struct query * queries, size_t num_queries);
+
+#endif
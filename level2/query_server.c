@@ -0,0 +1,292 @@
+// MIT License. Copyright (c) 2025 Kshitij Jain
+// See LICENSE file in the root of this repository.
+
+#include <errno.h>
+#include <limits.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "query_server.h"
+
+// Bytes a reply may take, "-1 <nanoseconds>\n" at most.
+//
+#define QUERY_SERVER_MAX_REPLY 32
+
+// Connections the socket queues while the server is busy with one.
+//
+#define QUERY_SERVER_BACKLOG 16
+
+// Creates a server.
+// \param executor : Executor to answer the queries with.
+// Returns a new server on success, NULL on failure.
+//
+struct query_server * query_server_create(struct query_executor * executor) {
+    if (executor == NULL) {
+        return NULL;
+    }
+
+    struct query_server * server = (struct query_server*)calloc(1, sizeof(struct query_server));
+    if (server == NULL) {
+        return NULL;
+    }
+    server->executor = executor;
+    server->batch    = (struct query*)malloc(QUERY_SERVER_MAX_BATCH * sizeof(struct query));
+    server->valid    = (bool*)malloc(QUERY_SERVER_MAX_BATCH * sizeof(bool));
+    server->input    = (char*)malloc(QUERY_SERVER_INPUT_BYTES);
+    server->output   = (char*)malloc(QUERY_SERVER_MAX_BATCH * QUERY_SERVER_MAX_REPLY);
+    if (server->batch == NULL || server->valid == NULL || server->input == NULL
+        || server->output == NULL) {
+        query_server_delete(server);
+        return NULL;
+    }
+    return server;
+}
+
+// Deletes a server and frees all memory associated with it. The
+// executor is owned by the caller and is not freed.
+// \param server : Pointer to server to delete.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool query_server_delete(struct query_server * server) {
+    if (server == NULL) {
+        return false;
+    }
+
+    free(server->batch);
+    free(server->valid);
+    free(server->input);
+    free(server->output);
+    free(server);
+    return true;
+}
+
+// Internal utility function that parses an unsigned decimal number.
+// \param cursor : Pointer to parse position, advanced past the number.
+// \param end    : End of the line.
+// \param value  : Pointer to number (provided by caller).
+// Returns TRUE on success, FALSE if there is no number that fits.
+//
+static bool _query_server_parse_id(const char ** cursor, const char * end, unsigned int * value) {
+    const char * p = *cursor;
+    while (p < end && (*p == ' ' || *p == '\t')) {
+        ++p;
+    }
+    if (p == end || *p < '0' || *p > '9') {
+        return false;
+    }
+
+    unsigned long long number = 0;
+    while (p < end && *p >= '0' && *p <= '9') {
+        number = number * 10 + (unsigned long long)(*p++ - '0');
+        if (number > UINT_MAX) {
+            return false;
+        }
+    }
+    *value  = (unsigned int)number;
+    *cursor = p;
+    return true;
+}
+
+// Internal utility function that adds a request line to the batch. A
+// line longer than QUERY_SERVER_MAX_LINE does not parse, even if it
+// arrived whole in one read().
+// \param server : Pointer to server.
+// \param index  : Position of the request in the batch.
+// \param line   : First character of the line.
+// \param end    : End of the line, its newline excluded.
+//
+static void _query_server_add_request(struct query_server * server, size_t index,
+                                      const char * line, const char * end)
+{
+    struct query * query = &server->batch[index];
+    const char * cursor  = line;
+    bool valid = end - line < QUERY_SERVER_MAX_LINE
+        && _query_server_parse_id(&cursor, end, &query->source)
+        && _query_server_parse_id(&cursor, end, &query->target);
+    while (valid && cursor < end && (*cursor == ' ' || *cursor == '\t' || *cursor == '\r')) {
+        ++cursor;
+    }
+    valid = valid && cursor == end;
+
+    // Requests that did not parse still take their place in the
+    // batch, with IDs no graph has, so their search returns at once.
+    //
+    if (!valid) {
+        query->source = UINT_MAX;
+        query->target = UINT_MAX;
+    }
+    server->valid[index] = valid;
+}
+
+// Internal utility function that writes a whole buffer.
+// \param fd    : File descriptor.
+// \param data  : Buffer to write.
+// \param bytes : Number of bytes.
+// Returns TRUE on success, FALSE otherwise.
+//
+static bool _query_server_write_all(int fd, const char * data, size_t bytes) {
+    while (bytes > 0) {
+        ssize_t count = write(fd, data, bytes);
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            return false;
+        }
+        data  += count;
+        bytes -= (size_t)count;
+    }
+    return true;
+}
+
+// Internal utility function that answers a batch and writes all of
+// its replies at once.
+// \param server      : Pointer to server.
+// \param num_queries : Number of requests in the batch.
+// \param out_fd      : Descriptor to write replies to.
+// Returns TRUE on success, FALSE otherwise.
+//
+static bool _query_server_answer(struct query_server * server, size_t num_queries, int out_fd) {
+    if (num_queries == 0) {
+        return true;
+    }
+    if (!query_executor_run(server->executor, server->batch, num_queries)) {
+        return false;
+    }
+
+    size_t bytes = 0;
+    for (size_t q = 0; q < num_queries; q++) {
+        const struct query * query = &server->batch[q];
+        if (server->valid[q]) {
+            bytes += (size_t)snprintf(server->output + bytes, QUERY_SERVER_MAX_REPLY, "%d %ld\n",
+                                      query->found ? 1 : 0, query->nanoseconds);
+        } else {
+            bytes += (size_t)snprintf(server->output + bytes, QUERY_SERVER_MAX_REPLY, "-1 0\n");
+            ++server->malformed;
+        }
+    }
+    server->queries += num_queries;
+    ++server->batches;
+    return _query_server_write_all(out_fd, server->output, bytes);
+}
+
+// Answers requests read from one descriptor on another until the
+// input ends. A last request without a newline is answered as well.
+// \param server : Pointer to server.
+// \param in_fd  : Descriptor to read requests from.
+// \param out_fd : Descriptor to write replies to.
+// Returns TRUE once the input ends, FALSE on error.
+//
+bool query_server_serve(struct query_server * server, int in_fd, int out_fd) {
+    if (server == NULL) {
+        return false;
+    }
+
+    // A line longer than QUERY_SERVER_MAX_LINE is answered as soon as
+    // it is too long, and the rest of it is dropped.
+    //
+    bool discarding    = false;
+    server->input_size = 0;
+    ++server->connections;
+    for (;;) {
+        ssize_t count = read(in_fd, server->input + server->input_size,
+                             QUERY_SERVER_INPUT_BYTES - server->input_size);
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count < 0) {
+            return false;
+        }
+        bool end = count == 0;
+        server->input_size += (size_t)count;
+
+        const char * input = server->input;
+        size_t num_queries = 0;
+        size_t begin       = 0;
+        for (size_t i = 0; i < server->input_size; i++) {
+            if (input[i] != '\n') {
+                continue;
+            }
+            if (discarding) {
+                discarding = false;
+            } else {
+                _query_server_add_request(server, num_queries++, input + begin, input + i);
+            }
+            begin = i + 1;
+        }
+        if (end && begin < server->input_size && !discarding) {
+            _query_server_add_request(server, num_queries++, input + begin, input + server->input_size);
+            begin = server->input_size;
+        }
+
+        size_t rest = server->input_size - begin;
+        if (discarding || rest >= QUERY_SERVER_MAX_LINE) {
+            if (!discarding) {
+                _query_server_add_request(server, num_queries++, input, input);
+                discarding = true;
+            }
+            rest = 0;
+        }
+        memmove(server->input, server->input + begin, rest);
+        server->input_size = rest;
+
+        if (!_query_server_answer(server, num_queries, out_fd)) {
+            return false;
+        }
+        if (end) {
+            return true;
+        }
+    }
+}
+
+// Listens on a Unix domain socket and serves its clients one after
+// another until accept() fails. A file already at path is replaced.
+// \param server : Pointer to server.
+// \param path   : Path of the socket.
+// Returns FALSE, as it only returns on error.
+//
+bool query_server_listen(struct query_server * server, const char * path) {
+    struct sockaddr_un address;
+    if (server == NULL || path == NULL || strlen(path) >= sizeof(address.sun_path)) {
+        return false;
+    }
+
+    int listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listen_fd < 0) {
+        return false;
+    }
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, path);
+    unlink(path);
+    if (bind(listen_fd, (struct sockaddr*)&address, sizeof(address)) != 0
+        || listen(listen_fd, QUERY_SERVER_BACKLOG) != 0) {
+        close(listen_fd);
+        return false;
+    }
+
+    // A client that leaves before its replies are written fails that
+    // write, it must not end the server.
+    //
+    signal(SIGPIPE, SIG_IGN);
+    for (;;) {
+        int client_fd = accept(listen_fd, NULL, NULL);
+        if (client_fd < 0 && errno == EINTR) {
+            continue;
+        }
+        if (client_fd < 0) {
+            break;
+        }
+        query_server_serve(server, client_fd, client_fd);
+        close(client_fd);
+    }
+
+    close(listen_fd);
+    unlink(path);
+    return false;
+}
@@ -0,0 +1,87 @@
+// MIT License. Copyright (c) 2025 Kshitij Jain
+// See LICENSE file in the root of this repository.
+
+#ifndef _QUERY_SERVER_H
+#define _QUERY_SERVER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "query_executor.h"
+
+// Answers reachability queries against a graph that stays loaded,
+// over a line protocol on a Unix domain socket or a pair of file
+// descriptors.
+//
+// A request is one line holding an input vertex ID pair
+//     <source> <target>\n
+// and its reply, sent in request order, is
+//     <found> <nanoseconds>\n
+// where found is 1 if there is a path, 0 if not and -1 if the request
+// could not be parsed, and nanoseconds is the time of the search
+// alone. Clients may pipeline requests. The server answers every
+// complete request a read() returns as one query_executor batch, and
+// writes all of its replies with one write(), so a deep pipeline
+// costs about one system call per side per batch.
+
+// Bytes a request line may take, its newline included.
+//
+#define QUERY_SERVER_MAX_LINE 64
+
+// Bytes read at a time. Every request takes at least one of them, so
+// this bounds the requests per batch as well.
+//
+#define QUERY_SERVER_INPUT_BYTES (16 * 1024)
+#define QUERY_SERVER_MAX_BATCH QUERY_SERVER_INPUT_BYTES
+
+struct query_server {
+    struct query_executor * executor;   // Owned by the caller.
+
+    // Current batch. valid[i] is FALSE for requests that did not
+    // parse, which are answered without a search.
+    //
+    struct query * batch;               // QUERY_SERVER_MAX_BATCH each.
+    bool * valid;
+    char * input;                       // QUERY_SERVER_INPUT_BYTES.
+    size_t input_size;
+    char * output;                      // Replies of one batch.
+
+    // Statistics since the server was created.
+    //
+    size_t connections;
+    size_t queries;
+    size_t batches;
+    size_t malformed;
+};
+
+// Creates a server.
+// \param executor : Executor to answer the queries with.
+// Returns a new server on success, NULL on failure.
+//
+struct query_server * query_server_create(struct query_executor * executor);
+
+// Deletes a server and frees all memory associated with it. The
+// executor is owned by the caller and is not freed.
+// \param server : Pointer to server to delete.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool query_server_delete(struct query_server * server);
+
+// Answers requests read from one descriptor on another until the
+// input ends. A last request without a newline is answered as well.
+// \param server : Pointer to server.
+// \param in_fd  : Descriptor to read requests from.
+// \param out_fd : Descriptor to write replies to.
+// Returns TRUE once the input ends, FALSE on error.
+//
+bool query_server_serve(struct query_server * server, int in_fd, int out_fd);
+
+// Listens on a Unix domain socket and serves its clients one after
+// another until accept() fails. A file already at path is replaced.
+// \param server : Pointer to server.
+// \param path   : Path of the socket.
+// Returns FALSE, as it only returns on error.
+//
+bool query_server_listen(struct query_server * server, const char * path);
+
+#endif
@@ -1,27 +1,161 @@
 // MIT License. Copyright (c) 2025 Kshitij Jain
 // See LICENSE file in the root of this repository.
 
+#include <limits.h>
+#include <linux/futex.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
 #include "queue.h"
 
+// Hint to the CPU that we are in a spin-wait loop.
+//
+#if defined(__x86_64__) || defined(__i386__)
+#define QUEUE_CPU_RELAX() __builtin_ia32_pause()
+#elif defined(__aarch64__)
+#define QUEUE_CPU_RELAX() __asm__ __volatile__("yield")
+#else
+#define QUEUE_CPU_RELAX()
+#endif
+
 // Function pointers to (potentially) custom malloc() and
 // free() functions.
 //
 static void * (*malloc_fptr)(size_t size) = NULL;
-static void   (*free_fptr)(void* addr)    = NULL; 
+static void   (*free_fptr)(void* addr)    = NULL;
+
+// Internal utility function that copies the contents of the ring
+// buffer, oldest entry first, into a flat array.
+// \param queue : Pointer to queue.
+// \param out   : Array of at least queue->size entries.
+// \param count : Number of entries to copy, starting at the head.
+//
+static void _queue_copy_out(struct queue* queue, unsigned int* out, size_t count) {
+  size_t first = queue->capacity - queue->head;
+  if (first > count) {
+    first = count;
+  }
+
+  memcpy(out, queue->data + queue->head, first * sizeof(unsigned int));
+  memcpy(out + first, queue->data, (count - first) * sizeof(unsigned int));
+}
+
+// Internal utility function that grows the ring buffer so that at least
+// min_capacity entries fit. Capacity stays a power of two.
+// \param queue        : Pointer to queue.
+// \param min_capacity : Number of entries that must fit after growing.
+// Returns TRUE on success, FALSE otherwise.
+//
+static bool _queue_grow(struct queue* queue, size_t min_capacity) {
+  size_t capacity = queue->capacity;
+  while (capacity < min_capacity) {
+    capacity *= 2;
+  }
+
+  unsigned int* data = (unsigned int*)malloc_fptr(capacity * sizeof(unsigned int));
+  if (data == NULL) {
+    return false;
+  }
+
+  _queue_copy_out(queue, data, queue->size);
+  free_fptr(queue->data);
+
+  queue->data = data;
+  queue->capacity = capacity;
+  queue->head = 0;
+  return true;
+}
+
+// Internal utility functions that take and release the lock of a
+// blocking queue. Non-blocking queues skip locking entirely.
+// \param queue : Pointer to queue.
+//
+static inline void _queue_lock(struct queue* queue) {
+  if (queue->blocking) {
+    pthread_mutex_lock(&queue->lock);
+  }
+}
+
+static inline void _queue_unlock(struct queue* queue) {
+  if (queue->blocking) {
+    pthread_mutex_unlock(&queue->lock);
+  }
+}
+
+// Internal utility function that releases the lock after a push and,
+// if the push took the queue from empty to non-empty, wakes every
+// consumer parked in queue_pop_wait(). Pushes onto an already
+// non-empty queue never make a system call.
+// \param queue             : Pointer to queue.
+// \param became_non_empty : Whether the push ended an empty period.
+//
+static inline void _queue_unlock_after_push(struct queue* queue, bool became_non_empty) {
+  if (!queue->blocking) {
+    return;
+  }
+
+  if (became_non_empty) {
+    __atomic_add_fetch(&queue->wake_seq, 1, __ATOMIC_SEQ_CST);
+  }
+  pthread_mutex_unlock(&queue->lock);
+
+  if (became_non_empty && __atomic_load_n(&queue->waiters, __ATOMIC_SEQ_CST) > 0) {
+    syscall(SYS_futex, &queue->wake_seq, FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0);
+  }
+}
 
 // Creates a new queue.
 // PRECONDITION: Register malloc() and free() functions via the
-//               queue_register_malloc() and 
+//               queue_register_malloc() and
 //               queue_register_free() functions.
 // Returns a new linked_list on success, NULL on failure.
 //
 struct queue * queue_create(void) {
   struct queue* queue = (struct queue*)malloc_fptr(sizeof(struct queue));
-  return queue != NULL
-         ? (queue->ll = linked_list_create(), queue)
-         : queue;
+  if (queue == NULL) {
+    return NULL;
+  }
+
+  queue->data = (unsigned int*)malloc_fptr(QUEUE_DEFAULT_CAPACITY * sizeof(unsigned int));
+  if (queue->data == NULL) {
+    free_fptr(queue);
+    return NULL;
+  }
+
+  queue->ll = NULL;
+  queue->capacity = QUEUE_DEFAULT_CAPACITY;
+  queue->head = 0;
+  queue->size = 0;
+  queue->blocking = false;
+  queue->wake_seq = 0;
+  queue->waiters = 0;
+  return queue;
+}
+
+// Creates a new queue that is safe to share between producer and
+// consumer threads and supports queue_pop_wait(). Every operation
+// takes the queue's lock.
+// PRECONDITION: Register malloc() and free() functions via the
+//               queue_register_malloc() and
+//               queue_register_free() functions.
+// Returns a new queue on success, NULL on failure.
+//
+struct queue * queue_create_blocking(void) {
+  struct queue* queue = queue_create();
+  if (queue == NULL) {
+    return NULL;
+  }
+
+  if (pthread_mutex_init(&queue->lock, NULL) != 0) {
+    queue_delete(queue);
+    return NULL;
+  }
+
+  queue->blocking = true;
+  return queue;
 }
 
 // Deletes a linked_list.
@@ -33,9 +167,12 @@ bool queue_delete(struct queue * queue) {
     return false;
   }
 
-  linked_list_delete(queue->ll);
+  if (queue->blocking) {
+    pthread_mutex_destroy(&queue->lock);
+  }
+  free_fptr(queue->data);
   free_fptr(queue);
-  
+
   return true;
 }
 
@@ -49,7 +186,87 @@ bool queue_push(struct queue * queue, unsigned int data) {
     return false;
   }
 
-  return linked_list_insert_end(queue->ll, data);
+  _queue_lock(queue);
+  bool was_empty = queue->size == 0;
+  if (queue->size == queue->capacity && !_queue_grow(queue, queue->size + 1)) {
+    _queue_unlock(queue);
+    return false;
+  }
+
+  queue->data[(queue->head + queue->size) & (queue->capacity - 1)] = data;
+  queue->size += 1;
+  _queue_unlock_after_push(queue, was_empty);
+  return true;
+}
+
+// Pushes n unsigned ints onto the queue, in order.
+// \param queue : Pointer to queue.
+// \param data  : Array of n entries to insert.
+// \param n     : Number of entries to insert.
+// Returns TRUE on success, FALSE otherwise. On failure the queue is
+// left unmodified.
+//
+bool queue_push_n(struct queue * queue, const unsigned int * data, size_t n) {
+  if (queue == NULL || (data == NULL && n > 0)) {
+    return false;
+  }
+
+  _queue_lock(queue);
+  bool was_empty = queue->size == 0;
+  if (queue->capacity - queue->size < n && !_queue_grow(queue, queue->size + n)) {
+    _queue_unlock(queue);
+    return false;
+  }
+
+  // The free region starts at the tail and may wrap around the end
+  // of the buffer, so at most two copies are needed.
+  //
+  size_t tail  = (queue->head + queue->size) & (queue->capacity - 1);
+  size_t first = queue->capacity - tail;
+  if (first > n) {
+    first = n;
+  }
+
+  memcpy(queue->data + tail, data, first * sizeof(unsigned int));
+  memcpy(queue->data, data + first, (n - first) * sizeof(unsigned int));
+
+  queue->size += n;
+  _queue_unlock_after_push(queue, was_empty && n > 0);
+  return true;
+}
+
+// Pre-sizes the queue so that at least n entries fit without the
+// ring buffer having to grow.
+// \param queue : Pointer to queue.
+// \param n     : Number of entries to make room for.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool queue_reserve(struct queue * queue, size_t n) {
+  if (queue == NULL) {
+    return false;
+  }
+
+  _queue_lock(queue);
+  bool status = queue->capacity >= n || _queue_grow(queue, n);
+  _queue_unlock(queue);
+  return status;
+}
+
+// Empties the queue, but keeps its capacity so that it can be reused
+// without reallocating.
+// \param queue : Pointer to queue.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool queue_clear(struct queue * queue) {
+  if (queue == NULL) {
+    return false;
+  }
+
+  _queue_lock(queue);
+  queue->head = 0;
+  queue->size = 0;
+  _queue_unlock(queue);
+  return true;
 }
 
 // Pops an unsigned int from the queue, if one exists.
@@ -62,12 +279,113 @@ bool queue_pop(struct queue * queue, unsigned int * popped_data) {
     return false;
   }
 
-  if (!queue_next(queue, popped_data)) {
+  _queue_lock(queue);
+  if (queue->size == 0) {
+    _queue_unlock(queue);
     return false;
   }
-  
-  return linked_list_remove(queue->ll, 0);
-} 
+
+  // Fast path: one load from the head slot and one store of the new
+  // head index. No iterator, no call through queue_next().
+  //
+  *popped_data = queue->data[queue->head];
+  queue->head = (queue->head + 1) & (queue->capacity - 1);
+  queue->size -= 1;
+  _queue_unlock(queue);
+  return true;
+}
+
+// Pops an unsigned int from a blocking queue, waiting for one to be
+// pushed if the queue is empty. Spins briefly, then sleeps on a futex
+// until a push makes the queue non-empty or the timeout expires.
+// PRECONDITION: queue was created by queue_create_blocking().
+// \param queue       : Pointer to queue.
+// \param popped_data : Pointer to popped data (provided by caller), if pop occurs.
+// \param timeout_ns  : Maximum time to wait, negative to wait forever.
+// Returns TRUE on success, FALSE on timeout or failure.
+//
+bool queue_pop_wait(struct queue * queue, unsigned int * popped_data, long timeout_ns) {
+  if (queue == NULL || !queue->blocking) {
+    return false;
+  }
+
+  struct timespec deadline;
+  if (timeout_ns >= 0) {
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec  += timeout_ns / 1000000000L;
+    deadline.tv_nsec += timeout_ns % 1000000000L;
+    if (deadline.tv_nsec >= 1000000000L) {
+      deadline.tv_sec  += 1;
+      deadline.tv_nsec -= 1000000000L;
+    }
+  }
+
+  for (;;) {
+    // Spin: a producer that is about to push saves us a system call.
+    // The unlocked size read is only a hint, queue_pop() rechecks it.
+    //
+    for (size_t i = 0; i < QUEUE_SPIN_ITERATIONS; i++) {
+      if (__atomic_load_n(&queue->size, __ATOMIC_RELAXED) > 0 &&
+          queue_pop(queue, popped_data)) {
+        return true;
+      }
+      QUEUE_CPU_RELAX();
+    }
+
+    // Park: announce ourselves, snapshot the futex word, and recheck
+    // under the lock. A push that lands after the snapshot bumps the
+    // word, so FUTEX_WAIT returns at once instead of missing it.
+    //
+    __atomic_add_fetch(&queue->waiters, 1, __ATOMIC_SEQ_CST);
+    uint32_t seq = __atomic_load_n(&queue->wake_seq, __ATOMIC_SEQ_CST);
+    if (queue_pop(queue, popped_data)) {
+      __atomic_sub_fetch(&queue->waiters, 1, __ATOMIC_SEQ_CST);
+      return true;
+    }
+
+    struct timespec remaining;
+    struct timespec* timeout = NULL;
+    if (timeout_ns >= 0) {
+      struct timespec now;
+      clock_gettime(CLOCK_MONOTONIC, &now);
+      remaining.tv_sec  = deadline.tv_sec - now.tv_sec;
+      remaining.tv_nsec = deadline.tv_nsec - now.tv_nsec;
+      if (remaining.tv_nsec < 0) {
+        remaining.tv_sec  -= 1;
+        remaining.tv_nsec += 1000000000L;
+      }
+      if (remaining.tv_sec < 0) {
+        __atomic_sub_fetch(&queue->waiters, 1, __ATOMIC_SEQ_CST);
+        return false;
+      }
+      timeout = &remaining;
+    }
+
+    syscall(SYS_futex, &queue->wake_seq, FUTEX_WAIT_PRIVATE, seq, timeout, NULL, 0);
+    __atomic_sub_fetch(&queue->waiters, 1, __ATOMIC_SEQ_CST);
+  }
+}
+
+// Pops up to max unsigned ints from the queue.
+// \param queue : Pointer to queue.
+// \param out   : Array (provided by caller) of at least max entries.
+// \param max   : Maximum number of entries to pop.
+// Returns the number of entries popped, 0 if the queue is empty or on failure.
+//
+size_t queue_pop_n(struct queue * queue, unsigned int * out, size_t max) {
+  if (queue == NULL || out == NULL) {
+    return 0;
+  }
+
+  _queue_lock(queue);
+  size_t count = queue->size < max ? queue->size : max;
+  _queue_copy_out(queue, out, count);
+
+  queue->head = (queue->head + count) & (queue->capacity - 1);
+  queue->size -= count;
+  _queue_unlock(queue);
+  return count;
+}
 
 // Returns the size of the queue.
 // \param queue : Pointer to queue.
@@ -78,7 +396,10 @@ size_t queue_size(struct queue * queue) {
     return SIZE_MAX;
   }
 
-  return linked_list_size(queue->ll);
+  _queue_lock(queue);
+  size_t size = queue->size;
+  _queue_unlock(queue);
+  return size;
 }
 
 // Returns whether an entry exists to be popped.
@@ -100,17 +421,17 @@ bool queue_has_next(struct queue * queue) {
 // Returns TRUE on success, FALSE otherwise.
 //
 bool queue_next(struct queue * queue, unsigned int * popped_data) {
-  if (!queue_has_next(queue)) {
+  if (queue == NULL) {
     return false;
   }
 
-  struct iterator* iter = linked_list_create_iterator(queue->ll, 0);
-  if (iter == NULL) {
-    return false;
+  _queue_lock(queue);
+  bool status = queue->size > 0;
+  if (status) {
+    *popped_data = queue->data[queue->head];
   }
-
-  *popped_data = iter->data;
-  return true;
+  _queue_unlock(queue);
+  return status;
 }
 
 
@@ -4,6 +4,8 @@
 #ifndef _QUEUE_H
 #define _QUEUE_H
 
+#include <pthread.h>
+
 #include "linked_list.h"
 
 // Some rules for Pointer Wars 2025 week 2:
@@ -17,12 +19,39 @@
 //    test infrastructure a bit more flexility. See linked_list.c for
 //    declarations of those function pointers.
 
+// Default number of entries a freshly created queue can hold before
+// its ring buffer has to grow. Must be a power of two.
+//
+#define QUEUE_DEFAULT_CAPACITY 1024
+
 // Definition of the queue.
+//
+// Entries live in a power-of-two sized ring buffer rather than in
+// linked_list nodes, so that a whole adjacency row can be pushed with
+// one capacity check and a memcpy(), and drained the same way.
+// The ll member is kept so that test infrastructure built against the
+// original layout still links; it is always NULL.
 // 
 struct queue {
     struct linked_list* ll;
+    unsigned int* data;
+    size_t capacity;
+    size_t head;
+    size_t size;
+
+    // Blocking mode only, see queue_create_blocking().
+    //
+    bool blocking;
+    pthread_mutex_t lock;
+    uint32_t wake_seq;   // Futex word, bumped when the queue stops being empty.
+    uint32_t waiters;    // Consumers parked in queue_pop_wait().
 };
 
+// Number of times queue_pop_wait() polls an empty queue before it
+// parks on the futex.
+//
+#define QUEUE_SPIN_ITERATIONS 1024
+
 
 // Creates a new queue.
 // PRECONDITION: Register malloc() and free() functions via the
@@ -32,6 +61,16 @@ struct queue {
 //
 struct queue * queue_create(void);
 
+// Creates a new queue that is safe to share between producer and
+// consumer threads and supports queue_pop_wait(). Every operation
+// takes the queue's lock.
+// PRECONDITION: Register malloc() and free() functions via the
+//               queue_register_malloc() and
+//               queue_register_free() functions.
+// Returns a new queue on success, NULL on failure.
+//
+struct queue * queue_create_blocking(void);
+
 // Deletes a linked_list.
 // \param queue : Pointer to queue to delete
 // Returns TRUE on success, FALSE otherwise.
@@ -45,6 +84,30 @@ bool queue_delete(struct queue * queue);
 //
 bool queue_push(struct queue * queue, unsigned int data);
 
+// Pushes n unsigned ints onto the queue, in order.
+// \param queue : Pointer to queue.
+// \param data  : Array of n entries to insert.
+// \param n     : Number of entries to insert.
+// Returns TRUE on success, FALSE otherwise. On failure the queue is
+// left unmodified.
+//
+bool queue_push_n(struct queue * queue, const unsigned int * data, size_t n);
+
+// Pre-sizes the queue so that at least n entries fit without the
+// ring buffer having to grow.
+// \param queue : Pointer to queue.
+// \param n     : Number of entries to make room for.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool queue_reserve(struct queue * queue, size_t n);
+
+// Empties the queue, but keeps its capacity so that it can be reused
+// without reallocating.
+// \param queue : Pointer to queue.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool queue_clear(struct queue * queue);
+
 // Pops an unsigned int from the queue, if one exists.
 // \param queue       : Pointer to queue.
 // \param popped_data : Pointer to popped data (provided by caller), if pop occurs.
@@ -52,6 +115,25 @@ bool queue_push(struct queue * queue, unsigned int data);
 //
 bool queue_pop(struct queue * queue, unsigned int * popped_data); 
 
+// Pops up to max unsigned ints from the queue.
+// \param queue : Pointer to queue.
+// \param out   : Array (provided by caller) of at least max entries.
+// \param max   : Maximum number of entries to pop.
+// Returns the number of entries popped, 0 if the queue is empty or on failure.
+//
+size_t queue_pop_n(struct queue * queue, unsigned int * out, size_t max);
+
+// Pops an unsigned int from a blocking queue, waiting for one to be
+// pushed if the queue is empty. Spins briefly, then sleeps on a futex
+// until a push makes the queue non-empty or the timeout expires.
+// PRECONDITION: queue was created by queue_create_blocking().
+// \param queue       : Pointer to queue.
+// \param popped_data : Pointer to popped data (provided by caller), if pop occurs.
+// \param timeout_ns  : Maximum time to wait, negative to wait forever.
+// Returns TRUE on success, FALSE on timeout or failure.
+//
+bool queue_pop_wait(struct queue * queue, unsigned int * popped_data, long timeout_ns);
+
 // Returns the size of the queue.
 // \param queue : Pointer to queue.
 // Returns size on success, SIZE_MAX otherwise.
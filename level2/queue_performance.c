@@ -1,3 +1,4 @@
+#include <errno.h>
 #include <limits.h>
 #include <signal.h>
 #include <stddef.h>
@@ -11,19 +12,37 @@
 #include "arm_pmu.h"
 #endif
 
+#include "bench_stats.h"
+#include "bfs.h"
 #include "bump_ptr_allocator.h"
-#include "mmio.h"
+#include "compressed_graph.h"
+#include "dynamic_graph.h"
+#include "external_graph.h"
+#include "graph.h"
+#include "graph_cache.h"
+#include "graph_order.h"
+#include "mm_fast.h"
+#include "msbfs.h"
+#include "pll_index.h"
+#include "query_executor.h"
+#include "query_server.h"
 #include "queue.h"
+#include "scc.h"
 
-// A hacky adjacency matrix. 
+// The Wikipedia link graph in CSR form, and its transpose when the
+// search mode needs in-neighbors. Both may be relabeled by a vertex
+// ordering, queries and paths use the IDs of the matrix. External
+// search modes read the rows of graph from its cache file instead,
+// and the dynamic mode searches an updatable copy of them.
 //
-struct row {
-    size_t size;
-    unsigned int * adjacent_nodes;
-    bool visited;
-};
+struct graph * graph         = NULL;
+struct graph * reverse_graph = NULL;
+struct compressed_graph * compressed_graph = NULL;
+struct external_graph * external_graph     = NULL;
+struct dynamic_graph * dynamic_graph       = NULL;
 
-struct row ** rows = NULL; 
+#define MATRIX_PATH      "wikipedia-20070206/wikipedia-20070206.mtx"
+#define GRAPH_CACHE_PREFIX "wikipedia-20070206/wikipedia-20070206"
 
 // Malloc and free implementations and microbenchmarking.
 //
@@ -39,6 +58,19 @@ struct timespec total_time;
 
 #define TIMEOUT_SECONDS 120
 
+// Number of queries in the node list.
+//
+#define NUM_QUERIES 100
+
+// Untimed passes over the node list before the timed ones of -r,
+// unless -w says otherwise.
+//
+#define DEFAULT_WARMUP_PASSES 1
+
+// GRAIL labels per condensation vertex unless -g says otherwise.
+//
+#define DEFAULT_GRAIL_LABELS 5
+
 void gracefully_exit_on_slow_search(int signal_number) {
     // Use write() to tell the tester that their implementation is
     // too slow. Searches should not take longer than one minute.
@@ -94,7 +126,8 @@ void instrumented_free(void * addr) {
 void sum_timespec(struct timespec *destination,
                   struct timespec additional_time) {
     destination->tv_nsec += additional_time.tv_nsec;
-    if (destination->tv_nsec > 1000000000L) {
+    if (destination->tv_nsec >= 1000000000L) {
+        destination->tv_nsec -= 1000000000L;
         ++destination->tv_sec;
     }
 
@@ -106,64 +139,25 @@ long compute_timespec_diff(struct timespec start,
     long nanoseconds;
     nanoseconds = (stop.tv_sec - start.tv_sec) * 1000000000L;
 
-    if (start.tv_nsec > stop.tv_nsec) {
-        nanoseconds -= 1000000000L;
-	nanoseconds += (start.tv_nsec - stop.tv_nsec);
-    } else {
-        nanoseconds += (stop.tv_nsec - start.tv_nsec);
-    }
+    // tv_nsec is signed, so a negative difference borrows from the
+    // seconds on its own.
+    //
+    nanoseconds += stop.tv_nsec - start.tv_nsec;
 
     return nanoseconds;
 }
 
-bool breadth_first_search(unsigned int i, unsigned int j) {
-    struct queue * queue = queue_create();
-
-    bool found_path = false;
-    unsigned int next_node = i;
-    size_t node_count = 0;
+// The search state is owned by the caller and reused across searches,
+// so that neither its allocation nor its teardown is timed.
+//
+bool breadth_first_search(struct bfs_search * search, enum bfs_mode mode,
+                          unsigned int i, unsigned int j) {
     struct timespec start, stop;
     alarm(TIMEOUT_SECONDS);
+    unsigned int source = graph_vertex_id(search->graph, i);
+    unsigned int target = graph_vertex_id(search->graph, j);
     GRAB_CLOCK(start)
-    while(!found_path) {
-        // Push data onto the queue.
-	//
-        struct row * row = rows[next_node];
-
-	if (row == NULL || row->visited) {
-            bool not_done = queue_pop(queue, &next_node);
-	    ++node_count;
-	    if (!not_done) break;
-	    continue;
-	} else {
-            row->visited = true;
-	}
-
-	if (row != NULL) {
-	    for(size_t node = 0; node < row->size; node++) {
-                unsigned int data = row->adjacent_nodes[node];
-	        // Check if we found the node.
-	        //
-	        if (j == data) {
-                    found_path = true;
-	        }
-                bool sanity = queue_push(queue, row->adjacent_nodes[node]);
-		if (!sanity) {
-                    printf("Error pushing into queue.\n");
-		    return 1;
-		}
-	    }
-	}
-
-	// Pop the next row off the queue.
-	//
-	bool full = queue_pop(queue, &next_node);
-	if (!full) {
-            break;
-	}
-	++node_count;
-    }
-    queue_delete(queue);
+    bool found_path = bfs_search_run(search, mode, source, target);
     GRAB_CLOCK(stop)
     // Turn off the timeout.
     //
@@ -173,7 +167,8 @@ bool breadth_first_search(unsigned int i, unsigned int j) {
     time_for_sum.tv_nsec = nanoseconds % 1000000000ULL;
     time_for_sum.tv_sec  = nanoseconds / 1000000000ULL;
     sum_timespec(&total_time, time_for_sum);
-    printf("Nodes visited: %ld\n", node_count);
+    printf("Nodes visited: %ld\n", search->nodes_visited);
+    printf("Edges examined: %ld\n", search->edges_examined);
     printf("Time elapsed [s]: %0.3f\n", (float)nanoseconds / 1000000000.0f);
     printf("malloc calls : %ld free calls: %ld\n", malloc_invocations, free_invocations);
     printf("Estimated percentage of time spent in malloc() %0.3f\n", 100.0f * (float)(malloc_invocations * average_malloc_time) / (float)nanoseconds);
@@ -181,50 +176,1194 @@ bool breadth_first_search(unsigned int i, unsigned int j) {
     return found_path;
 }
 
-void add_edge(unsigned int i, unsigned int j) {
-    // Check whether row i exists, if not allocate.
+// Prints a path as its hop count followed by its vertices.
+// \param graph       : Graph the path was found in.
+// \param path        : Vertices from source to target.
+// \param path_length : Number of vertices in path.
+//
+void print_path(struct graph * graph, const unsigned int * path, size_t path_length) {
+    printf("Path (%zu hops):", path_length - 1);
+    for (size_t i = 0; i < path_length; i++) {
+        printf(i == 0 ? " %u" : " -> %u", graph_original_id(graph, path[i]));
+    }
+    printf("\n");
+}
+
+// Parses a Matrix Market file into a CSR graph.
+// \param path        : Path of the .mtx file.
+// \param num_threads : Number of threads to parse and build with.
+// Returns a new graph on success, NULL on failure.
+//
+struct graph * load_graph_from_matrix(const char * path, size_t num_threads) {
+    // A pair (i, j) means that node i links to node j.
     //
-    if (rows[i] == NULL) {
-        rows[i] = (struct row*)malloc(sizeof(struct row));
+    int m, n, nz;
+    unsigned int * sources = NULL;
+    unsigned int * targets = NULL;
+    struct timespec parse_start, parse_stop;
+    GRAB_CLOCK(parse_start)
+    int retval = mm_read_crd_pattern_fast(path, &m, &n, &nz, &sources, &targets, num_threads);
+    GRAB_CLOCK(parse_stop)
+    if (retval != 0) {
+        printf("Error reading matrix %s, Matrix Market error code %d.\n", path, retval);
+	printf("Did you run 'make download_and_decompress_test_data'?\n");
+        return NULL;
+    }
 
-        if (rows[i] == NULL) {
-            printf("Failed to allocate edge, exiting.\n");
-	    exit(1);
-	}
+    if (m != n) {
+        printf("Matrix row and column size not equal. m: %d n: %d\n",
+               m, n);
+        return NULL;
+    }
 
-	rows[i]->size              = 1;
-	rows[i]->adjacent_nodes    = malloc(16 * sizeof(unsigned int));
-	rows[i]->visited           = false;
-	if (rows[i]->adjacent_nodes == NULL) {
-            printf("Unable to malloc adjacent_nodes.\n");
-	    exit(1);
-	}
-	rows[i]->adjacent_nodes[0] = j;
+    struct graph_fingerprint fingerprint;
+    graph_fingerprint_file(path, &fingerprint);
+    float parse_seconds = (float)compute_timespec_diff(parse_start, parse_stop) / 1000000000.0f;
+    printf("Wikipedia matrix size m: %d n: %d nz: %d\n", m, n, nz);
+    printf("Parsed %ld bytes in [s]: %0.3f (%0.1f MB/s)\n",
+           (long)fingerprint.size, parse_seconds,
+           (float)fingerprint.size / parse_seconds / 1000000.0f);
+
+    // Vertex IDs are 1-based, so the graph has m + 1 vertices and
+    // vertex 0 is unused.
+    //
+    struct timespec build_start, build_stop;
+    GRAB_CLOCK(build_start)
+    struct graph * graph = graph_create_from_edges((size_t)m + 1, sources, targets,
+                                                   (size_t)nz, num_threads);
+    GRAB_CLOCK(build_stop)
+    free(sources);
+    free(targets);
+    if (graph == NULL) {
+        printf("Failed to build CSR graph.\n");
+	return NULL;
+    }
+    printf("Built CSR graph using %ld bytes in [s]: %0.3f\n", graph_memory_bytes(graph),
+           (float)compute_timespec_diff(build_start, build_stop) / 1000000000.0f);
+
+    return graph;
+}
+
+// How graphs are loaded: from the binary caches, or from the matrix.
+//
+struct load_options {
+    bool use_graph_cache;
+    bool verify_graph_cache;
+    struct graph_fingerprint fingerprint;   // Of the matrix file.
+    size_t num_threads;
+};
+
+// Builds the path of a graph cache. Every vertex ordering and its
+// transpose are cached in a file of their own.
+// \param path    : Buffer for the path (provided by caller).
+// \param size    : Size of path in bytes.
+// \param order   : Vertex ordering of the graph.
+// \param reverse : Whether the graph is the transpose.
+//
+void graph_cache_path(char * path, size_t size, enum graph_order order, bool reverse) {
+    bool original = order == GRAPH_ORDER_ORIGINAL;
+    snprintf(path, size, "%s%s%s%s.csr", GRAPH_CACHE_PREFIX, original ? "" : ".",
+             original ? "" : graph_order_name(order), reverse ? ".rev" : "");
+}
+
+// Loads the graph in a vertex ordering, from its cache when it is up
+// to date with the matrix file. Otherwise the graph is parsed or
+// relabeled from the original ordering, and its cache is written for
+// the next run.
+// \param options : How to load.
+// \param order   : Vertex ordering.
+// Returns a new graph on success, NULL on failure.
+//
+struct graph * load_graph(const struct load_options * options, enum graph_order order) {
+    char path[4096];
+    graph_cache_path(path, sizeof(path), order, false);
+    if (options->use_graph_cache) {
+        struct graph * cached = graph_cache_map(path, &options->fingerprint,
+                                                options->verify_graph_cache);
+        if (cached != NULL) {
+            printf("Mapped graph cache %s.\n", path);
+            return cached;
+        }
+    }
+
+    struct graph * loaded = NULL;
+    if (order == GRAPH_ORDER_ORIGINAL) {
+        loaded = load_graph_from_matrix(MATRIX_PATH, options->num_threads);
     } else {
-        // Check whether to perform realloc.
-	// Every 16 nodes we allocate another 16.
-	//
-	size_t size = rows[i]->size;
-	if (size % 16 == 15) {
-             rows[i]->adjacent_nodes = realloc(rows[i]->adjacent_nodes, (size + 1 + 16) * sizeof(unsigned int));
-
-	     if (rows[i] == NULL) {
-                 printf("Failed to realloc adjacent nodes.\n");
-		 exit(1);
-	     }
-	}
+        struct graph * original = load_graph(options, GRAPH_ORDER_ORIGINAL);
+        if (original == NULL) {
+            return NULL;
+        }
+
+        struct timespec order_start, order_stop;
+        GRAB_CLOCK(order_start)
+        unsigned int * permutation = graph_order_compute(original, order, options->num_threads);
+        if (permutation != NULL) {
+            loaded = graph_create_permuted(original, permutation, options->num_threads);
+        }
+        GRAB_CLOCK(order_stop)
+        free(permutation);
+        graph_delete(original);
+        if (loaded == NULL) {
+            printf("Failed to compute the %s vertex ordering.\n", graph_order_name(order));
+            return NULL;
+        }
+        printf("Relabeled graph in %s order in [s]: %0.3f\n", graph_order_name(order),
+               (float)compute_timespec_diff(order_start, order_stop) / 1000000000.0f);
+    }
+
+    if (loaded != NULL && options->use_graph_cache) {
+        if (graph_cache_write(path, loaded, &options->fingerprint)) {
+            printf("Wrote graph cache %s.\n", path);
+        } else {
+            printf("Failed to write graph cache %s, continuing.\n", path);
+        }
+    }
+    return loaded;
+}
+
+// Loads the transpose of a graph, from its cache when it is up to date
+// with the matrix file.
+// \param options : How to load.
+// \param order   : Vertex ordering of graph.
+// \param graph   : Graph to transpose.
+// Returns a new graph on success, NULL on failure.
+//
+struct graph * load_reverse_graph(const struct load_options * options, enum graph_order order,
+                                  struct graph * graph)
+{
+    char path[4096];
+    graph_cache_path(path, sizeof(path), order, true);
+    if (options->use_graph_cache) {
+        struct graph * cached = graph_cache_map(path, &options->fingerprint,
+                                                options->verify_graph_cache);
+        if (cached != NULL) {
+            return cached;
+        }
+    }
+
+    struct graph * transpose = graph_create_transpose(graph, options->num_threads);
+    if (transpose == NULL) {
+        printf("Failed to build the transposed graph.\n");
+        return NULL;
+    }
+    if (options->use_graph_cache && !graph_cache_write(path, transpose, &options->fingerprint)) {
+        printf("Failed to write graph cache %s, continuing.\n", path);
+    }
+    return transpose;
+}
+
+// Compresses the rows of a graph and prints how much smaller they are.
+// \param graph : Graph to compress.
+// Returns a new compressed graph on success, NULL on failure.
+//
+struct compressed_graph * load_compressed_graph(struct graph * graph) {
+    struct timespec start, stop;
+    GRAB_CLOCK(start)
+    struct compressed_graph * compressed = compressed_graph_create(graph);
+    GRAB_CLOCK(stop)
+    if (compressed == NULL) {
+        printf("Failed to compress the graph. Compressed rows are limited to %zu bytes,\n"
+               "rebuild with -DGRAPH_64BIT_OFFSETS for more.\n", (size_t)GRAPH_MAX_EDGES);
+        return NULL;
+    }
+
+    size_t raw_bytes = graph_memory_bytes(graph);
+    printf("Compressed rows to %zu bytes (%0.2f bytes/edge, %0.2fx smaller) in [s]: %0.3f\n",
+           compressed_graph_memory_bytes(compressed),
+           (float)compressed->data_bytes / (float)compressed->num_edges,
+           (float)raw_bytes / (float)compressed_graph_memory_bytes(compressed),
+           (float)compute_timespec_diff(start, stop) / 1000000000.0f);
+    return compressed;
+}
+
+// Copies a graph into an updatable one and prints its size.
+// \param graph : Graph to copy.
+// Returns a new dynamic graph on success, NULL on failure.
+//
+struct dynamic_graph * load_dynamic_graph(struct graph * graph) {
+    struct timespec start, stop;
+    GRAB_CLOCK(start)
+    struct dynamic_graph * dynamic = dynamic_graph_create(graph);
+    GRAB_CLOCK(stop)
+    if (dynamic == NULL) {
+        printf("Failed to copy the graph into a dynamic graph.\n");
+        return NULL;
+    }
+
+    printf("Dynamic graph with %zu slots for %zu edges (%zu bytes, %0.2fx the CSR) built in [s]: %0.3f\n",
+           dynamic->num_slots, dynamic->num_edges, dynamic_graph_memory_bytes(dynamic),
+           (float)dynamic_graph_memory_bytes(dynamic) / (float)graph_memory_bytes(graph),
+           (float)compute_timespec_diff(start, stop) / 1000000000.0f);
+    return dynamic;
+}
+
+// Deletes random edges of a dynamic graph and inserts them again, so
+// that the queries still see the input graph, and prints the update
+// rates.
+// \param dynamic     : Dynamic graph to update.
+// \param num_updates : Number of edges to delete and insert.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool run_edge_updates(struct dynamic_graph * dynamic, size_t num_updates) {
+    unsigned int * sources = (unsigned int*)malloc((num_updates + 1) * sizeof(unsigned int));
+    unsigned int * targets = (unsigned int*)malloc((num_updates + 1) * sizeof(unsigned int));
+    if (sources == NULL || targets == NULL || dynamic->num_edges == 0) {
+        printf("Failed to allocate edge updates.\n");
+        free(sources);
+        free(targets);
+        return false;
+    }
+
+    // Pick edges uniformly by picking random slots until one holds a
+    // neighbor. The same edge may come up twice, its second deletion
+    // fails and is not counted.
+    //
+    uint64_t random = 0x9e3779b97f4a7c15ULL;
+    size_t num_picked = 0;
+    while (num_picked < num_updates) {
+        random ^= random >> 12;
+        random ^= random << 25;
+        random ^= random >> 27;
+        size_t slot = (size_t)((random * 0x2545f4914f6cdd1dULL) % dynamic->num_slots);
+
+        size_t low  = 0;
+        size_t high = dynamic->num_vertices;
+        while (high - low > 1) {
+            size_t middle = low + (high - low) / 2;
+            if (dynamic->rows[middle].start <= slot) {
+                low = middle;
+            } else {
+                high = middle;
+            }
+        }
+        if (slot < (size_t)dynamic->rows[low].start + dynamic->rows[low].degree) {
+            sources[num_picked]   = (unsigned int)low;
+            targets[num_picked++] = dynamic->slots[slot];
+        }
+    }
+
+    struct timespec start, stop;
+    size_t deleted = 0;
+    GRAB_CLOCK(start)
+    for (size_t u = 0; u < num_updates; u++) {
+        if (dynamic_graph_delete_edge(dynamic, sources[u], targets[u])) {
+            sources[deleted]   = sources[u];
+            targets[deleted++] = targets[u];
+        }
+    }
+    GRAB_CLOCK(stop)
+    long delete_nanoseconds = compute_timespec_diff(start, stop);
+
+    size_t windows_respread = dynamic->windows_respread;
+    size_t slots_moved      = dynamic->slots_moved;
+    size_t reallocations    = dynamic->reallocations;
+    size_t inserted = 0;
+    GRAB_CLOCK(start)
+    for (size_t u = 0; u < deleted; u++) {
+        inserted += dynamic_graph_insert_edge(dynamic, sources[u], targets[u]);
+    }
+    GRAB_CLOCK(stop)
+    long insert_nanoseconds = compute_timespec_diff(start, stop);
+    free(sources);
+    free(targets);
+
+    printf("Deleted %zu edges in [s]: %0.3f (%0.0f ns/edge)\n", deleted,
+           (float)delete_nanoseconds / 1000000000.0f,
+           (float)delete_nanoseconds / (float)(deleted > 0 ? deleted : 1));
+    printf("Inserted %zu edges in [s]: %0.3f (%0.0f ns/edge)\n", inserted,
+           (float)insert_nanoseconds / 1000000000.0f,
+           (float)insert_nanoseconds / (float)(inserted > 0 ? inserted : 1));
+    printf("Insertions respread %zu windows, moved %zu edges and reallocated %zu times.\n",
+           dynamic->windows_respread - windows_respread, dynamic->slots_moved - slots_moved,
+           dynamic->reallocations - reallocations);
+    if (inserted != deleted) {
+        printf("Failed to insert every deleted edge again.\n");
+        return false;
+    }
+    return true;
+}
+
+// Opens the cache file of a graph for searches that keep its rows on
+// disk. load_graph() has written the cache if it was missing.
+// \param options : How to load.
+// \param order   : Vertex ordering of the graph.
+// Returns a new external graph on success, NULL on failure.
+//
+struct external_graph * load_external_graph(const struct load_options * options,
+                                            enum graph_order order)
+{
+    if (!options->use_graph_cache) {
+        printf("External search modes read the graph cache, drop -C.\n");
+        return NULL;
+    }
+
+    char path[4096];
+    graph_cache_path(path, sizeof(path), order, false);
+    struct external_graph * external = external_graph_open(path);
+    if (external == NULL) {
+        printf("Failed to open graph cache %s for external searches.\n", path);
+        return NULL;
+    }
+    printf("Opened graph cache %s with %zu bytes of offsets in memory and %zu bytes of rows on disk.\n",
+           path, (external->num_vertices + 1) * sizeof(graph_offset_t),
+           external->num_edges * sizeof(unsigned int));
+    return external;
+}
+
+// Prints how much of an external graph the searches read.
+// \param external : External graph, or NULL to print nothing.
+//
+void print_external_io(struct external_graph * external) {
+    if (external == NULL) {
+        return;
+    }
+    printf("External row reads: %zu, bytes read: %zu (%0.2fx the rows on disk)\n",
+           external->reads, external->bytes_read,
+           (float)external->bytes_read / (float)(external->num_edges * sizeof(unsigned int)));
+}
+
+// Reads (source, target) pairs from the node list.
+// \param node_fptr   : Open node list, read from its current position.
+// \param queries     : Array of queries to fill in.
+// \param max_queries : Capacity of queries.
+// Returns the number of queries read.
+//
+size_t read_queries(FILE * node_fptr, struct query * queries, size_t max_queries) {
+    size_t num_queries = 0;
+    while (num_queries < max_queries
+           && fscanf(node_fptr, "%u %u\n", &queries[num_queries].source,
+                     &queries[num_queries].target) == 2) {
+        ++num_queries;
+    }
+    return num_queries;
+}
+
+// Times the node list with BFS_PARALLEL searches on 1, 2, 4, ...
+// threads up to max_threads, then on max_threads itself, and prints
+// the speedup over one thread. One search is created for all of them,
+// with max_threads started, and searches with fewer leave the rest
+// parked.
+// \param node_fptr   : Open node list, read from its current position.
+// \param max_threads : Largest thread count to time.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool run_scaling_curve(FILE * node_fptr, size_t max_threads) {
+    struct query queries[NUM_QUERIES];
+    size_t num_queries = read_queries(node_fptr, queries, NUM_QUERIES);
+
+    struct bfs_search * search = bfs_search_create(graph, NULL, NULL, NULL, NULL, max_threads);
+    if (search == NULL) {
+        printf("Failed to allocate search state.\n");
+        return false;
+    }
+    if (search->num_threads < max_threads) {
+        printf("Started %zu of %zu threads.\n", search->num_threads, max_threads);
+        max_threads = search->num_threads;
+    }
+
+    printf("Parallel search scaling over %zu queries:\n", num_queries);
+    long single_thread_nanoseconds = 0;
+    size_t threads = 1;
+    while (threads <= max_threads) {
+        if (!bfs_search_set_threads(search, threads)) {
+            printf("Failed to resize the search to %zu threads.\n", threads);
+            bfs_search_delete(search);
+            return false;
+        }
+
+        size_t paths_found = 0;
+        struct timespec start, stop;
+        GRAB_CLOCK(start)
+        for (size_t q = 0; q < num_queries; q++) {
+            paths_found += bfs_search_run(search, BFS_PARALLEL,
+                                          graph_vertex_id(graph, queries[q].source),
+                                          graph_vertex_id(graph, queries[q].target));
+        }
+        GRAB_CLOCK(stop)
+        long nanoseconds = compute_timespec_diff(start, stop);
+        if (threads == 1) {
+            single_thread_nanoseconds = nanoseconds;
+        }
+        printf("Threads: %3zu Paths found: %zu Time [s]: %0.3f Speedup: %0.2fx\n",
+               threads, paths_found, (float)nanoseconds / 1000000000.0f,
+               (float)single_thread_nanoseconds / (float)nanoseconds);
+
+        // Finish on max_threads itself unless it is a power of two.
+        //
+        if (threads == max_threads) {
+            break;
+        }
+        threads = threads * 2 <= max_threads ? threads * 2 : max_threads;
+    }
+
+    bfs_search_delete(search);
+    return true;
+}
+
+// Runs the node list as one batch on a pool of query workers, then
+// prints every query's result and the batch throughput.
+// \param node_fptr   : Open node list, read from its current position.
+// \param mode        : Search strategy.
+// \param num_workers : Number of query workers.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool run_concurrent_queries(FILE * node_fptr, enum bfs_mode mode, size_t num_workers) {
+    struct query queries[NUM_QUERIES];
+    size_t num_queries = read_queries(node_fptr, queries, NUM_QUERIES);
+
+    struct query_executor * executor = query_executor_create(graph, reverse_graph, compressed_graph,
+                                                             external_graph, dynamic_graph, mode,
+                                                             num_workers);
+    if (executor == NULL) {
+        printf("Failed to allocate query workers.\n");
+        return false;
+    }
+
+    struct timespec start, stop;
+    GRAB_CLOCK(start)
+    bool status = query_executor_run(executor, queries, num_queries);
+    GRAB_CLOCK(stop)
+    query_executor_delete(executor);
+    if (!status) {
+        printf("Failed to run queries.\n");
+        return false;
+    }
+
+    long search_nanoseconds = 0;
+    for (size_t q = 0; q < num_queries; q++) {
+        printf("(%ld / %ld) Searching for a connection between node %d -> %d\n",
+               q + 1, (long)num_queries, queries[q].source, queries[q].target);
+        printf("Nodes visited: %ld\n", queries[q].nodes_visited);
+        printf("Edges examined: %ld\n", queries[q].edges_examined);
+        printf("Time elapsed [s]: %0.3f\n", (float)queries[q].nanoseconds / 1000000000.0f);
+        printf("CPU time [s]: %0.3f\n", (float)queries[q].cpu_nanoseconds / 1000000000.0f);
+        if (queries[q].found) {
+            printf("Path found.\n");
+        } else {
+            printf("No path found.\n");
+        }
+        search_nanoseconds += queries[q].cpu_nanoseconds;
+    }
+
+    long batch_nanoseconds = compute_timespec_diff(start, stop);
+    printf("All work complete, exit.\n");
+    printf("Ran %zu queries on %zu workers in [s]: %0.3f (%0.1f queries/s)\n",
+           num_queries, num_workers, (float)batch_nanoseconds / 1000000000.0f,
+           (float)num_queries * 1000000000.0f / (float)batch_nanoseconds);
+    printf("Sum of per-query CPU times [s]: %0.3f\n", (float)search_nanoseconds / 1000000000.0f);
+    return true;
+}
+
+// Serves queries against the loaded graphs until standard input ends,
+// or until the socket fails.
+// \param path        : Path of the Unix domain socket, "-" to read
+//                      requests from standard input.
+// \param reply_fd    : Descriptor for replies to standard input.
+// \param mode        : Search strategy.
+// \param num_workers : Number of query workers.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool run_query_server(const char * path, int reply_fd, enum bfs_mode mode, size_t num_workers) {
+    struct query_executor * executor = query_executor_create(graph, reverse_graph, compressed_graph,
+                                                             external_graph, dynamic_graph, mode,
+                                                             num_workers);
+    struct query_server * server = query_server_create(executor);
+    if (server == NULL) {
+        printf("Failed to allocate the query server.\n");
+        query_executor_delete(executor);
+        return false;
+    }
+
+    bool use_stdin = strcmp(path, "-") == 0;
+    printf("Serving %s queries on %s with %zu workers.\n", bfs_mode_name(mode),
+           use_stdin ? "standard input" : path, num_workers);
+    fflush(stdout);
+    bool status = use_stdin ? query_server_serve(server, STDIN_FILENO, reply_fd)
+                            : query_server_listen(server, path);
+    if (!status) {
+        printf("Query server failed: %s\n", strerror(errno));
+    }
+    printf("Answered %zu queries (%zu malformed) in %zu batches over %zu connections.\n",
+           server->queries, server->malformed, server->batches, server->connections);
+
+    query_server_delete(server);
+    query_executor_delete(executor);
+    return status;
+}
+
+// Writes the results of run_benchmark() to a file, as JSON or CSV by
+// the file's suffix.
+// \param path        : Path of the file, ending in .json or .csv.
+// \param mode        : Search strategy.
+// \param order       : Vertex ordering of the graph.
+// \param warmup      : Untimed passes.
+// \param queries     : Array of queries, their found fields set.
+// \param stats       : Array of per-query statistics.
+// \param num_queries : Number of queries.
+// \param total       : Statistics of the timed passes.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool write_benchmark(const char * path, enum bfs_mode mode, enum graph_order order, size_t warmup,
+                     const struct query * queries, const struct bench_stats * stats,
+                     size_t num_queries, const struct bench_stats * total)
+{
+    size_t length = strlen(path);
+    bool json = length >= 5 && strcmp(path + length - 5, ".json") == 0;
+    bool csv  = length >= 4 && strcmp(path + length - 4, ".csv") == 0;
+    FILE * file = json || csv ? fopen(path, "w") : NULL;
+    if (file == NULL) {
+        printf("Error writing benchmark results to %s, which must end in .json or .csv.\n", path);
+        return false;
+    }
 
-	rows[i]->adjacent_nodes[size] = j;
-	++rows[i]->size;
+    if (json) {
+        fprintf(file, "{\n  \"mode\": \"%s\",\n  \"ordering\": \"%s\",\n", bfs_mode_name(mode),
+                graph_order_name(order));
+        fprintf(file, "  \"vertices\": %zu,\n  \"edges\": %zu,\n", graph->num_vertices, graph->num_edges);
+        fprintf(file, "  \"warmup\": %zu,\n  \"repetitions\": %zu,\n  \"unit\": \"ns\",\n",
+                warmup, total->count);
+        fprintf(file, "  \"total\": ");
+        bench_stats_write_json(file, total);
+        fprintf(file, ",\n  \"queries\": [\n");
+        for (size_t q = 0; q < num_queries; q++) {
+            fprintf(file, "    {\"source\": %u, \"target\": %u, \"found\": %s, \"stats\": ",
+                    queries[q].source, queries[q].target, queries[q].found ? "true" : "false");
+            bench_stats_write_json(file, &stats[q]);
+            fprintf(file, "}%s\n", q + 1 < num_queries ? "," : "");
+        }
+        fprintf(file, "  ]\n}\n");
+    } else {
+        // One row per query, then the totals, all in nanoseconds.
+        //
+        fprintf(file, "mode,ordering,warmup,query,source,target,found,");
+        bench_stats_write_csv_header(file);
+        fprintf(file, "\n");
+        for (size_t q = 0; q < num_queries; q++) {
+            fprintf(file, "%s,%s,%zu,%zu,%u,%u,%d,", bfs_mode_name(mode), graph_order_name(order),
+                    warmup, q + 1, queries[q].source, queries[q].target, queries[q].found ? 1 : 0);
+            bench_stats_write_csv(file, &stats[q]);
+            fprintf(file, "\n");
+        }
+        fprintf(file, "%s,%s,%zu,total,,,,", bfs_mode_name(mode), graph_order_name(order), warmup);
+        bench_stats_write_csv(file, total);
+        fprintf(file, "\n");
+    }
+
+    bool status = fclose(file) == 0;
+    if (status) {
+        printf("Wrote benchmark results to %s\n", path);
+    }
+    return status;
+}
+
+// Times every query of the node list over repeated passes, after
+// untimed warmup passes, and prints the distribution of each query's
+// search time and of the time per pass. Passes run the whole list in
+// order, so the per-pass totals see the same cache state a normal run
+// does.
+// \param node_fptr   : Open node list, read from its current position.
+// \param mode        : Search strategy.
+// \param order       : Vertex ordering of the graph.
+// \param num_threads : Threads for BFS_PARALLEL searches.
+// \param warmup      : Untimed passes.
+// \param repetitions : Timed passes.
+// \param output_path : File for the results, or NULL.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool run_benchmark(FILE * node_fptr, enum bfs_mode mode, enum graph_order order, size_t num_threads,
+                   size_t warmup, size_t repetitions, const char * output_path)
+{
+    struct query queries[NUM_QUERIES];
+    struct bench_stats stats[NUM_QUERIES];
+    size_t num_queries = read_queries(node_fptr, queries, NUM_QUERIES);
+
+    struct bfs_search * search = bfs_search_create(graph, reverse_graph, compressed_graph, external_graph,
+                                                   dynamic_graph, mode == BFS_PARALLEL ? num_threads : 0);
+    long * samples = (long*)malloc((num_queries * repetitions + 1) * sizeof(long));
+    long * passes  = (long*)malloc((repetitions + 1) * sizeof(long));
+    if (search == NULL || samples == NULL || passes == NULL || num_queries == 0) {
+        printf("Failed to set up the benchmark.\n");
+        bfs_search_delete(search);
+        free(samples);
+        free(passes);
+        return false;
+    }
+
+    // samples[q * repetitions + r] is query q in pass r.
+    //
+    for (size_t pass = 0; pass < warmup + repetitions; pass++) {
+        long pass_nanoseconds = 0;
+        for (size_t q = 0; q < num_queries; q++) {
+            struct timespec start, stop;
+            GRAB_CLOCK(start)
+            queries[q].found = bfs_search_run(search, mode, graph_vertex_id(graph, queries[q].source),
+                                              graph_vertex_id(graph, queries[q].target));
+            GRAB_CLOCK(stop)
+            long nanoseconds  = compute_timespec_diff(start, stop);
+            pass_nanoseconds += nanoseconds;
+            if (pass >= warmup) {
+                samples[q * repetitions + pass - warmup] = nanoseconds;
+            }
+        }
+        if (pass >= warmup) {
+            passes[pass - warmup] = pass_nanoseconds;
+        }
+    }
+    bfs_search_delete(search);
+
+    printf("Search mode: %s\n", bfs_mode_name(mode));
+    printf("Vertex ordering: %s\n", graph_order_name(order));
+    printf("Warmup passes: %zu, timed passes: %zu. Times in [us], CIs are 95%%.\n", warmup, repetitions);
+    printf("%5s %9s %9s %5s %10s %10s %10s %10s %10s %10s %23s\n", "Query", "Source", "Target", "Found",
+           "Median", "Mean", "Stddev", "Min", "P90", "P99", "Median CI");
+    for (size_t q = 0; q < num_queries; q++) {
+        bench_stats_compute(&samples[q * repetitions], repetitions, &stats[q]);
+        printf("%5zu %9u %9u %5s %10.1f %10.1f %10.1f %10.1f %10.1f %10.1f [%10.1f, %10.1f]\n",
+               q + 1, queries[q].source, queries[q].target, queries[q].found ? "yes" : "no",
+               stats[q].median / 1000.0, stats[q].mean / 1000.0, stats[q].stddev / 1000.0,
+               stats[q].min / 1000.0, stats[q].p90 / 1000.0, stats[q].p99 / 1000.0,
+               stats[q].median_ci_low / 1000.0, stats[q].median_ci_high / 1000.0);
     }
+
+    struct bench_stats total;
+    bench_stats_compute(passes, repetitions, &total);
+    printf("All work complete, exit.\n");
+    printf("Time per pass over %zu queries [ms]: median %0.3f mean %0.3f stddev %0.3f min %0.3f "
+           "p90 %0.3f p99 %0.3f\n", num_queries, total.median / 1000000.0, total.mean / 1000000.0,
+           total.stddev / 1000000.0, total.min / 1000000.0, total.p90 / 1000000.0, total.p99 / 1000000.0);
+    printf("95%% CI of the median [ms]: [%0.3f, %0.3f], of the mean [ms]: [%0.3f, %0.3f] (+-%0.2f%%)\n",
+           total.median_ci_low / 1000000.0, total.median_ci_high / 1000000.0,
+           total.mean_ci_low / 1000000.0, total.mean_ci_high / 1000000.0,
+           100.0 * (total.mean_ci_high - total.mean) / total.mean);
+
+    bool status = output_path == NULL
+        || write_benchmark(output_path, mode, order, warmup, queries, stats, num_queries, &total);
+    free(samples);
+    free(passes);
+    return status;
 }
 
-int main(void) {
+// Answers the node list with bit-parallel multi-source BFS, up to
+// MSBFS_WIDTH queries per traversal, then prints every answer and the
+// edges read per batch.
+// \param node_fptr : Open node list, read from its current position.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool run_multi_source_queries(FILE * node_fptr) {
+    struct query queries[NUM_QUERIES];
+    size_t num_queries = read_queries(node_fptr, queries, NUM_QUERIES);
+
+    struct msbfs * msbfs = msbfs_create(graph);
+    if (msbfs == NULL) {
+        printf("Failed to allocate multi-source BFS state.\n");
+        return false;
+    }
+
+    long total_nanoseconds = 0;
+    size_t total_edges     = 0;
+    for (size_t first = 0; first < num_queries; first += MSBFS_WIDTH) {
+        size_t batch_size = num_queries - first < MSBFS_WIDTH ? num_queries - first : MSBFS_WIDTH;
+        unsigned int sources[MSBFS_WIDTH];
+        unsigned int targets[MSBFS_WIDTH];
+        bool found[MSBFS_WIDTH];
+        for (size_t k = 0; k < batch_size; k++) {
+            sources[k] = graph_vertex_id(graph, queries[first + k].source);
+            targets[k] = graph_vertex_id(graph, queries[first + k].target);
+        }
+
+        struct timespec start, stop;
+        GRAB_CLOCK(start)
+        bool status = msbfs_run(msbfs, sources, targets, batch_size, found);
+        GRAB_CLOCK(stop)
+        if (!status) {
+            printf("Failed to run multi-source BFS.\n");
+            msbfs_delete(msbfs);
+            return false;
+        }
+
+        long nanoseconds = compute_timespec_diff(start, stop);
+        total_nanoseconds += nanoseconds;
+        total_edges       += msbfs->edges_examined;
+        printf("Batch of %zu queries: %zu levels, %zu edges examined, [s]: %0.3f\n",
+               batch_size, msbfs->levels, msbfs->edges_examined,
+               (float)nanoseconds / 1000000000.0f);
+        for (size_t k = 0; k < batch_size; k++) {
+            queries[first + k].found = found[k];
+        }
+    }
+    msbfs_delete(msbfs);
+
+    for (size_t q = 0; q < num_queries; q++) {
+        printf("(%ld / %ld) Searching for a connection between node %d -> %d\n",
+               q + 1, (long)num_queries, queries[q].source, queries[q].target);
+        if (queries[q].found) {
+            printf("Path found.\n");
+        } else {
+            printf("No path found.\n");
+        }
+    }
+
+    printf("All work complete, exit.\n");
+    printf("Edges examined: %zu\n", total_edges);
+    printf("Performed searches in [s]: %0.3f\n", (float)total_nanoseconds / 1000000000.0f);
+    return true;
+}
+
+// Loads the landmark index of a graph, from its file when it is up to
+// date with the matrix file. Otherwise the labels are built and
+// written next to the graph cache for the next run.
+// \param options       : How to load.
+// \param order         : Vertex ordering of graph.
+// \param num_landmarks : Number of landmarks.
+// Returns a new index on success, NULL on failure.
+//
+struct pll_index * load_pll_index(const struct load_options * options, enum graph_order order,
+                                  size_t num_landmarks)
+{
+    bool original = order == GRAPH_ORDER_ORIGINAL;
+    char path[4096];
+    snprintf(path, sizeof(path), "%s%s%s.L%zu.pll", GRAPH_CACHE_PREFIX, original ? "" : ".",
+             original ? "" : graph_order_name(order), num_landmarks);
+    if (options->use_graph_cache) {
+        struct pll_index * mapped = pll_index_map(path, &options->fingerprint, num_landmarks);
+        if (mapped != NULL) {
+            printf("Mapped landmark index %s.\n", path);
+            return mapped;
+        }
+    }
+
+    struct graph * reverse = load_reverse_graph(options, order, graph);
+    if (reverse == NULL) {
+        return NULL;
+    }
+    struct timespec start, stop;
+    GRAB_CLOCK(start)
+    struct pll_index * index = pll_index_create(graph, reverse, num_landmarks);
+    GRAB_CLOCK(stop)
+    graph_delete(reverse);
+    if (index == NULL) {
+        printf("Failed to build the landmark index.\n");
+        return NULL;
+    }
+    printf("Built labels of %zu landmarks, %zu out and %zu in entries, %zu bytes in [s]: %0.3f\n",
+           num_landmarks, (size_t)index->out_offsets[index->num_vertices],
+           (size_t)index->in_offsets[index->num_vertices], pll_index_memory_bytes(index),
+           (float)compute_timespec_diff(start, stop) / 1000000000.0f);
+
+    if (options->use_graph_cache) {
+        if (pll_index_write(path, index, &options->fingerprint)) {
+            printf("Wrote landmark index %s.\n", path);
+        } else {
+            printf("Failed to write landmark index %s, continuing.\n", path);
+        }
+    }
+    return index;
+}
+
+// Answers the node list from the landmark index, with the distance of
+// every pair.
+// \param node_fptr     : Open node list, read from its current position.
+// \param options       : How to load the index.
+// \param order         : Vertex ordering of graph.
+// \param num_landmarks : Number of landmarks.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool run_landmark_queries(FILE * node_fptr, const struct load_options * options,
+                          enum graph_order order, size_t num_landmarks)
+{
+    struct query queries[NUM_QUERIES];
+    size_t num_queries = read_queries(node_fptr, queries, NUM_QUERIES);
+
+    struct pll_index * index = load_pll_index(options, order, num_landmarks);
+    if (index == NULL) {
+        return false;
+    }
+    struct pll_search * search = pll_search_create(index, graph);
+    if (search == NULL) {
+        printf("Failed to allocate landmark search state.\n");
+        pll_index_delete(index);
+        return false;
+    }
+
+    long total_nanoseconds = 0;
+    size_t fallbacks       = 0;
+    for (size_t q = 0; q < num_queries; q++) {
+        struct timespec start, stop;
+        GRAB_CLOCK(start)
+        uint32_t distance = pll_search_distance(search, graph_vertex_id(graph, queries[q].source),
+                                                graph_vertex_id(graph, queries[q].target));
+        GRAB_CLOCK(stop)
+        long nanoseconds = compute_timespec_diff(start, stop);
+        total_nanoseconds += nanoseconds;
+        fallbacks         += search->used_fallback;
+
+        printf("(%ld / %ld) Searching for a connection between node %d -> %d\n",
+               q + 1, (long)num_queries, queries[q].source, queries[q].target);
+        if (distance != PLL_INFINITY) {
+            printf("Path found, distance: %u\n", distance);
+        } else {
+            printf("No path found.\n");
+        }
+        printf("Fallback nodes visited: %zu\n", search->nodes_visited);
+        printf("Time elapsed [us]: %0.3f\n", (float)nanoseconds / 1000.0f);
+    }
+    pll_search_delete(search);
+    pll_index_delete(index);
+
+    printf("All work complete, exit.\n");
+    printf("Queries that needed a fallback search: %zu\n", fallbacks);
+    printf("Performed searches in [s]: %0.6f\n", (float)total_nanoseconds / 1000000000.0f);
+    return true;
+}
+
+// Answers the node list on the SCC condensation of the graph. Pairs in
+// one component are answered by a lookup, the rest by the GRAIL labels
+// of the condensation DAG or a search of it.
+// \param node_fptr   : Open node list, read from its current position.
+// \param num_threads : Number of threads to build the DAG with.
+// \param num_labels  : Number of GRAIL labels, 0 to search without them.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool run_condensed_queries(FILE * node_fptr, size_t num_threads, size_t num_labels) {
+    struct query queries[NUM_QUERIES];
+    size_t num_queries = read_queries(node_fptr, queries, NUM_QUERIES);
+
+    struct timespec start, stop;
+    GRAB_CLOCK(start)
+    struct scc_graph * scc = scc_graph_create(graph, num_threads);
+    GRAB_CLOCK(stop)
+    if (scc == NULL) {
+        printf("Failed to condense the graph.\n");
+        return false;
+    }
+    printf("Condensed %zu vertices into %zu components with %zu DAG edges in [s]: %0.3f\n",
+           scc->num_vertices, scc->num_components, scc->dag->num_edges,
+           (float)compute_timespec_diff(start, stop) / 1000000000.0f);
+    printf("Largest component: %u vertices (%0.1f%%)\n",
+           scc->component_size[scc->largest_component],
+           100.0f * (float)scc->component_size[scc->largest_component] / (float)scc->num_vertices);
+
+    struct grail_index * grail = NULL;
+    if (num_labels > 0) {
+        GRAB_CLOCK(start)
+        grail = grail_index_create(scc->dag, num_labels, 1);
+        GRAB_CLOCK(stop)
+        if (grail == NULL) {
+            printf("Failed to label the condensation DAG.\n");
+            scc_graph_delete(scc);
+            return false;
+        }
+        printf("Built %zu GRAIL labels using %zu bytes in [s]: %0.3f\n", num_labels,
+               grail_index_memory_bytes(grail),
+               (float)compute_timespec_diff(start, stop) / 1000000000.0f);
+    }
+
+    struct scc_search * search = scc_search_create(scc, grail);
+    if (search == NULL) {
+        printf("Failed to allocate condensation search state.\n");
+        grail_index_delete(grail);
+        scc_graph_delete(scc);
+        return false;
+    }
+
+    long total_nanoseconds = 0;
+    size_t dag_searches    = 0;
+    size_t label_rejects   = 0;
+    for (size_t q = 0; q < num_queries; q++) {
+        GRAB_CLOCK(start)
+        bool found = scc_search_reachable(search, graph_vertex_id(graph, queries[q].source),
+                                          graph_vertex_id(graph, queries[q].target));
+        GRAB_CLOCK(stop)
+        long nanoseconds = compute_timespec_diff(start, stop);
+        total_nanoseconds += nanoseconds;
+        dag_searches      += search->searched_dag;
+        label_rejects     += search->rejected_by_labels;
+
+        printf("(%ld / %ld) Searching for a connection between node %d -> %d\n",
+               q + 1, (long)num_queries, queries[q].source, queries[q].target);
+        printf(found ? "Path found.\n" : "No path found.\n");
+        printf("Components visited: %zu\n", search->components_visited);
+        printf("Time elapsed [us]: %0.3f\n", (float)nanoseconds / 1000.0f);
+    }
+    scc_search_delete(search);
+    grail_index_delete(grail);
+    scc_graph_delete(scc);
+
+    printf("All work complete, exit.\n");
+    printf("Queries rejected by the labels: %zu\n", label_rejects);
+    printf("Queries that searched the DAG: %zu\n", dag_searches);
+    printf("Performed searches in [s]: %0.6f\n", (float)total_nanoseconds / 1000000000.0f);
+    return true;
+}
+
+// Times the node list under every vertex ordering and prints the
+// speedup over the original ordering.
+// \param node_fptr : Open node list, read from its current position.
+// \param mode      : Search strategy.
+// \param options   : How to load the graphs.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool run_ordering_comparison(FILE * node_fptr, enum bfs_mode mode,
+                             const struct load_options * options)
+{
+    struct query queries[NUM_QUERIES];
+    size_t num_queries = read_queries(node_fptr, queries, NUM_QUERIES);
+
+    printf("Search time per vertex ordering over %zu queries, search mode %s:\n",
+           num_queries, bfs_mode_name(mode));
+    long original_nanoseconds = 0;
+    for (enum graph_order order = GRAPH_ORDER_ORIGINAL; graph_order_name(order) != NULL; order++) {
+        struct graph * ordered = load_graph(options, order);
+        struct graph * reverse = NULL;
+        if (ordered != NULL && bfs_mode_needs_reverse(mode)) {
+            reverse = load_reverse_graph(options, order, ordered);
+        }
+        struct compressed_graph * compressed = NULL;
+        if (ordered != NULL && bfs_mode_needs_compressed(mode)) {
+            compressed = load_compressed_graph(ordered);
+        }
+        struct external_graph * external = NULL;
+        if (ordered != NULL && bfs_mode_needs_external(mode)) {
+            external = load_external_graph(options, order);
+        }
+        struct dynamic_graph * dynamic = NULL;
+        if (ordered != NULL && bfs_mode_needs_dynamic(mode)) {
+            dynamic = load_dynamic_graph(ordered);
+        }
+        struct bfs_search * search = NULL;
+        if (ordered != NULL && (reverse != NULL || !bfs_mode_needs_reverse(mode))
+            && (compressed != NULL || !bfs_mode_needs_compressed(mode))
+            && (external != NULL || !bfs_mode_needs_external(mode))
+            && (dynamic != NULL || !bfs_mode_needs_dynamic(mode))) {
+            search = bfs_search_create(ordered, reverse, compressed, external, dynamic,
+                                       mode == BFS_PARALLEL ? options->num_threads : 0);
+        }
+        if (search == NULL) {
+            printf("Failed to load the graph in %s order.\n", graph_order_name(order));
+            dynamic_graph_delete(dynamic);
+            external_graph_close(external);
+            compressed_graph_delete(compressed);
+            graph_delete(reverse);
+            graph_delete(ordered);
+            return false;
+        }
+
+        size_t paths_found    = 0;
+        size_t edges_examined = 0;
+        struct timespec start, stop;
+        GRAB_CLOCK(start)
+        for (size_t q = 0; q < num_queries; q++) {
+            paths_found += bfs_search_run(search, mode,
+                                          graph_vertex_id(ordered, queries[q].source),
+                                          graph_vertex_id(ordered, queries[q].target));
+            edges_examined += search->edges_examined;
+        }
+        GRAB_CLOCK(stop)
+        long nanoseconds = compute_timespec_diff(start, stop);
+        if (order == GRAPH_ORDER_ORIGINAL) {
+            original_nanoseconds = nanoseconds;
+        }
+        printf("Ordering: %-8s Paths found: %zu Edges examined: %zu Time [s]: %0.3f Speedup: %0.2fx\n",
+               graph_order_name(order), paths_found, edges_examined,
+               (float)nanoseconds / 1000000000.0f,
+               (float)original_nanoseconds / (float)nanoseconds);
+
+        bfs_search_delete(search);
+        dynamic_graph_delete(dynamic);
+        external_graph_close(external);
+        compressed_graph_delete(compressed);
+        graph_delete(reverse);
+        graph_delete(ordered);
+    }
+
+    return true;
+}
+
+void print_usage(const char * program) {
+    printf("Usage: %s [-C] [-V] [-M] [-R] [-S] [-c] [-g labels] [-j threads]\n"
+           "       [-L landmarks] [-m mode] [-o ordering] [-q workers] [-s socket]\n"
+           "       [-u updates] [-r repetitions] [-w warmup] [-b results]\n",
+           program);
+    printf("  -C  Do not read or write the binary graph cache.\n");
+    printf("  -V  Verify the graph cache checksum when mapping it.\n");
+    printf("  -M  Answer the queries with multi-source BFS, %d per traversal.\n",
+           MSBFS_WIDTH);
+    printf("  -R  Time the queries under every vertex ordering and exit.\n");
+    printf("  -S  Print the scaling curve of parallel searches over thread\n");
+    printf("      counts up to -j and exit.\n");
+    printf("  -c  Answer the queries on the strongly connected component\n");
+    printf("      condensation of the graph.\n");
+    printf("  -g  GRAIL labels of the condensation used by -c, 0 to %d.\n",
+           GRAIL_MAX_LABELS);
+    printf("      Defaults to %d, 0 searches the condensation unlabeled.\n",
+           DEFAULT_GRAIL_LABELS);
+    printf("  -j  Threads used to parse the matrix, build the graph and run\n");
+    printf("      parallel searches. Defaults to the number of online CPUs.\n");
+    printf("  -L  Answer the queries with 2-hop labels of this many highest\n");
+    printf("      degree landmarks. The labels are cached next to the matrix.\n");
+    printf("  -m  Search mode: forward (default), bidirectional,\n");
+    printf("      direction-optimizing, parallel, shortest-path,\n");
+    printf("      compressed, external, external-mmap or dynamic. The\n");
+    printf("      external modes keep the rows in the graph cache on disk,\n");
+    printf("      dynamic searches a copy that edges can be added to.\n");
+    printf("  -o  Vertex ordering: original (default), degree, bfs, rcm or\n");
+    printf("      gorder. The relabeled graph is cached next to the matrix.\n");
+    printf("  -q  Run the queries concurrently on this many workers, each\n");
+    printf("      with its own search state.\n");
+    printf("  -s  Load the graph once, then answer queries on this Unix\n");
+    printf("      domain socket, or on standard input and output for -,\n");
+    printf("      with -q workers. Protocol in query_server.h.\n");
+    printf("  -r  Time every query over this many passes of the node list\n");
+    printf("      and print the median, mean, spread and 95%% confidence\n");
+    printf("      intervals per query and per pass.\n");
+    printf("  -w  Untimed passes before those of -r. Defaults to %d.\n",
+           DEFAULT_WARMUP_PASSES);
+    printf("  -b  Also write the results of -r to this .json or .csv file.\n");
+    printf("  -u  With -m dynamic, delete this many random edges and insert\n");
+    printf("      them again before the queries, and print the update rates.\n");
+}
+
+int main(int argc, char ** argv) {
+    bool use_graph_cache    = true;
+    bool verify_graph_cache = false;
+    bool scaling_curve      = false;
+    bool multi_source       = false;
+    bool condensed          = false;
+    long grail_labels       = DEFAULT_GRAIL_LABELS;
+    bool compare_orderings  = false;
+    long query_workers      = 0;
+    long edge_updates       = 0;
+    const char * serve_path = NULL;
+    long repetitions        = 0;
+    long warmup_passes      = DEFAULT_WARMUP_PASSES;
+    const char * bench_path = NULL;
+    long num_landmarks      = 0;
+    long num_threads        = sysconf(_SC_NPROCESSORS_ONLN);
+    enum bfs_mode mode      = BFS_FORWARD;
+    enum graph_order order  = GRAPH_ORDER_ORIGINAL;
+
+    int option;
+    while ((option = getopt(argc, argv, "CVMRScb:g:j:L:m:o:q:r:s:u:w:")) != -1) {
+        switch (option) {
+        case 'C':
+            use_graph_cache = false;
+            break;
+        case 'V':
+            verify_graph_cache = true;
+            break;
+        case 'M':
+            multi_source = true;
+            break;
+        case 'R':
+            compare_orderings = true;
+            break;
+        case 'S':
+            scaling_curve = true;
+            break;
+        case 'c':
+            condensed = true;
+            break;
+        case 'g':
+            grail_labels = strtol(optarg, NULL, 10);
+            if (grail_labels < 0 || grail_labels > GRAIL_MAX_LABELS) {
+                print_usage(argv[0]);
+                return 1;
+            }
+            break;
+        case 'j':
+            num_threads = strtol(optarg, NULL, 10);
+            if (num_threads < 1) {
+                print_usage(argv[0]);
+                return 1;
+            }
+            break;
+        case 'L':
+            num_landmarks = strtol(optarg, NULL, 10);
+            if (num_landmarks < 1) {
+                print_usage(argv[0]);
+                return 1;
+            }
+            break;
+        case 'q':
+            query_workers = strtol(optarg, NULL, 10);
+            if (query_workers < 1) {
+                print_usage(argv[0]);
+                return 1;
+            }
+            break;
+        case 'b':
+            bench_path = optarg;
+            break;
+        case 'r':
+            repetitions = strtol(optarg, NULL, 10);
+            if (repetitions < 1) {
+                print_usage(argv[0]);
+                return 1;
+            }
+            break;
+        case 's':
+            serve_path = optarg;
+            break;
+        case 'w':
+            warmup_passes = strtol(optarg, NULL, 10);
+            if (warmup_passes < 0) {
+                print_usage(argv[0]);
+                return 1;
+            }
+            break;
+        case 'u':
+            edge_updates = strtol(optarg, NULL, 10);
+            if (edge_updates < 1) {
+                print_usage(argv[0]);
+                return 1;
+            }
+            break;
+        case 'm':
+            if (!bfs_mode_parse(optarg, &mode)) {
+                print_usage(argv[0]);
+                return 1;
+            }
+            break;
+        case 'o':
+            if (!graph_order_parse(optarg, &order)) {
+                print_usage(argv[0]);
+                return 1;
+            }
+            break;
+        default:
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if ((edge_updates > 0 && !bfs_mode_needs_dynamic(mode)) || (bench_path != NULL && repetitions == 0)) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    if (num_threads < 1) {
+        // sysconf() could not count the CPUs.
+        //
+        num_threads = 1;
+    }
+
+    // Replies to standard input own standard output, everything else
+    // goes to standard error.
+    //
+    int reply_fd = STDOUT_FILENO;
+    if (serve_path != NULL && strcmp(serve_path, "-") == 0) {
+        fflush(stdout);
+        reply_fd = dup(STDOUT_FILENO);
+        if (reply_fd < 0 || dup2(STDERR_FILENO, STDOUT_FILENO) < 0) {
+            printf("Error redirecting standard output.\n");
+            return 1;
+        }
+    }
 
     // Initialize malloc() and free().
     //
     queue_register_malloc(&instrumented_malloc);
     queue_register_free(&custom_free);
+    bump_ptr_setup();
 
     // Register signal handler for graceful timeout.
     //
@@ -270,86 +1409,141 @@ int main(void) {
     printf("Average time [ns] per malloc() call: %ld\n", average_malloc_time);
     printf("Average time [ns] per free() call: %ld\n", average_free_time);
 
-    // Parse the file.
+    // A server takes its queries from its clients instead.
     //
-    FILE* fptr      = fopen("wikipedia-20070206/wikipedia-20070206.mtx", "r");
-    FILE* node_fptr = fopen("nodes", "r"); 
+    FILE* node_fptr = NULL;
+    if (serve_path == NULL) {
+        node_fptr = fopen("nodes", "r");
+        if (node_fptr == NULL) {
+            printf("Error opening node list.\n");
+            return 1;
+        }
+    }
 
-    if (fptr == NULL) {
+    // Load the graph, from the binary cache when it is up to date with
+    // the matrix file, otherwise by parsing the matrix and then writing
+    // the cache for the next run.
+    //
+    struct load_options load_options;
+    load_options.use_graph_cache    = use_graph_cache;
+    load_options.verify_graph_cache = verify_graph_cache;
+    load_options.num_threads        = (size_t)num_threads;
+    if (!graph_fingerprint_file(MATRIX_PATH, &load_options.fingerprint)) {
         printf("Error opening matrix.\n");
 	printf("Did you run 'make download_and_decompress_test_data'?\n");
         return 1;
     }
 
-    if (node_fptr == NULL) {
-        printf("Error opening node list.\n");
-	return 1;
+    if (compare_orderings) {
+        bool status = run_ordering_comparison(node_fptr, mode, &load_options);
+        fclose(node_fptr);
+        bump_ptr_cleanup();
+        return status ? 0 : 1;
     }
 
-    MM_typecode matrix_code;
-
-    if (mm_read_banner(fptr, &matrix_code) != 0) {
-        printf("Malformed Matrix Market file.\n");
-	return 1;
+    struct timespec load_start, load_stop;
+    GRAB_CLOCK(load_start)
+    graph = load_graph(&load_options, order);
+    if (graph == NULL) {
+        return 1;
     }
+    GRAB_CLOCK(load_stop)
+    printf("Graph with %ld vertices and %ld edges loaded in [s]: %0.3f\n",
+           graph->num_vertices, graph->num_edges,
+           (float)compute_timespec_diff(load_start, load_stop) / 1000000000.0f);
 
-    // Determine size of MxN matrix with total non-zero size nz.
+    // Some search modes walk in-edges, so they need the transpose,
+    // which is cached next to the graph.
     //
-    int m, n, nz;
-    if (mm_read_mtx_crd_size(fptr, &m, &n, &nz)) {
-        printf("Unable to read size of matrix.\n");
-	return 1;
+    if (bfs_mode_needs_reverse(mode)) {
+        GRAB_CLOCK(load_start)
+        reverse_graph = load_reverse_graph(&load_options, order, graph);
+        if (reverse_graph == NULL) {
+            return 1;
+        }
+        GRAB_CLOCK(load_stop)
+        printf("Transposed graph loaded in [s]: %0.3f\n",
+               (float)compute_timespec_diff(load_start, load_stop) / 1000000000.0f);
     }
 
-    if (m != n) {
-        printf("Matrix row and column size not equal. m: %d n: %d\n",
-               m, n);
-        return 1;
+    if (bfs_mode_needs_compressed(mode)) {
+        compressed_graph = load_compressed_graph(graph);
+        if (compressed_graph == NULL) {
+            return 1;
+        }
     }
 
-    printf("Wikipedia matrix size m: %d n: %d nz: %d\n", m, n, nz);
-
-    // Start reading in the data.
-    //
-    rows = (struct row**)malloc(sizeof(struct row*) * (m + 1));
-    if (rows == NULL) {
-        printf("Failed to allocate row array.\n");
-	return 1;
+    if (bfs_mode_needs_external(mode)) {
+        external_graph = load_external_graph(&load_options, order);
+        if (external_graph == NULL) {
+            return 1;
+        }
     }
 
-    printf("Allocated %ld bytes for row array.\n",
-           sizeof(struct row*) * m + 1);
+    if (bfs_mode_needs_dynamic(mode)) {
+        dynamic_graph = load_dynamic_graph(graph);
+        if (dynamic_graph == NULL) {
+            return 1;
+        }
+        if (edge_updates > 0 && !run_edge_updates(dynamic_graph, (size_t)edge_updates)) {
+            return 1;
+        }
+    }
 
-    // Zero out the row array.
-    // A NULL means that a particular node in the graph
-    // has no directed edges to other nodes.
-    //
-    for (int i = 0; i < m + 1; i++) {
-        rows[i] = NULL;
+    if (serve_path != NULL) {
+        bool status = run_query_server(serve_path, reply_fd, mode,
+                                       query_workers > 0 ? (size_t)query_workers : 1);
+        dynamic_graph_delete(dynamic_graph);
+        external_graph_close(external_graph);
+        compressed_graph_delete(compressed_graph);
+        graph_delete(reverse_graph);
+        graph_delete(graph);
+        bump_ptr_cleanup();
+        return status ? 0 : 1;
     }
 
-    // Parse.
+    // One set of queues and visited stamps serves every search.
     //
-    size_t line_count = 0;
-    while(!feof(fptr)) {
-	// Grab next directed edge.
-	// A pair (i, j) means that node i links to node j.
-	//
-	unsigned int i, j;
-        int retval = fscanf(fptr, "%d %d", &i, &j);
-	if (!(retval == 2 || retval == -1)) {
-            printf("File parsing error with fscanf() return value of: %d.\n", retval);
-	    return 1;
-	}
+    if (scaling_curve || multi_source || condensed || num_landmarks > 0 || query_workers > 0
+        || repetitions > 0) {
+        bool status;
+        if (repetitions > 0) {
+            status = run_benchmark(node_fptr, mode, order, (size_t)num_threads, (size_t)warmup_passes,
+                                   (size_t)repetitions, bench_path);
+        } else if (scaling_curve) {
+            status = run_scaling_curve(node_fptr, (size_t)num_threads);
+        } else if (multi_source) {
+            status = run_multi_source_queries(node_fptr);
+        } else if (condensed) {
+            status = run_condensed_queries(node_fptr, (size_t)num_threads, (size_t)grail_labels);
+        } else if (num_landmarks > 0) {
+            status = run_landmark_queries(node_fptr, &load_options, order, (size_t)num_landmarks);
+        } else {
+            status = run_concurrent_queries(node_fptr, mode, (size_t)query_workers);
+        }
+        print_external_io(external_graph);
+        dynamic_graph_delete(dynamic_graph);
+        external_graph_close(external_graph);
+        compressed_graph_delete(compressed_graph);
+        graph_delete(reverse_graph);
+        graph_delete(graph);
+        fclose(node_fptr);
+        bump_ptr_cleanup();
+        return status ? 0 : 1;
+    }
 
-	add_edge(i, j);
-	++line_count;
+    struct bfs_search * search = bfs_search_create(graph, reverse_graph, compressed_graph, external_graph,
+                                                   dynamic_graph, mode == BFS_PARALLEL ? (size_t)num_threads : 0);
+    if (search == NULL) {
+        printf("Failed to allocate search state.\n");
+	return 1;
     }
-    printf("Read %ld lines of matrix data.\n", line_count);
+    printf("Search mode: %s\n", bfs_mode_name(mode));
+    printf("Vertex ordering: %s\n", graph_order_name(order));
 
     // Start the BFS.
     //
-    for (size_t i = 0; i < 100; i++) {
+    for (size_t i = 0; i < NUM_QUERIES; i++) {
         unsigned int node_i = 0; 
         unsigned int node_j = 0;
         int retval = fscanf(node_fptr, "%d %d\n", &node_i, &node_j);	
@@ -358,28 +1552,23 @@ int main(void) {
 	    return 1;
 	}
         printf("(%ld / %ld) Searching for a connection between node %d -> %d\n", 
-               i + 1, 100L, node_i, node_j);
+               i + 1, (long)NUM_QUERIES, node_i, node_j);
 #ifdef COMPILE_ARM_PMU_CODE
 	reset_and_start_pmu_counters();
 #endif
-        bool success = breadth_first_search(node_i, node_j);
+        bool success = breadth_first_search(search, mode, node_i, node_j);
 #ifdef COMPILE_ARM_PMU_CODE
 	stop_pmu_counters();
 #endif
         if (success) {
             printf("Path found.\n");
+            if (search->path_length > 0) {
+                print_path(graph, search->path, search->path_length);
+            }
         } else {
             printf("No path found.\n");
         }
 
-	// Clear visited fields for next run.
-	//
-        for (int j = 0; j < m + 1; j++) {
-            if (rows[j]) {
-                rows[j]->visited = false;
-	    }
-	}
-
 	// Grab PMU data.
 	//
 #ifdef COMPILE_ARM_PMU_CODE
@@ -406,18 +1595,19 @@ int main(void) {
 
     printf("All work complete, exit.\n");
     printf("Performed searches in [s]: %0.3f\n", ((float)total_time.tv_sec + ((float)total_time.tv_nsec / 1000000000ULL)));
+    print_external_io(external_graph);
     fflush(stdout);
 
     // Free
     //
-    for (int i = 0; i < m + 1; i++) {
-        if (rows[i] == NULL) continue;
-	free(rows[i]->adjacent_nodes);
-	free(rows[i]);
-    }
-
-    free(rows);
-    fclose(fptr);
+    bfs_search_delete(search);
+    dynamic_graph_delete(dynamic_graph);
+    external_graph_close(external_graph);
+    compressed_graph_delete(compressed_graph);
+    graph_delete(reverse_graph);
+    graph_delete(graph);
+    fclose(node_fptr);
+    bump_ptr_cleanup();
 
     return 0;
 }
@@ -0,0 +1,323 @@
+// MIT License. Copyright (c) 2025 Kshitij Jain
+// See LICENSE file in the root of this repository.
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "scc.h"
+
+// Component of vertices still on the Tarjan stack.
+//
+#define SCC_UNASSIGNED UINT32_MAX
+
+// Internal utility function that finds the SCCs of a graph with an
+// iterative Tarjan pass. An explicit call stack holds each open
+// vertex and the next of its edges to follow.
+// \param scc   : Pointer to condensation, component is filled in.
+// \param graph : Graph to condense.
+// Returns TRUE on success, FALSE otherwise.
+//
+static bool _scc_tarjan(struct scc_graph * scc, struct graph * graph) {
+    size_t num_vertices = graph->num_vertices;
+
+    // order[v] is 1 + the discovery index of v, 0 while undiscovered.
+    //
+    uint32_t * order           = (uint32_t*)calloc(num_vertices + 1, sizeof(uint32_t));
+    uint32_t * low             = (uint32_t*)malloc((num_vertices + 1) * sizeof(uint32_t));
+    unsigned int * stack       = (unsigned int*)malloc((num_vertices + 1) * sizeof(unsigned int));
+    unsigned int * call_vertex = (unsigned int*)malloc((num_vertices + 1) * sizeof(unsigned int));
+    graph_offset_t * call_edge = (graph_offset_t*)malloc((num_vertices + 1) * sizeof(graph_offset_t));
+    bool status = order != NULL && low != NULL && stack != NULL
+        && call_vertex != NULL && call_edge != NULL;
+
+    uint32_t discovered   = 0;
+    size_t stack_size     = 0;
+    scc->num_components   = 0;
+    for (size_t v = 0; v < num_vertices; v++) {
+        scc->component[v] = SCC_UNASSIGNED;
+    }
+
+    for (size_t root = 0; status && root < num_vertices; root++) {
+        if (order[root] != 0) {
+            continue;
+        }
+
+        size_t depth = 0;
+        order[root] = low[root] = ++discovered;
+        stack[stack_size++] = (unsigned int)root;
+        call_vertex[depth]  = (unsigned int)root;
+        call_edge[depth++]  = graph->offsets[root];
+
+        while (depth > 0) {
+            unsigned int vertex = call_vertex[depth - 1];
+            graph_offset_t edge = call_edge[depth - 1];
+
+            if (edge < graph->offsets[vertex + 1]) {
+                unsigned int neighbor = graph->neighbors[edge];
+                call_edge[depth - 1]  = edge + 1;
+                if (order[neighbor] == 0) {
+                    order[neighbor] = low[neighbor] = ++discovered;
+                    stack[stack_size++] = neighbor;
+                    call_vertex[depth]  = neighbor;
+                    call_edge[depth++]  = graph->offsets[neighbor];
+                } else if (scc->component[neighbor] == SCC_UNASSIGNED && order[neighbor] < low[vertex]) {
+                    low[vertex] = order[neighbor];
+                }
+                continue;
+            }
+
+            // All edges followed. A vertex that reaches nothing older
+            // on the stack is the root of a component, which is
+            // everything above it.
+            //
+            --depth;
+            if (low[vertex] == order[vertex]) {
+                uint32_t id = (uint32_t)scc->num_components++;
+                unsigned int member;
+                do {
+                    member = stack[--stack_size];
+                    scc->component[member] = id;
+                } while (member != vertex);
+            }
+            if (depth > 0) {
+                unsigned int parent = call_vertex[depth - 1];
+                if (low[vertex] < low[parent]) {
+                    low[parent] = low[vertex];
+                }
+            }
+        }
+    }
+
+    free(order);
+    free(low);
+    free(stack);
+    free(call_vertex);
+    free(call_edge);
+    return status;
+}
+
+// Internal utility function that builds the condensation DAG and the
+// per-component sizes and cycle flags.
+// \param scc         : Pointer to condensation, components are known.
+// \param graph       : Graph that was condensed.
+// \param num_threads : Number of threads to build the DAG with.
+// Returns TRUE on success, FALSE otherwise.
+//
+static bool _scc_build_dag(struct scc_graph * scc, struct graph * graph, size_t num_threads) {
+    size_t num_components = scc->num_components;
+    scc->component_size = (uint32_t*)calloc(num_components + 1, sizeof(uint32_t));
+    scc->cyclic         = (uint8_t*)calloc(num_components + 1, sizeof(uint8_t));
+
+    // Group the vertices by component, then emit each component's
+    // out-edges once per target component. last_source[c] remembers
+    // the component that last emitted an edge to c.
+    //
+    graph_offset_t * starts    = (graph_offset_t*)calloc(num_components + 1, sizeof(graph_offset_t));
+    unsigned int * members     = (unsigned int*)malloc((graph->num_vertices + 1) * sizeof(unsigned int));
+    uint32_t * last_source     = (uint32_t*)malloc((num_components + 1) * sizeof(uint32_t));
+    unsigned int * sources     = (unsigned int*)malloc((graph->num_edges + 1) * sizeof(unsigned int));
+    unsigned int * targets     = (unsigned int*)malloc((graph->num_edges + 1) * sizeof(unsigned int));
+    bool status = scc->component_size != NULL && scc->cyclic != NULL && starts != NULL
+        && members != NULL && last_source != NULL && sources != NULL && targets != NULL;
+
+    size_t num_edges = 0;
+    if (status) {
+        for (size_t v = 0; v < graph->num_vertices; v++) {
+            ++scc->component_size[scc->component[v]];
+        }
+        for (size_t c = 0; c < num_components; c++) {
+            starts[c + 1] = starts[c] + scc->component_size[c];
+            last_source[c] = SCC_UNASSIGNED;
+            if (scc->component_size[c] > scc->component_size[scc->largest_component]) {
+                scc->largest_component = c;
+            }
+        }
+        for (size_t v = 0; v < graph->num_vertices; v++) {
+            members[starts[scc->component[v]]++] = (unsigned int)v;
+        }
+
+        graph_offset_t begin = 0;
+        for (size_t c = 0; c < num_components; c++) {
+            graph_offset_t end = begin + scc->component_size[c];
+            scc->cyclic[c] = scc->component_size[c] > 1;
+            for (graph_offset_t m = begin; m < end; m++) {
+                unsigned int vertex = members[m];
+                for (graph_offset_t edge = graph->offsets[vertex]; edge < graph->offsets[vertex + 1]; edge++) {
+                    uint32_t other = scc->component[graph->neighbors[edge]];
+                    if (other == c) {
+                        scc->cyclic[c] = 1;
+                    } else if (last_source[other] != c) {
+                        last_source[other]   = (uint32_t)c;
+                        sources[num_edges]   = (unsigned int)c;
+                        targets[num_edges++] = other;
+                    }
+                }
+            }
+            begin = end;
+        }
+
+        scc->dag = graph_create_from_edges(num_components, sources, targets, num_edges, num_threads);
+        status = scc->dag != NULL;
+    }
+
+    free(starts);
+    free(members);
+    free(last_source);
+    free(sources);
+    free(targets);
+    return status;
+}
+
+// Finds the SCCs of a graph and builds its condensation.
+// \param graph       : Graph to condense.
+// \param num_threads : Number of threads to build the DAG with.
+// Returns a new condensation on success, NULL on failure.
+//
+struct scc_graph * scc_graph_create(struct graph * graph, size_t num_threads) {
+    if (graph == NULL || graph->num_vertices >= SCC_UNASSIGNED) {
+        return NULL;
+    }
+
+    struct scc_graph * scc = (struct scc_graph*)calloc(1, sizeof(struct scc_graph));
+    if (scc == NULL) {
+        return NULL;
+    }
+    scc->num_vertices = graph->num_vertices;
+    scc->component    = (uint32_t*)malloc((graph->num_vertices + 1) * sizeof(uint32_t));
+    if (scc->component == NULL || !_scc_tarjan(scc, graph)
+        || !_scc_build_dag(scc, graph, num_threads)) {
+        scc_graph_delete(scc);
+        return NULL;
+    }
+    return scc;
+}
+
+// Deletes a condensation and frees all memory associated with it.
+// \param scc : Pointer to condensation to delete.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool scc_graph_delete(struct scc_graph * scc) {
+    if (scc == NULL) {
+        return false;
+    }
+
+    free(scc->component);
+    free(scc->component_size);
+    free(scc->cyclic);
+    graph_delete(scc->dag);
+    free(scc);
+    return true;
+}
+
+// Creates the state for answering queries on a condensation.
+// \param scc   : Condensation to query.
+// \param grail : Labels of scc->dag, or NULL to search without them.
+// Returns a new search on success, NULL on failure.
+//
+struct scc_search * scc_search_create(struct scc_graph * scc, struct grail_index * grail) {
+    if (scc == NULL || (grail != NULL && grail->dag != scc->dag)) {
+        return NULL;
+    }
+
+    struct scc_search * search = (struct scc_search*)calloc(1, sizeof(struct scc_search));
+    if (search == NULL) {
+        return NULL;
+    }
+    search->scc        = scc;
+    search->grail      = grail;
+    search->visited    = visited_set_create(scc->num_components);
+    search->level      = (uint32_t*)malloc((scc->num_components + 1) * sizeof(uint32_t));
+    search->next_level = (uint32_t*)malloc((scc->num_components + 1) * sizeof(uint32_t));
+    if (search->visited == NULL || search->level == NULL || search->next_level == NULL) {
+        scc_search_delete(search);
+        return NULL;
+    }
+    return search;
+}
+
+// Deletes a search and frees all memory associated with it. The
+// condensation and labels are owned by the caller and are not freed.
+// \param search : Pointer to search to delete.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool scc_search_delete(struct scc_search * search) {
+    if (search == NULL) {
+        return false;
+    }
+
+    visited_set_delete(search->visited);
+    free(search->level);
+    free(search->next_level);
+    free(search);
+    return true;
+}
+
+// Checks whether there is a path of at least one edge.
+// \param search : Pointer to search state.
+// \param source : Vertex to start from.
+// \param target : Vertex to look for.
+// Returns TRUE if a path exists, FALSE if not or on error.
+//
+bool scc_search_reachable(struct scc_search * search, unsigned int source, unsigned int target) {
+    if (search == NULL) {
+        return false;
+    }
+
+    struct scc_graph * scc     = search->scc;
+    struct grail_index * grail = search->grail;
+    search->searched_dag       = false;
+    search->rejected_by_labels = false;
+    search->components_visited = 0;
+    search->edges_examined     = 0;
+    if (source >= scc->num_vertices || target >= scc->num_vertices) {
+        return false;
+    }
+
+    // Within a component every vertex reaches every other one, and
+    // itself if the component has a cycle. Edges only lead to lower
+    // component IDs.
+    //
+    uint32_t from = scc->component[source];
+    uint32_t to   = scc->component[target];
+    if (from == to) {
+        return source != target || scc->cyclic[from];
+    }
+    if (from < to) {
+        return false;
+    }
+    if (grail != NULL && !grail_index_may_reach(grail, from, to)) {
+        search->rejected_by_labels = true;
+        return false;
+    }
+
+    search->searched_dag = true;
+    const struct graph * dag = scc->dag;
+    visited_set_clear(search->visited);
+    visited_set_insert(search->visited, from);
+    search->level[0]  = from;
+    size_t level_size = 1;
+    while (level_size > 0) {
+        size_t next_size = 0;
+        for (size_t i = 0; i < level_size; i++) {
+            uint32_t component = search->level[i];
+            ++search->components_visited;
+            search->edges_examined += dag->offsets[component + 1] - dag->offsets[component];
+            for (graph_offset_t edge = dag->offsets[component]; edge < dag->offsets[component + 1]; edge++) {
+                uint32_t next = dag->neighbors[edge];
+                if (next == to) {
+                    return true;
+                }
+                if (next > to && (grail == NULL || grail_index_may_reach(grail, next, to))
+                    && visited_set_insert(search->visited, next)) {
+                    search->next_level[next_size++] = next;
+                }
+            }
+        }
+
+        uint32_t * swap    = search->level;
+        search->level      = search->next_level;
+        search->next_level = swap;
+        level_size         = next_size;
+    }
+    return false;
+}
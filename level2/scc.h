@@ -0,0 +1,97 @@
+// MIT License. Copyright (c) 2025 Kshitij Jain
+// See LICENSE file in the root of this repository.
+
+#ifndef _SCC_H
+#define _SCC_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "graph.h"
+#include "grail.h"
+#include "visited.h"
+
+// Strongly connected components (SCCs) and the condensation DAG.
+//
+// Components are found with an iterative Tarjan pass, so deep graphs
+// cannot overflow the call stack. Tarjan completes a component only
+// after every component it reaches, so component IDs are a reverse
+// topological order: every DAG edge goes from a higher ID to a lower
+// one. A query then needs
+//     - an array lookup when both vertices share a component,
+//     - a comparison when the source's component has the lower ID,
+//     - a search of the DAG otherwise, which skips every component
+//       with an ID below the target's.
+// With GRAIL labels of the DAG, most pairs without a path are rejected
+// by the labels before the search, and the search also skips every
+// component whose labels rule out the target.
+// Link graphs like Wikipedia have one giant component, so most
+// queries end at the lookup.
+
+struct scc_graph {
+    size_t num_vertices;
+    size_t num_components;
+    uint32_t * component;           // num_vertices component IDs.
+    uint32_t * component_size;      // num_components vertex counts.
+    uint8_t * cyclic;               // num_components flags, set if the
+                                    // component has a cycle, so that a
+                                    // vertex can reach itself.
+    struct graph * dag;             // num_components vertices, no
+                                    // duplicate edges or self-loops.
+    size_t largest_component;       // ID of the largest component.
+};
+
+// Per-thread state of queries on the condensation.
+//
+struct scc_search {
+    struct scc_graph * scc;
+    struct grail_index * grail;     // Labels of scc->dag, or NULL.
+    struct visited_set * visited;
+    uint32_t * level;               // num_components entries each.
+    uint32_t * next_level;
+
+    // Statistics of the last query.
+    //
+    bool searched_dag;              // FALSE if a lookup answered it.
+    bool rejected_by_labels;        // TRUE if the labels answered it.
+    size_t components_visited;
+    size_t edges_examined;
+};
+
+// Finds the SCCs of a graph and builds its condensation.
+// \param graph       : Graph to condense.
+// \param num_threads : Number of threads to build the DAG with.
+// Returns a new condensation on success, NULL on failure.
+//
+struct scc_graph * scc_graph_create(struct graph * graph, size_t num_threads);
+
+// Deletes a condensation and frees all memory associated with it.
+// \param scc : Pointer to condensation to delete.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool scc_graph_delete(struct scc_graph * scc);
+
+// Creates the state for answering queries on a condensation.
+// \param scc   : Condensation to query.
+// \param grail : Labels of scc->dag, or NULL to search without them.
+// Returns a new search on success, NULL on failure.
+//
+struct scc_search * scc_search_create(struct scc_graph * scc, struct grail_index * grail);
+
+// Deletes a search and frees all memory associated with it. The
+// condensation and labels are owned by the caller and are not freed.
+// \param search : Pointer to search to delete.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool scc_search_delete(struct scc_search * search);
+
+// Checks whether there is a path of at least one edge.
+// \param search : Pointer to search state.
+// \param source : Vertex to start from.
+// \param target : Vertex to look for.
+// Returns TRUE if a path exists, FALSE if not or on error.
+//
+bool scc_search_reachable(struct scc_search * search, unsigned int source, unsigned int target);
+
+#endif
@@ -0,0 +1,61 @@
+// MIT License. Copyright (c) 2025 Kshitij Jain
+// See LICENSE file in the root of this repository.
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "visited.h"
+
+// Creates a visited set with no vertex visited.
+// \param num_vertices : Vertex IDs must be less than this.
+// Returns a new visited set on success, NULL on failure.
+//
+struct visited_set * visited_set_create(size_t num_vertices) {
+    struct visited_set * visited = (struct visited_set*)malloc(sizeof(struct visited_set));
+    if (visited == NULL) {
+        return NULL;
+    }
+
+    visited->stamps = (uint32_t*)calloc(num_vertices + 1, sizeof(uint32_t));
+    if (visited->stamps == NULL) {
+        free(visited);
+        return NULL;
+    }
+    visited->num_vertices = num_vertices;
+    visited->epoch        = 1;
+    return visited;
+}
+
+// Deletes a visited set and frees all memory associated with it.
+// \param visited : Pointer to visited set to delete.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool visited_set_delete(struct visited_set * visited) {
+    if (visited == NULL) {
+        return false;
+    }
+
+    free(visited->stamps);
+    free(visited);
+    return true;
+}
+
+// Marks every vertex unvisited.
+// \param visited : Pointer to visited set.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool visited_set_clear(struct visited_set * visited) {
+    if (visited == NULL) {
+        return false;
+    }
+
+    ++visited->epoch;
+    if (visited->epoch == 0) {
+        // Wrapped around. Stamps from 4 billion searches ago would
+        // read as current, so wipe them and start over.
+        //
+        memset(visited->stamps, 0, visited->num_vertices * sizeof(uint32_t));
+        visited->epoch = 1;
+    }
+    return true;
+}
@@ -0,0 +1,84 @@
+// MIT License. Copyright (c) 2025 Kshitij Jain
+// See LICENSE file in the root of this repository.
+
+#ifndef _VISITED_H
+#define _VISITED_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Per-search visited flags that are cleared in O(1).
+//
+// Each vertex holds the epoch in which it was last visited. A vertex
+// counts as visited only if its stamp equals the current epoch, so
+// starting a new search just increments the epoch. The stamps are only
+// rewritten when the 32-bit epoch wraps around, once every 4 billion
+// searches.
+//
+struct visited_set {
+    uint32_t* stamps;       // num_vertices entries.
+    size_t num_vertices;
+    uint32_t epoch;         // Never 0, so fresh stamps read as unvisited.
+};
+
+// Creates a visited set with no vertex visited.
+// \param num_vertices : Vertex IDs must be less than this.
+// Returns a new visited set on success, NULL on failure.
+//
+struct visited_set * visited_set_create(size_t num_vertices);
+
+// Deletes a visited set and frees all memory associated with it.
+// \param visited : Pointer to visited set to delete.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool visited_set_delete(struct visited_set * visited);
+
+// Marks every vertex unvisited.
+// \param visited : Pointer to visited set.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool visited_set_clear(struct visited_set * visited);
+
+// Checks whether a vertex has been visited since the last clear.
+// These two are on the search's inner loop, so they are inline and do
+// not check their arguments.
+// \param visited : Pointer to visited set.
+// \param vertex  : Vertex to check, less than num_vertices.
+// Returns TRUE if the vertex is visited, FALSE otherwise.
+//
+static inline bool visited_set_contains(const struct visited_set * visited, unsigned int vertex) {
+    return visited->stamps[vertex] == visited->epoch;
+}
+
+// Marks a vertex visited.
+// \param visited : Pointer to visited set.
+// \param vertex  : Vertex to mark, less than num_vertices.
+// Returns TRUE if the vertex was not visited before, FALSE otherwise.
+//
+static inline bool visited_set_insert(struct visited_set * visited, unsigned int vertex) {
+    if (visited->stamps[vertex] == visited->epoch) {
+        return false;
+    }
+    visited->stamps[vertex] = visited->epoch;
+    return true;
+}
+
+// Marks a vertex visited. Safe to call from several threads at once,
+// exactly one of the callers that race on a vertex gets TRUE.
+// \param visited : Pointer to visited set.
+// \param vertex  : Vertex to mark, less than num_vertices.
+// Returns TRUE if the vertex was not visited before, FALSE otherwise.
+//
+static inline bool visited_set_insert_atomic(struct visited_set * visited, unsigned int vertex) {
+    // Read first, most vertices seen on a busy level are visited
+    // already and a plain load keeps their cache line shared.
+    //
+    if (__atomic_load_n(&visited->stamps[vertex], __ATOMIC_RELAXED) == visited->epoch) {
+        return false;
+    }
+    return __atomic_exchange_n(&visited->stamps[vertex], visited->epoch, __ATOMIC_RELAXED)
+        != visited->epoch;
+}
+
+#endif